@@ -0,0 +1,176 @@
+#--------------------------------------------------------------------#
+# gpvulc                                                             #
+# GPV's Utility Library Collection                                   #
+#  by Giovanni Paolo Vigano', 2015-2021                              #
+#--------------------------------------------------------------------#
+#
+# Distributed under the MIT Software License.
+# See http://opensource.org/licenses/MIT
+#
+# Optimization and instrumentation options, applied to all the targets:
+#
+#  GPVULC_ENABLE_LTO   link time optimization (if supported by the compiler)
+#  GPVULC_MARCH        target architecture passed to -march (e.g. native, x86-64-v3, skylake),
+#                      with MSVC it is passed to /arch (e.g. AVX2)
+#  GPVULC_SANITIZER    sanitizers list: address, thread, undefined (e.g. "address;undefined"),
+#                      thread cannot be combined with address
+#  GPVULC_PGO          profile-guided optimization step: OFF, GENERATE or USE
+#  GPVULC_PGO_DIR      folder for the profile data
+#
+# Profile-guided optimization (GCC and Clang), the benchmarks are used as training runs:
+#   cmake -S . -B build -DGPVULC_PGO=GENERATE
+#   cmake --build build --target gpvulc_pgo_train
+#   cmake -S . -B build -DGPVULC_PGO=USE
+#   cmake --build build
+
+option(GPVULC_ENABLE_LTO "Enable link time optimization" OFF)
+set(GPVULC_MARCH "" CACHE STRING "Target architecture (-march), empty for the compiler default")
+set(GPVULC_SANITIZER "" CACHE STRING "Sanitizers to enable: address, thread, undefined (semicolon separated)")
+set(GPVULC_PGO "OFF" CACHE STRING "Profile-guided optimization step: OFF, GENERATE, USE")
+set_property(CACHE GPVULC_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(GPVULC_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Folder for profile-guided optimization data")
+
+set(GPVULC_GNU_LIKE OFF)
+if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+  set(GPVULC_GNU_LIKE ON)
+endif()
+
+
+# Link time optimization
+
+if(GPVULC_ENABLE_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT GPVULC_LTO_SUPPORTED OUTPUT GPVULC_LTO_ERROR LANGUAGES CXX)
+  if(GPVULC_LTO_SUPPORTED)
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+  else()
+    message(WARNING "Link time optimization not supported: ${GPVULC_LTO_ERROR}")
+  endif()
+endif()
+
+
+# Target architecture
+
+if(GPVULC_MARCH)
+  if(MSVC)
+    add_compile_options("/arch:${GPVULC_MARCH}")
+  else()
+    add_compile_options("-march=${GPVULC_MARCH}")
+  endif()
+endif()
+
+
+# Sanitizers
+
+if(GPVULC_SANITIZER)
+  string(REPLACE "," ";" GPVULC_SANITIZER_LIST "${GPVULC_SANITIZER}")
+  foreach(sanitizer IN LISTS GPVULC_SANITIZER_LIST)
+    if(NOT sanitizer MATCHES "^(address|thread|undefined)$")
+      message(FATAL_ERROR "Unknown sanitizer '${sanitizer}' in GPVULC_SANITIZER (use address, thread, undefined)")
+    endif()
+  endforeach()
+  if("address" IN_LIST GPVULC_SANITIZER_LIST AND "thread" IN_LIST GPVULC_SANITIZER_LIST)
+    message(FATAL_ERROR "The address and thread sanitizers cannot be used together")
+  endif()
+
+  if(MSVC)
+    if(NOT GPVULC_SANITIZER_LIST STREQUAL "address")
+      message(FATAL_ERROR "Only the address sanitizer is supported by MSVC")
+    endif()
+    add_compile_options(/fsanitize=address)
+  elseif(GPVULC_GNU_LIKE)
+    string(REPLACE ";" "," GPVULC_SANITIZER_FLAGS "${GPVULC_SANITIZER_LIST}")
+    add_compile_options("-fsanitize=${GPVULC_SANITIZER_FLAGS}" -fno-omit-frame-pointer -g)
+    if("undefined" IN_LIST GPVULC_SANITIZER_LIST)
+      # stop at the first error, so that tests fail
+      add_compile_options(-fno-sanitize-recover=undefined)
+    endif()
+    link_libraries("-fsanitize=${GPVULC_SANITIZER_FLAGS}")
+  else()
+    message(FATAL_ERROR "Sanitizers are not supported by ${CMAKE_CXX_COMPILER_ID}")
+  endif()
+endif()
+
+
+# Profile-guided optimization
+
+string(TOUPPER "${GPVULC_PGO}" GPVULC_PGO)
+if(NOT GPVULC_PGO MATCHES "^(OFF|GENERATE|USE)$")
+  message(FATAL_ERROR "GPVULC_PGO must be OFF, GENERATE or USE")
+endif()
+
+set(GPVULC_PGO_PROFILE "${GPVULC_PGO_DIR}")
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  # Clang writes raw profiles, merged by the training target
+  set(GPVULC_PGO_PROFILE "${GPVULC_PGO_DIR}/gpvulc.profdata")
+endif()
+
+if(NOT GPVULC_PGO STREQUAL "OFF")
+  if(NOT GPVULC_GNU_LIKE)
+    message(FATAL_ERROR "Profile-guided optimization is supported only with GCC and Clang")
+  endif()
+  if(GPVULC_SANITIZER)
+    message(FATAL_ERROR "Profile-guided optimization cannot be combined with sanitizers")
+  endif()
+endif()
+
+if(GPVULC_PGO STREQUAL "GENERATE")
+  file(MAKE_DIRECTORY "${GPVULC_PGO_DIR}")
+  add_compile_options("-fprofile-generate=${GPVULC_PGO_DIR}")
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # benchmarks run some conversions in parallel
+    add_compile_options(-fprofile-update=atomic)
+  endif()
+  link_libraries("-fprofile-generate=${GPVULC_PGO_DIR}")
+elseif(GPVULC_PGO STREQUAL "USE")
+  file(GLOB_RECURSE GPVULC_PGO_FILES "${GPVULC_PGO_DIR}/*.gcda" "${GPVULC_PGO_DIR}/*.profdata")
+  if(NOT GPVULC_PGO_FILES OR NOT EXISTS "${GPVULC_PGO_PROFILE}")
+    message(FATAL_ERROR "Profile data not found in ${GPVULC_PGO_PROFILE}: "
+      "build the gpvulc_pgo_train target with GPVULC_PGO=GENERATE first")
+  endif()
+  add_compile_options("-fprofile-use=${GPVULC_PGO_PROFILE}")
+  if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # counters of multi-threaded code can be inconsistent, functions not run in training have no profile
+    add_compile_options(-fprofile-correction -Wno-missing-profile)
+  else()
+    add_compile_options(-Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+  endif()
+  link_libraries("-fprofile-use=${GPVULC_PGO_PROFILE}")
+endif()
+
+
+# Define the gpvulc_pgo_train target, running the benchmarks to collect the profile data
+# (called at the end of the main CMakeLists.txt, when the benchmark target is defined).
+function(gpvulc_add_pgo_training)
+  if(NOT GPVULC_PGO STREQUAL "GENERATE")
+    return()
+  endif()
+  if(NOT TARGET gpvulc_benchmark)
+    message(WARNING "gpvulc_benchmark is not built: no training target for profile-guided optimization")
+    return()
+  endif()
+
+  set(merge_command "")
+  if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    get_filename_component(compiler_dir "${CMAKE_CXX_COMPILER}" DIRECTORY)
+    find_program(GPVULC_LLVM_PROFDATA NAMES llvm-profdata HINTS "${compiler_dir}")
+    if(NOT GPVULC_LLVM_PROFDATA)
+      message(FATAL_ERROR "llvm-profdata not found, it is required for profile-guided optimization with Clang")
+    endif()
+    set(merge_command COMMAND "${CMAKE_COMMAND}"
+      -DPROFDATA=${GPVULC_LLVM_PROFDATA}
+      -DPGO_DIR=${GPVULC_PGO_DIR}
+      -DOUTPUT=${GPVULC_PGO_PROFILE}
+      -P "${PROJECT_SOURCE_DIR}/cmake/GpvulcMergeProfiles.cmake")
+  endif()
+
+  add_custom_target(gpvulc_pgo_train
+    COMMAND "${CMAKE_COMMAND}" -E remove_directory "${GPVULC_PGO_DIR}"
+    COMMAND "${CMAKE_COMMAND}" -E make_directory "${GPVULC_PGO_DIR}"
+    COMMAND $<TARGET_FILE:gpvulc_benchmark> --benchmark_min_time=0.05
+    ${merge_command}
+    DEPENDS gpvulc_benchmark
+    WORKING_DIRECTORY "${CMAKE_BINARY_DIR}"
+    COMMENT "Running benchmarks to collect profile data in ${GPVULC_PGO_DIR}"
+    VERBATIM)
+endfunction()
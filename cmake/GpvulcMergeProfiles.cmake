@@ -0,0 +1,23 @@
+#--------------------------------------------------------------------#
+# gpvulc                                                             #
+# GPV's Utility Library Collection                                   #
+#  by Giovanni Paolo Vigano', 2015-2021                              #
+#--------------------------------------------------------------------#
+#
+# Distributed under the MIT Software License.
+# See http://opensource.org/licenses/MIT
+#
+# Merge the raw profiles written by Clang instrumented programs (see GpvulcBuildOptions.cmake).
+# Usage: cmake -DPROFDATA=<llvm-profdata> -DPGO_DIR=<folder> -DOUTPUT=<file.profdata> -P GpvulcMergeProfiles.cmake
+
+file(GLOB raw_profiles "${PGO_DIR}/*.profraw")
+if(NOT raw_profiles)
+  message(FATAL_ERROR "No raw profile found in ${PGO_DIR}")
+endif()
+
+execute_process(
+  COMMAND "${PROFDATA}" merge "-output=${OUTPUT}" ${raw_profiles}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "llvm-profdata failed (${result})")
+endif()
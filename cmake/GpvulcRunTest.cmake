@@ -0,0 +1,25 @@
+#--------------------------------------------------------------------#
+# gpvulc                                                             #
+# GPV's Utility Library Collection                                   #
+#  by Giovanni Paolo Vigano', 2015-2021                              #
+#--------------------------------------------------------------------#
+#
+# Distributed under the MIT Software License.
+# See http://opensource.org/licenses/MIT
+#
+# Run a test program with an empty input, so that the final ConsolePause() does not wait for ENTER.
+# Usage: cmake -DTEST_PROGRAM=<program> -P GpvulcRunTest.cmake
+
+if(WIN32)
+  set(null_device NUL)
+else()
+  set(null_device /dev/null)
+endif()
+
+execute_process(
+  COMMAND "${TEST_PROGRAM}"
+  INPUT_FILE ${null_device}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${TEST_PROGRAM} failed (${result})")
+endif()
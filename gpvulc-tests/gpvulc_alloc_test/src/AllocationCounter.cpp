@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Replacement of the global new/delete operators, counting the allocations of each thread
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+	// Counters of the current thread (trivial type: no initialization is needed inside operator new)
+	thread_local AllocationStats threadStats;
+
+
+	void* CountedAlloc(std::size_t size)
+	{
+		threadStats.Allocations++;
+		threadStats.Bytes += size;
+		return std::malloc(size ? size : 1);
+	}
+
+
+	void CountedFree(void* ptr)
+	{
+		if (ptr)
+		{
+			threadStats.Deallocations++;
+			std::free(ptr);
+		}
+	}
+}
+
+
+AllocationStats AllocationCounter::GetStats() const
+{
+	AllocationStats stats = GetThreadStats();
+	stats.Allocations -= Start.Allocations;
+	stats.Deallocations -= Start.Deallocations;
+	stats.Bytes -= Start.Bytes;
+	return stats;
+}
+
+
+AllocationStats AllocationCounter::GetThreadStats()
+{
+	return threadStats;
+}
+
+
+void* operator new(std::size_t size)
+{
+	void* ptr = CountedAlloc(size);
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+	CountedFree(ptr);
+}
+
+
+void operator delete[](void* ptr) noexcept
+{
+	CountedFree(ptr);
+}
+
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	CountedFree(ptr);
+}
+
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	CountedFree(ptr);
+}
+
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	CountedFree(ptr);
+}
+
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	CountedFree(ptr);
+}
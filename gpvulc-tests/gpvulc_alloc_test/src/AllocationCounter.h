@@ -0,0 +1,98 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Heap allocations counter, based on the replacement of the global new/delete operators
+// (see AllocationCounter.cpp, that must be linked only to test programs).
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+
+//! Number of heap allocations and allocated bytes.
+struct AllocationStats
+{
+	size_t Allocations = 0;
+	size_t Deallocations = 0;
+	size_t Bytes = 0;
+};
+
+
+/*!
+Count the heap allocations made by the current thread since the counter was created
+(allocations made by other threads are not counted).
+*/
+class AllocationCounter
+{
+public:
+
+	//! Start counting
+	AllocationCounter() { Restart(); }
+
+	//! Start counting again from zero
+	void Restart() { Start = GetThreadStats(); }
+
+	//! Get the allocations since the counter was started
+	AllocationStats GetStats() const;
+
+	//! Get the number of allocations since the counter was started
+	size_t GetAllocations() const { return GetStats().Allocations; }
+
+	//! Get the number of allocated bytes since the counter was started
+	size_t GetBytes() const { return GetStats().Bytes; }
+
+	//! Get the allocations made so far by the current thread
+	static AllocationStats GetThreadStats();
+
+private:
+
+	AllocationStats Start;
+};
+
+
+/*!
+Allocation budgets are checked only if the standard library does not allocate memory for debugging
+(e.g. Visual C++ debug builds allocate a proxy for each container).
+*/
+#if defined(_ITERATOR_DEBUG_LEVEL) && _ITERATOR_DEBUG_LEVEL > 0
+const bool ALLOCATION_BUDGETS_ENABLED = false;
+#else
+const bool ALLOCATION_BUDGETS_ENABLED = true;
+#endif
+
+
+//! Check that the allocations per operation do not exceed the given budget (see ALLOCATION_BUDGETS_ENABLED).
+#define EXPECT_ALLOCATIONS_LE(stats, budget) \
+	EXPECT_TRUE(!ALLOCATION_BUDGETS_ENABLED || (stats).Allocations <= (size_t)(budget)) \
+		<< (stats).Allocations << " allocations per operation, budget: " << (budget)
+
+
+/*!
+Run an operation the given number of times, printing and returning the allocations per operation
+(rounded up, so that a single allocation in many operations is not hidden).
+*/
+template <typename Operation>
+AllocationStats CountAllocations(const std::string& name, int repetitions, Operation operation)
+{
+	AllocationCounter counter;
+	for (int i = 0; i < repetitions; i++)
+	{
+		operation();
+	}
+	AllocationStats stats = counter.GetStats();
+	stats.Allocations = (stats.Allocations + repetitions - 1) / repetitions;
+	stats.Deallocations = (stats.Deallocations + repetitions - 1) / repetitions;
+	stats.Bytes = (stats.Bytes + repetitions - 1) / repetitions;
+	std::cout << "[ ALLOCS   ] " << name << ": " << stats.Allocations << " allocations, "
+		<< stats.Bytes << " bytes per operation" << std::endl;
+	return stats;
+}
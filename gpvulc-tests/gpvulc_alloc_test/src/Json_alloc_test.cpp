@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// RapidJsonParser allocation budgets
+
+#include "AllocationCounter.h"
+
+#include <gpvulc/json/RapidJsonParser.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+namespace
+{
+	std::string MakeItems(int count)
+	{
+		std::string text = "{ \"items\": [";
+		for (int i = 0; i < count; i++)
+		{
+			text += (i > 0 ? ", " : " ");
+			text += "{ \"name\": \"a_long_item_name_" + std::to_string(i) + "\", \"size\": " + std::to_string(i) + " }";
+		}
+		text += " ] }";
+		return text;
+	}
+
+
+	int ReadItems(RapidJsonParser& parser)
+	{
+		const rapidjson::Value& items = parser.GetRootElement("items");
+		int sizeSum = 0;
+		for (auto item = items.Begin(); item != items.End(); ++item)
+		{
+			parser.GetAsString(*item, "name");
+			sizeSum += parser.GetAsInt(*item, "size");
+		}
+		return sizeSum;
+	}
+}
+
+
+// the memory retained by the parser is reused for similar documents
+TEST(JsonAllocTest, ParseSimilarDocuments)
+{
+	const std::string jsonText = MakeItems(200);
+	RapidJsonParser parser;
+	// the first documents size the retained memory
+	for (int i = 0; i < 2; i++)
+	{
+		parser.Parse(jsonText);
+		ReadItems(parser);
+	}
+
+	AllocationStats stats = CountAllocations("RapidJsonParser::Parse", 10, [&]()
+	{
+		parser.Parse(jsonText);
+		EXPECT_EQ(ReadItems(parser), 199 * 200 / 2);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+	EXPECT_FALSE(parser.ErrorsOccurred());
+}
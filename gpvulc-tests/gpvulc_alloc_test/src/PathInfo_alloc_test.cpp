@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// PathInfo allocation budgets
+
+#include "AllocationCounter.h"
+
+#include <gpvulc/path/PathInfo.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	// path with parts longer than the small string buffer of std::string
+	const char* const LONG_PATH = "/data/models/some_long_directory/scene_file_name.obj";
+}
+
+
+// at most one allocation for each stored part of the path, plus the copy returned by GetFullPath()
+TEST(PathInfoAllocTest, Construction)
+{
+	const std::string pathName = LONG_PATH;
+
+	AllocationStats stats = CountAllocations("PathInfo(const std::string&)", 100, [&]()
+	{
+		PathInfo path(pathName);
+		EXPECT_EQ(path.GetFullPath(), pathName);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 8);
+
+	// short paths fit in the small string buffers
+	const std::string shortPathName = "/a/b.c";
+	stats = CountAllocations("PathInfo(const std::string&), short path", 100, [&]()
+	{
+		PathInfo path(shortPathName);
+		EXPECT_EQ(path.GetFullPath(), shortPathName);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
+
+
+TEST(PathInfoAllocTest, Copy)
+{
+	const PathInfo original(LONG_PATH);
+
+	AllocationStats stats = CountAllocations("PathInfo(const PathInfo&)", 100, [&]()
+	{
+		PathInfo path(original);
+		EXPECT_EQ(path.GetName(), original.GetName());
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 5);
+}
+
+
+TEST(PathInfoAllocTest, SetFullPath)
+{
+	const std::string pathName = LONG_PATH;
+	PathInfo path;
+
+	AllocationStats stats = CountAllocations("PathInfo::SetFullPath", 100, [&]()
+	{
+		path.SetFullPath(pathName);
+		EXPECT_EQ(path.GetFullPath(), pathName);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 8);
+}
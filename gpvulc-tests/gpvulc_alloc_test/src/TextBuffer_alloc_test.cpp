@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// TextBuffer allocation budgets
+
+#include "AllocationCounter.h"
+
+#include <gpvulc/text/TextBuffer.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	std::string MakeText(int numLines)
+	{
+		std::string text;
+		for (int i = 0; i < numLines; i++)
+		{
+			text += "some_long_identifier_" + std::to_string(i) + " = another_long_value_name ;\n";
+		}
+		return text;
+	}
+}
+
+
+TEST(TextBufferAllocTest, Find)
+{
+	const TextBuffer text(MakeText(100));
+	const std::string word = "another_long_value_name";
+	const std::string missing = "missing_long_identifier";
+
+	AllocationStats stats = CountAllocations("TextBuffer::FindSubString", 100, [&]()
+	{
+		EXPECT_GT(text.FindSubString(word), 0);
+		EXPECT_LT(text.FindSubString(missing), 0);
+		EXPECT_GT(text.FindChar('\n', 100), 0);
+		EXPECT_EQ(text.CountLines(), 100);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
+
+
+// case-insensitive searches and comparisons do not copy the text
+TEST(TextBufferAllocTest, FindCaseInsensitive)
+{
+	const TextBuffer text(MakeText(100));
+	const std::string word = "ANOTHER_Long_Value_Name";
+	const std::string prefix = "SOME_LONG_IDENTIFIER_0";
+
+	AllocationStats stats = CountAllocations("TextBuffer::FindSubString(caseInsensitive)", 100, [&]()
+	{
+		EXPECT_GT(text.FindSubString(word, true), 0);
+		EXPECT_GT(text.FindRevSubString(word, true), 0);
+		EXPECT_TRUE(text.Contains(word, true));
+		EXPECT_TRUE(text.StartsWith(prefix, true));
+		EXPECT_GT(text.FindChar('N', 0, true), 0);
+		EXPECT_NE(text.Compare(prefix, true), 0);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
+
+
+// a substring is copied into a string without allocations, if its capacity is enough
+TEST(TextBufferAllocTest, GetSubString)
+{
+	const TextBuffer text(MakeText(100));
+	std::string result;
+	result.reserve(100);
+
+	AllocationStats stats = CountAllocations("TextBuffer::GetSubString", 100, [&]()
+	{
+		text.GetSubString(10, 60, result);
+		EXPECT_EQ(result.size(), 51u);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
+
+
+// the new text is built once
+TEST(TextBufferAllocTest, ReplaceAll)
+{
+	const std::string source = MakeText(100);
+
+	AllocationStats stats = CountAllocations("TextBuffer::ReplaceAll", 10, [&]()
+	{
+		TextBuffer text(source);
+		EXPECT_EQ(text.ReplaceAll("another", "other"), 100);
+	});
+	// source copy and replaced text
+	EXPECT_ALLOCATIONS_LE(stats, 2);
+}
+
+
+// one allocation for each (long) substring, plus the growth of the array
+TEST(TextBufferAllocTest, Split)
+{
+	const int numLines = 100;
+	const TextBuffer text(MakeText(numLines));
+
+	AllocationStats stats = CountAllocations("TextBuffer::Split", 10, [&]()
+	{
+		EXPECT_EQ(text.Split('\n').size(), (size_t)numLines + 1);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, numLines + 10);
+
+	stats = CountAllocations("TextBuffer::SplitStr", 10, [&]()
+	{
+		EXPECT_EQ(text.SplitStr(";\n").size(), (size_t)numLines);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, numLines + 10);
+}
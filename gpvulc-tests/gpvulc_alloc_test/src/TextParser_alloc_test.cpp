@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// TextParser allocation budgets
+
+#include "AllocationCounter.h"
+
+#include <gpvulc/text/TextParser.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	// Build a text with tokens longer than the small string buffer of std::string
+	std::string MakeText(int numLines)
+	{
+		std::string text;
+		for (int i = 0; i < numLines; i++)
+		{
+			text += "some_long_identifier_" + std::to_string(i) + " = another_long_value_name ;\n";
+		}
+		return text;
+	}
+}
+
+
+// once the result is large enough tokens are extracted without allocations
+TEST(TextParserAllocTest, GetToken)
+{
+	TextParser parser(MakeText(100));
+	const std::string separators = " \t\r\n=;";
+	while (parser.GetToken())
+	{
+	}
+
+	AllocationStats stats = CountAllocations("TextParser::GetToken", 1, [&]()
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetToken())
+		{
+			count++;
+		}
+		parser.ResetParsing();
+		while (parser.GetToken(separators))
+		{
+			count++;
+		}
+		EXPECT_EQ(count, 600);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
+
+
+TEST(TextParserAllocTest, GetLine)
+{
+	TextParser parser(MakeText(100));
+	while (parser.GetLine())
+	{
+	}
+
+	AllocationStats stats = CountAllocations("TextParser::GetLine", 1, [&]()
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetLine())
+		{
+			count++;
+		}
+		EXPECT_EQ(count, 100);
+	});
+	EXPECT_ALLOCATIONS_LE(stats, 0);
+}
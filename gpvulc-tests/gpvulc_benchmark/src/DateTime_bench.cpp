@@ -0,0 +1,124 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// DateTime benchmarks
+
+#include <gpvulc/time/DateTimeUtil.h>
+#include <gpvulc/time/DateTimeBatch.h>
+
+using namespace gpvulc;
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+
+namespace
+{
+	// Build date/times spread over some years, one every few hours
+	std::vector<DateTime> MakeDateTimes(size_t count)
+	{
+		std::vector<DateTime> dateTimes(count);
+		const long long startMs = 1420070400000LL; // 2015-01-01
+		for (size_t i = 0; i < count; i++)
+		{
+			dateTimes[i] = EpochMsToDateTime(startMs + (long long)i * 12345678LL + (long long)(i % 1000), 60);
+		}
+		return dateTimes;
+	}
+}
+
+
+static void BM_DateTime_Format(benchmark::State& state)
+{
+	const std::vector<DateTime> dateTimes = MakeDateTimes(1024);
+	char buffer[DATETIME_STRING_MAX];
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(DateTimeFormat(dateTimes[i], buffer, sizeof(buffer)));
+		i = (i + 1) % dateTimes.size();
+	}
+}
+BENCHMARK(BM_DateTime_Format);
+
+
+static void BM_DateTime_ToString(benchmark::State& state)
+{
+	const std::vector<DateTime> dateTimes = MakeDateTimes(1024);
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(DateTimeToString(dateTimes[i]).size());
+		i = (i + 1) % dateTimes.size();
+	}
+}
+BENCHMARK(BM_DateTime_ToString);
+
+
+static void BM_DateTime_Parse(benchmark::State& state)
+{
+	const std::vector<DateTime> dateTimes = MakeDateTimes(1024);
+	std::vector<std::string> strings;
+	for (const DateTime& dateTime : dateTimes)
+	{
+		strings.push_back(DateTimeToString(dateTime));
+	}
+	DateTime dateTime;
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const std::string& str = strings[i];
+		benchmark::DoNotOptimize(DateTimeParse(str.data(), str.size(), dateTime));
+		i = (i + 1) % strings.size();
+	}
+}
+BENCHMARK(BM_DateTime_Parse);
+
+
+static void BM_DateTime_EpochConversion(benchmark::State& state)
+{
+	const std::vector<DateTime> dateTimes = MakeDateTimes(1024);
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const long long epochMs = DateTimeToEpochMs(dateTimes[i]);
+		benchmark::DoNotOptimize(EpochMsToDateTime(epochMs, 60));
+		i = (i + 1) % dateTimes.size();
+	}
+}
+BENCHMARK(BM_DateTime_EpochConversion);
+
+
+static void BM_DateTime_AddMs(benchmark::State& state)
+{
+	DateTime dateTime = MakeDateTimes(1)[0];
+	for (auto _ : state)
+	{
+		dateTime = DateTimeAddMs(dateTime, 3723001);
+		benchmark::DoNotOptimize(dateTime);
+	}
+}
+BENCHMARK(BM_DateTime_AddMs);
+
+
+static void BM_DateTime_BatchToTimeStamps(benchmark::State& state)
+{
+	const std::vector<DateTime> dateTimes = MakeDateTimes(100000);
+	std::vector<TimeStamp> timeStamps(dateTimes.size());
+	for (auto _ : state)
+	{
+		DateTimesToTimeStamps(dateTimes.data(), dateTimes.size(), timeStamps.data(), (unsigned)state.range(0));
+		benchmark::DoNotOptimize(timeStamps.data());
+	}
+	state.SetItemsProcessed(state.iterations() * dateTimes.size());
+}
+BENCHMARK(BM_DateTime_BatchToTimeStamps)->Arg(1)->Arg(4)->UseRealTime();
@@ -0,0 +1,126 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// DirObject benchmarks
+
+#include <gpvulc/fs/FileUtil.h>
+
+using namespace gpvulc;
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+
+namespace
+{
+	// Synthetic tree, created in the working directory at the first run and kept for the next runs
+	const char* TREE_ROOT = "gpvulc_benchmark_tree/";
+	const int TREE_DEPTH = 3;
+	const int TREE_SUBDIRS = 4;
+	const int TREE_FILES = 16;
+
+
+	void CreateTreeLevel(const std::string& dirPath, int depth)
+	{
+		CreateDir(dirPath);
+		for (int i = 0; i < TREE_FILES; i++)
+		{
+			const std::string fileName = dirPath + "file" + std::to_string(i) + (i % 2 ? ".txt" : ".json");
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 4996 )
+#endif
+			std::FILE* file = std::fopen(fileName.c_str(), "w");
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+			if (file)
+			{
+				std::fputs("{}\n", file);
+				std::fclose(file);
+			}
+		}
+		if (depth < TREE_DEPTH)
+		{
+			for (int i = 0; i < TREE_SUBDIRS; i++)
+			{
+				CreateTreeLevel(dirPath + "dir" + std::to_string(i) + "/", depth + 1);
+			}
+		}
+	}
+
+
+	// Create the synthetic tree if missing, return the expected number of files
+	size_t PrepareTree()
+	{
+		static bool created = false;
+		if (!created)
+		{
+			CreateTreeLevel(TREE_ROOT, 0);
+			created = true;
+		}
+		size_t dirs = 0;
+		size_t levelDirs = 1;
+		for (int depth = 0; depth <= TREE_DEPTH; depth++)
+		{
+			dirs += levelDirs;
+			levelDirs *= TREE_SUBDIRS;
+		}
+		return dirs * TREE_FILES;
+	}
+}
+
+
+static void BM_DirObject_ReadDir(benchmark::State& state)
+{
+	PrepareTree();
+	DirObject dir;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(dir.ReadDir(TREE_ROOT));
+	}
+	state.SetItemsProcessed(state.iterations() * (TREE_FILES + TREE_SUBDIRS));
+}
+BENCHMARK(BM_DirObject_ReadDir);
+
+
+static void BM_DirObject_ReadTree(benchmark::State& state)
+{
+	const size_t numFiles = PrepareTree();
+	DirObject dir;
+	std::vector<std::string> fileNames;
+	for (auto _ : state)
+	{
+		dir.ReadTree(TREE_ROOT);
+		fileNames.clear();
+		dir.GetFileNameList(fileNames);
+	}
+	if (fileNames.size() != numFiles)
+	{
+		state.SkipWithError("the synthetic tree was not created correctly");
+	}
+	state.SetItemsProcessed(state.iterations() * numFiles);
+}
+BENCHMARK(BM_DirObject_ReadTree)->Unit(benchmark::kMillisecond);
+
+
+static void BM_DirObject_FindFile(benchmark::State& state)
+{
+	PrepareTree();
+	DirObject dir;
+	dir.ReadTree(TREE_ROOT);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(dir.FindFile("file15.txt"));
+	}
+}
+BENCHMARK(BM_DirObject_FindFile);
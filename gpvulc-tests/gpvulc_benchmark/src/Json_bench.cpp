@@ -0,0 +1,149 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// JSON parsing and writing benchmarks
+
+#include <gpvulc/json/RapidJsonParser.h>
+#include <gpvulc/json/RapidJsonWriter.h>
+
+using namespace gpvulc::json;
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+
+namespace
+{
+	// Write a document with the given number of entities, returning its JSON text
+	std::string WriteEntities(RapidJsonWriter& writer, int numEntities)
+	{
+		const std::vector<float> matrix = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.5f, -2.25f, 3.125f, 1.0f };
+		std::string jsonText;
+		writer.StartDocument();
+		writer.WriteString("name", "benchmark scenario");
+		writer.StartArray("entities");
+		for (int i = 0; i < numEntities; i++)
+		{
+			writer.StartObject();
+			writer.WriteString("id", "entity_" + std::to_string(i));
+			writer.WriteInt("index", i);
+			writer.WriteBool("visible", i % 3 != 0);
+			writer.WriteDouble("mass", 12.5 + i * 0.25);
+			writer.WriteArray("transform", matrix);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndDocument(jsonText);
+		return jsonText;
+	}
+
+
+	std::string MakeEntitiesText(int numEntities)
+	{
+		RapidJsonWriter writer;
+		return WriteEntities(writer, numEntities);
+	}
+
+
+	// Read all the entities of a parsed document, return the number of entities
+	size_t ReadEntities(RapidJsonParser& parser)
+	{
+		const rapidjson::Value& entities = parser.GetRootElement("entities");
+		std::vector<float> transform;
+		size_t count = 0;
+		for (auto entity = entities.Begin(); entity != entities.End(); ++entity)
+		{
+			benchmark::DoNotOptimize(parser.GetAsString(*entity, "id"));
+			benchmark::DoNotOptimize(parser.GetAsInt(*entity, "index"));
+			benchmark::DoNotOptimize(parser.GetAsBool(*entity, "visible"));
+			benchmark::DoNotOptimize(parser.GetAsFloat(*entity, "mass"));
+			parser.GetAsArray(*entity, "transform", transform);
+			count++;
+		}
+		return count;
+	}
+}
+
+
+static void BM_Json_Parse(benchmark::State& state)
+{
+	const std::string jsonText = MakeEntitiesText((int)state.range(0));
+	RapidJsonParser parser;
+	for (auto _ : state)
+	{
+		parser.Parse(jsonText);
+		benchmark::DoNotOptimize(parser.HasRootElement("entities"));
+	}
+	state.SetBytesProcessed(state.iterations() * jsonText.size());
+}
+BENCHMARK(BM_Json_Parse)->Arg(10)->Arg(1000);
+
+
+static void BM_Json_ParseInsitu(benchmark::State& state)
+{
+	const std::string jsonText = MakeEntitiesText((int)state.range(0));
+	std::vector<char> buffer(jsonText.size() + 1);
+	RapidJsonParser parser;
+	for (auto _ : state)
+	{
+		std::copy(jsonText.c_str(), jsonText.c_str() + buffer.size(), buffer.begin());
+		parser.ParseInsitu(buffer.data());
+		benchmark::DoNotOptimize(parser.HasRootElement("entities"));
+	}
+	state.SetBytesProcessed(state.iterations() * jsonText.size());
+}
+BENCHMARK(BM_Json_ParseInsitu)->Arg(10)->Arg(1000);
+
+
+static void BM_Json_ParseAndRead(benchmark::State& state)
+{
+	const std::string jsonText = MakeEntitiesText((int)state.range(0));
+	RapidJsonParser parser;
+	for (auto _ : state)
+	{
+		parser.Parse(jsonText);
+		benchmark::DoNotOptimize(ReadEntities(parser));
+	}
+	if (parser.ErrorsOccurred())
+	{
+		state.SkipWithError(parser.GetJsonErrorSummary(true));
+	}
+	state.SetBytesProcessed(state.iterations() * jsonText.size());
+}
+BENCHMARK(BM_Json_ParseAndRead)->Arg(10)->Arg(1000);
+
+
+static void BM_Json_Write(benchmark::State& state)
+{
+	RapidJsonWriter writer;
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		size = WriteEntities(writer, (int)state.range(0)).size();
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_Json_Write)->Arg(10)->Arg(1000);
+
+
+static void BM_Json_WriteCompact(benchmark::State& state)
+{
+	RapidJsonWriter writer;
+	writer.SetCompact(true);
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		size = WriteEntities(writer, (int)state.range(0)).size();
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_Json_WriteCompact)->Arg(10)->Arg(1000);
@@ -0,0 +1,97 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// PathInfo benchmarks
+
+#include <gpvulc/path/PathInfo.h>
+
+using namespace gpvulc;
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+
+namespace
+{
+	const std::vector<std::string> SAMPLE_PATHS = {
+		"C:\\Program Files\\gpvulc\\bin\\gpvulc_benchmark-x64.exe",
+		"/usr/local/share/gpvulc/data/scenario.json",
+		"../../gpvulc-tests/gpvulc_benchmark/src/PathInfo_bench.cpp",
+		"D:/projects/dsf/assets/models/robot_arm.v2.fbx",
+		"relative/path/without_extension",
+		"\\\\server\\share\\docs\\readme.txt",
+	};
+}
+
+
+static void BM_PathInfo_SetFullPath(benchmark::State& state)
+{
+	PathInfo pathInfo;
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		pathInfo.SetFullPath(SAMPLE_PATHS[i]);
+		benchmark::DoNotOptimize(pathInfo.GetExt());
+		i = (i + 1) % SAMPLE_PATHS.size();
+	}
+}
+BENCHMARK(BM_PathInfo_SetFullPath);
+
+
+static void BM_PathInfo_Compose(benchmark::State& state)
+{
+	PathInfo pathInfo;
+	for (auto _ : state)
+	{
+		pathInfo.SetPath("/usr/local/share/", "gpvulc/", "data");
+		pathInfo.SetName("scenario");
+		pathInfo.SetExt("json");
+		benchmark::DoNotOptimize(pathInfo.GetFullPath());
+	}
+}
+BENCHMARK(BM_PathInfo_Compose);
+
+
+static void BM_PathInfo_MatchesPattern(benchmark::State& state)
+{
+	std::vector<PathInfo> paths(SAMPLE_PATHS.begin(), SAMPLE_PATHS.end());
+	for (auto _ : state)
+	{
+		int count = 0;
+		for (const PathInfo& pathInfo : paths)
+		{
+			count += pathInfo.MatchesPattern("*.json") ? 1 : 0;
+			count += pathInfo.MatchesPattern("*bench*.c??") ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * paths.size() * 2);
+}
+BENCHMARK(BM_PathInfo_MatchesPattern);
+
+
+static void BM_PathInfo_MatchesPatterns(benchmark::State& state)
+{
+	std::vector<PathInfo> paths(SAMPLE_PATHS.begin(), SAMPLE_PATHS.end());
+	const std::vector<std::string> patterns = { "*.h", "*.cpp", "*.json", "*.txt", "*readme*", "*.fb?" };
+	for (auto _ : state)
+	{
+		int count = 0;
+		for (const PathInfo& pathInfo : paths)
+		{
+			count += pathInfo.MatchesPatterns(patterns) ? 1 : 0;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_PathInfo_MatchesPatterns);
@@ -0,0 +1,298 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// TextBuffer benchmarks
+
+#include <gpvulc/text/TextBuffer.h>
+#include <gpvulc/text/LineReader.h>
+#include <gpvulc/text/text_util.h>
+
+using namespace gpvulc;
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <sstream>
+
+
+namespace
+{
+	// Build a text with the given number of comma separated lines
+	std::string MakeCsvText(int numLines)
+	{
+		std::string text;
+		for (int i = 0; i < numLines; i++)
+		{
+			text += "item" + std::to_string(i) + ",Name_" + std::to_string(i % 97) + ",value,"
+				+ std::to_string(i * 13 % 1000) + ",Lorem ipsum dolor sit amet\n";
+		}
+		return text;
+	}
+
+
+	// Text file with the given number of lines, created in the working directory at the first run
+	std::string MakeCsvFile(int numLines)
+	{
+		const std::string fileName = "gpvulc_benchmark_lines" + std::to_string(numLines) + ".csv";
+		std::ifstream testFile(fileName);
+		if (!testFile.good())
+		{
+			TextBuffer(MakeCsvText(numLines)).Save(fileName);
+		}
+		return fileName;
+	}
+
+
+	// UTF-16LE text with byte order mark (as exported by Windows applications) from an ASCII text
+	std::string MakeUtf16Text(const std::string& text)
+	{
+		std::string text16 = "\xff\xfe";
+		for (char c : text)
+		{
+			text16 += c;
+			text16 += '\0';
+		}
+		return text16;
+	}
+}
+
+
+static void BM_TextBuffer_FindSubString(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	text.Cat("needle");
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.FindSubString("needle"));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_FindSubString)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_FindSubStringCaseInsensitive(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	text.Cat("NeEdLe");
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.FindSubString("needle", true));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_FindSubStringCaseInsensitive)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_FindWholeWord(benchmark::State& state)
+{
+	// each line has a "Name_" field, only the last occurrence is a whole word
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	text.Cat(" Name ");
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.FindSubString("Name", false, true));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_FindWholeWord)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_ReplaceAll(benchmark::State& state)
+{
+	const std::string source = MakeCsvText((int)state.range(0));
+	TextBuffer text;
+	for (auto _ : state)
+	{
+		text.Set(source);
+		benchmark::DoNotOptimize(text.ReplaceAll("value", "replaced_value"));
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextBuffer_ReplaceAll)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_ReplaceAllCaseInsensitive(benchmark::State& state)
+{
+	const std::string source = MakeCsvText((int)state.range(0));
+	TextBuffer text;
+	for (auto _ : state)
+	{
+		text.Set(source);
+		benchmark::DoNotOptimize(text.ReplaceAll("NAME_", "n_", true));
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+// quadratic in the number of replacements, a smaller text keeps the run short
+BENCHMARK(BM_TextBuffer_ReplaceAllCaseInsensitive)->Arg(100)->Arg(1000);
+
+
+static void BM_TextBuffer_LowerCase(benchmark::State& state)
+{
+	const std::string source = MakeCsvText((int)state.range(0));
+	TextBuffer text;
+	for (auto _ : state)
+	{
+		text.Set(source);
+		text.LowerCase();
+		benchmark::DoNotOptimize(text.StdString().data());
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextBuffer_LowerCase)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_CompareCaseInsensitive(benchmark::State& state)
+{
+	const std::string source = MakeCsvText((int)state.range(0));
+	TextBuffer text(source);
+	const std::string upper = GetUpperStr(source);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.EqualTo(upper, true));
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextBuffer_CompareCaseInsensitive)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_SplitChar(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.Split(','));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_SplitChar)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_SplitDelimiters(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.Split(",\n", true));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_SplitDelimiters)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_SplitStr(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.SplitStr(",value,"));
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_SplitStr)->Arg(100)->Arg(10000);
+
+
+static void BM_TextBuffer_CountLines(benchmark::State& state)
+{
+	TextBuffer text(MakeCsvText((int)state.range(0)));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(text.CountLines());
+	}
+	state.SetBytesProcessed(state.iterations() * text.Length());
+}
+BENCHMARK(BM_TextBuffer_CountLines)->Arg(10000);
+
+
+static void BM_TextBuffer_ReadLineStream(benchmark::State& state)
+{
+	const std::string fileName = MakeCsvFile((int)state.range(0));
+	TextBuffer line;
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ifstream textStream(fileName, std::ios::binary);
+		while (line.ReadLine(textStream))
+		{
+			bytes += line.Length() + 1;
+		}
+	}
+	state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_TextBuffer_ReadLineStream)->Arg(100000);
+
+
+static void BM_TextBuffer_ReadLineReader(benchmark::State& state)
+{
+	const std::string fileName = MakeCsvFile((int)state.range(0));
+	TextBuffer line;
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ifstream textStream(fileName, std::ios::binary);
+		LineReader reader(textStream);
+		while (line.ReadLine(reader))
+		{
+			bytes += line.Length() + 1;
+		}
+	}
+	state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_TextBuffer_ReadLineReader)->Arg(100000);
+
+
+static void BM_LineReader_ReadLine(benchmark::State& state)
+{
+	// lines are not copied
+	const std::string fileName = MakeCsvFile((int)state.range(0));
+	size_t bytes = 0;
+	for (auto _ : state)
+	{
+		std::ifstream textStream(fileName, std::ios::binary);
+		LineReader reader(textStream);
+		const char* line = nullptr;
+		size_t length = 0;
+		while (reader.ReadLine(line, length))
+		{
+			bytes += length + 1;
+		}
+	}
+	state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_LineReader_ReadLine)->Arg(100000);
+
+
+static void BM_ReadText16(benchmark::State& state)
+{
+	const std::string text16 = MakeUtf16Text(MakeCsvText((int)state.range(0)));
+	std::string text;
+	for (auto _ : state)
+	{
+		std::istringstream textStream(text16);
+		ReadText16(textStream, text);
+		benchmark::DoNotOptimize(text.data());
+	}
+	state.SetBytesProcessed(state.iterations() * text16.size());
+}
+BENCHMARK(BM_ReadText16)->Arg(10000);
+
+
+static void BM_WriteText16(benchmark::State& state)
+{
+	const std::string text = MakeCsvText((int)state.range(0));
+	for (auto _ : state)
+	{
+		std::ostringstream textStream;
+		WriteText16(textStream, text);
+		benchmark::DoNotOptimize(textStream.tellp());
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_WriteText16)->Arg(10000);
@@ -0,0 +1,265 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// TextParser benchmarks
+
+#include <gpvulc/text/TextParser.h>
+#include <gpvulc/text/KeywordSet.h>
+#include <gpvulc/text/text_util.h>
+
+using namespace gpvulc;
+
+#include <benchmark/benchmark.h>
+
+
+namespace
+{
+	// Build a C-like source text with the given number of functions
+	std::string MakeSourceText(int numFunctions)
+	{
+		std::string text;
+		for (int i = 0; i < numFunctions; i++)
+		{
+			const std::string n = std::to_string(i);
+			text += "// function " + n + "\n"
+				"int f" + n + "( int a, float b ) {\n"
+				"  if (a < " + n + ") { return (int)(b * 2); }\n"
+				"  const char* s = \"text { with } braces\";\n"
+				"  return a + " + n + ";\n"
+				"}\n";
+		}
+		return text;
+	}
+}
+
+
+static void BM_TextParser_GetToken(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetToken())
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_GetToken)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_GetTokenSeparators(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetToken(" \t\r\n(){},;"))
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_GetTokenSeparators)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_GetLine(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetLine())
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_GetLine)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_GetBlock(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	parser.SetQuotedTextIgnored();
+	parser.SetCppCommentsIgnored();
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetBlock("{", "}"))
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_GetBlock)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_GetBlockAfter(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.GetBlockAfter("if", "(", ")"))
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_GetBlockAfter)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_ReachFirstAmong(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	const std::vector<std::string> keywords = { "return", "const", "float" };
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.ReachFirstAmong(keywords) && parser.Forward())
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_ReachFirstAmong)->Arg(10)->Arg(1000);
+
+
+static void BM_TextParser_ReachFirstAmongKeywordSet(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	const KeywordSet keywords({ "return", "const", "float" });
+	TextParser parser(source);
+	for (auto _ : state)
+	{
+		parser.ResetParsing();
+		int count = 0;
+		while (parser.ReachFirstAmong(keywords) && parser.Forward())
+		{
+			count++;
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_ReachFirstAmongKeywordSet)->Arg(10)->Arg(1000);
+
+
+namespace
+{
+	// keywords and tokens to look up, half of them are not keywords
+	std::vector<std::string> MakeKeywords(int count)
+	{
+		std::vector<std::string> keywords;
+		for (int i = 0; i < count; i++)
+		{
+			keywords.push_back("Keyword" + std::to_string(i));
+		}
+		return keywords;
+	}
+}
+
+
+static void BM_StrIsOneOf(benchmark::State& state)
+{
+	const std::vector<std::string> keywords = MakeKeywords((int)state.range(0));
+	const std::vector<std::string> tokens = MakeKeywords((int)state.range(0) * 2);
+	for (auto _ : state)
+	{
+		int count = 0;
+		for (const std::string& token : tokens)
+		{
+			count += StrIsOneOf(token, keywords, true);
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * tokens.size());
+}
+BENCHMARK(BM_StrIsOneOf)->Arg(10)->Arg(200);
+
+
+static void BM_KeywordSet_Find(benchmark::State& state)
+{
+	const KeywordSet keywords(MakeKeywords((int)state.range(0)), true);
+	const std::vector<std::string> tokens = MakeKeywords((int)state.range(0) * 2);
+	for (auto _ : state)
+	{
+		int count = 0;
+		for (const std::string& token : tokens)
+		{
+			count += keywords.Contains(token);
+		}
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * tokens.size());
+}
+BENCHMARK(BM_KeywordSet_Find)->Arg(10)->Arg(200);
+
+
+static void BM_TextParser_GetPosition(benchmark::State& state)
+{
+	// line and column of positions spread over the text, after the line index is built
+	const std::string source = MakeSourceText((int)state.range(0));
+	TextParser parser(source);
+	parser.GetLineCount();
+	const int step = (int)source.size() / 1000;
+	for (auto _ : state)
+	{
+		int line = 0;
+		int column = 0;
+		for (int offset = 0; offset < (int)source.size(); offset += step)
+		{
+			parser.GetLineAndColumn(offset, line, column);
+		}
+		benchmark::DoNotOptimize(line + column);
+	}
+	state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_TextParser_GetPosition)->Arg(1000)->Arg(100000);
+
+
+static void BM_TextParser_BuildLineIndex(benchmark::State& state)
+{
+	const std::string source = MakeSourceText((int)state.range(0));
+	LineIndex index;
+	for (auto _ : state)
+	{
+		index.Build(source);
+		benchmark::DoNotOptimize(index.GetLineCount());
+	}
+	state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_TextParser_BuildLineIndex)->Arg(1000);
@@ -0,0 +1,31 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char* argv[])
+{
+	// using Google Benchmark, see:
+	// https://github.com/google/benchmark/blob/main/docs/user_guide.md
+	// Results are saved for gpvulc_benchmark_compare with:
+	//   --benchmark_out=results.json --benchmark_out_format=json
+
+	::benchmark::Initialize(&argc, argv);
+	if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+	// no pause at the end: benchmarks are run by scripts
+
+	return 0;
+}
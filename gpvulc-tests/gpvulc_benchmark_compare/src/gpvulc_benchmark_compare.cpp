@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// Compare two result files written by gpvulc_benchmark
+// (--benchmark_out=<file> --benchmark_out_format=json) and report regressions.
+//
+// Usage: gpvulc_benchmark_compare <baseline.json> <current.json> [threshold_percent=5] [real_time|cpu_time]
+// Exit code: 0 = no regressions, 1 = regressions found, 2 = invalid arguments or files.
+
+#include <gpvulc/json/RapidJsonParser.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+using namespace gpvulc::json;
+
+
+namespace
+{
+	struct BenchmarkTime
+	{
+		double TotalNs = 0.0;
+		int Count = 0;
+		bool Median = false;
+		bool Failed = false;
+
+		double GetTimeNs() const { return Count > 0 ? TotalNs / Count : 0.0; }
+	};
+
+	typedef std::map<std::string, BenchmarkTime> BenchmarkTimes;
+
+
+	double TimeUnitToNs(const std::string& unit)
+	{
+		if (unit == "us") return 1e3;
+		if (unit == "ms") return 1e6;
+		if (unit == "s") return 1e9;
+		return 1.0;
+	}
+
+
+	double GetNumber(RapidJsonParser& parser, const rapidjson::Value& val, const char* name)
+	{
+		const rapidjson::Value* member = parser.FindMember(val, name);
+		return member && member->IsNumber() ? member->GetDouble() : 0.0;
+	}
+
+
+	/*
+	Read the time of each benchmark from a result file.
+	If repetitions were run the median is used, else the iterations of the same benchmark are averaged.
+	*/
+	bool ReadResults(const std::string& fileName, const char* metric, BenchmarkTimes& times)
+	{
+		RapidJsonParser parser;
+		try
+		{
+			if (!parser.ParseFile(fileName))
+			{
+				std::fprintf(stderr, "Cannot open %s\n", fileName.c_str());
+				return false;
+			}
+			const rapidjson::Value& benchmarks = parser.GetRootElement("benchmarks");
+			if (!parser.CheckIsArray(benchmarks))
+			{
+				std::fprintf(stderr, "Invalid results in %s\n%s\n", fileName.c_str(), parser.GetJsonErrorSummary(true));
+				return false;
+			}
+			for (auto bench = benchmarks.Begin(); bench != benchmarks.End(); ++bench)
+			{
+				const char* name = parser.GetAsString(*bench, "name");
+				const std::string runName = parser.GetAsString(*bench, "run_name", true);
+				const std::string runType = parser.GetAsString(*bench, "run_type", true);
+				const std::string aggregate = parser.GetAsString(*bench, "aggregate_name", true);
+				const std::string unit = parser.GetAsString(*bench, "time_unit", true);
+				const bool failed = parser.GetAsBool(*bench, "error_occurred", true);
+
+				const bool isMedian = runType == "aggregate" && aggregate == "median";
+				if (runType == "aggregate" && !isMedian)
+				{
+					continue;
+				}
+				BenchmarkTime& time = times[runName.empty() ? std::string(name) : runName];
+				if (time.Median && !isMedian)
+				{
+					continue;
+				}
+				const double timeNs = GetNumber(parser, *bench, metric) * TimeUnitToNs(unit);
+				if (isMedian && !time.Median)
+				{
+					time = BenchmarkTime();
+					time.Median = true;
+				}
+				time.TotalNs += timeNs;
+				time.Count++;
+				time.Failed = time.Failed || failed;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "Error reading %s: %s\n", fileName.c_str(), e.what());
+			return false;
+		}
+		if (parser.ErrorsOccurred())
+		{
+			std::fprintf(stderr, "Invalid results in %s\n%s\n", fileName.c_str(), parser.GetJsonErrorSummary(true));
+			return false;
+		}
+		return true;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "Usage: %s <baseline.json> <current.json> [threshold_percent=5] [real_time|cpu_time]\n", argv[0]);
+		return 2;
+	}
+	const double threshold = argc > 3 ? std::atof(argv[3]) : 5.0;
+	const char* metric = argc > 4 ? argv[4] : "real_time";
+	if (threshold <= 0.0 || (std::strcmp(metric, "real_time") != 0 && std::strcmp(metric, "cpu_time") != 0))
+	{
+		std::fprintf(stderr, "Invalid threshold or metric\n");
+		return 2;
+	}
+
+	BenchmarkTimes baseline;
+	BenchmarkTimes current;
+	if (!ReadResults(argv[1], metric, baseline) || !ReadResults(argv[2], metric, current))
+	{
+		return 2;
+	}
+
+	int regressions = 0;
+	int improvements = 0;
+	std::printf("%-60s %14s %14s %9s\n", "Benchmark", "Baseline(ns)", "Current(ns)", "Change");
+	for (const auto& result : current)
+	{
+		const std::string& name = result.first;
+		const BenchmarkTime& time = result.second;
+		auto base = baseline.find(name);
+		if (base == baseline.end())
+		{
+			std::printf("%-60s %14s %14.1f %9s\n", name.c_str(), "-", time.GetTimeNs(), "NEW");
+			continue;
+		}
+		if (time.Failed || base->second.Failed)
+		{
+			std::printf("%-60s %14s %14s %9s\n", name.c_str(), "-", "-", "FAILED");
+			continue;
+		}
+		const double baseNs = base->second.GetTimeNs();
+		const double currNs = time.GetTimeNs();
+		const double change = baseNs > 0.0 ? (currNs - baseNs) * 100.0 / baseNs : 0.0;
+		const char* flag = "";
+		if (change > threshold)
+		{
+			flag = "  << REGRESSION";
+			regressions++;
+		}
+		else if (change < -threshold)
+		{
+			flag = "  (improved)";
+			improvements++;
+		}
+		std::printf("%-60s %14.1f %14.1f %+8.1f%%%s\n", name.c_str(), baseNs, currNs, change, flag);
+	}
+	for (const auto& result : baseline)
+	{
+		if (current.find(result.first) == current.end())
+		{
+			std::printf("%-60s %14.1f %14s %9s\n", result.first.c_str(), result.second.GetTimeNs(), "-", "REMOVED");
+		}
+	}
+
+	std::printf("\n%d regression(s), %d improvement(s) beyond %.1f%% (%s)\n", regressions, improvements, threshold, metric);
+
+	return regressions > 0 ? 1 : 0;
+}
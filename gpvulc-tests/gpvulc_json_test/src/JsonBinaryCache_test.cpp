@@ -0,0 +1,286 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// JsonBinaryCache_test.cpp
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <gpvulc/json/RapidJsonParser.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	const char* const SOURCE_FILE_NAME = "gpvulc_json_cache_test.json";
+	const char* const CACHE_FILE_NAME = "gpvulc_json_cache_test.jbc";
+
+	// Every type of value, with strings containing null characters
+	const std::string SOURCE_TEXT = R"({
+		"int": -5, "uint": 3000000000, "int64": -5000000000, "uint64": 18446744073709551615,
+		"double": 0.125, "zero": 0,
+		"strings": [ "a\u0000b", "", "\u0000", "text" ],
+		"nested": { "array": [ [ 1, [ 2, {} ] ], { "x": null, "t": true, "f": false } ], "empty": [] }
+		})";
+
+
+	void WriteFile(const std::string& fileName, const std::string& content)
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file.write(content.data(), content.size());
+	}
+
+
+	std::string ReadFile(const std::string& fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+
+	// Move the modification time of a file by the given number of seconds
+	void ShiftFileTime(const std::string& fileName, int seconds)
+	{
+#ifdef _WIN32
+		struct _stat64 fileStat;
+		_stat64(fileName.c_str(), &fileStat);
+		struct _utimbuf times;
+		times.actime = fileStat.st_atime;
+		times.modtime = fileStat.st_mtime + seconds;
+		_utime(fileName.c_str(), &times);
+#else
+		struct stat fileStat;
+		stat(fileName.c_str(), &fileStat);
+		struct utimbuf times;
+		times.actime = fileStat.st_atime;
+		times.modtime = fileStat.st_mtime + seconds;
+		utime(fileName.c_str(), &times);
+#endif
+	}
+
+
+	// Check the values of SOURCE_TEXT, including the type of the numbers
+	void CheckValues(const rapidjson::Value& root)
+	{
+		ASSERT_TRUE(root.IsObject());
+		EXPECT_TRUE(root["int"].IsInt());
+		EXPECT_FALSE(root["int"].IsUint());
+		EXPECT_EQ(root["int"].GetInt(), -5);
+		EXPECT_TRUE(root["uint"].IsUint());
+		EXPECT_FALSE(root["uint"].IsInt());
+		EXPECT_EQ(root["uint"].GetUint(), 3000000000u);
+		EXPECT_TRUE(root["int64"].IsInt64());
+		EXPECT_FALSE(root["int64"].IsInt());
+		EXPECT_EQ(root["int64"].GetInt64(), -5000000000LL);
+		EXPECT_TRUE(root["uint64"].IsUint64());
+		EXPECT_FALSE(root["uint64"].IsInt64());
+		EXPECT_EQ(root["uint64"].GetUint64(), 18446744073709551615ULL);
+		EXPECT_TRUE(root["double"].IsDouble());
+		EXPECT_EQ(root["double"].GetDouble(), 0.125);
+		EXPECT_TRUE(root["zero"].IsInt());
+		EXPECT_TRUE(root["zero"].IsUint());
+
+		const rapidjson::Value& strings = root["strings"];
+		ASSERT_TRUE(strings.IsArray());
+		ASSERT_EQ(strings.Size(), 4u);
+		EXPECT_EQ(std::string(strings[0].GetString(), strings[0].GetStringLength()), std::string("a\0b", 3));
+		EXPECT_EQ(strings[1].GetStringLength(), 0u);
+		EXPECT_EQ(std::string(strings[2].GetString(), strings[2].GetStringLength()), std::string(1, '\0'));
+		EXPECT_STREQ(strings[3].GetString(), "text");
+
+		const rapidjson::Value& nested = root["nested"];
+		ASSERT_TRUE(nested.IsObject());
+		const rapidjson::Value& array = nested["array"];
+		ASSERT_EQ(array.Size(), 2u);
+		ASSERT_EQ(array[0].Size(), 2u);
+		EXPECT_EQ(array[0][0].GetInt(), 1);
+		EXPECT_EQ(array[0][1][0].GetInt(), 2);
+		EXPECT_TRUE(array[0][1][1].IsObject());
+		EXPECT_EQ(array[0][1][1].MemberCount(), 0u);
+		EXPECT_TRUE(array[1]["x"].IsNull());
+		EXPECT_TRUE(array[1]["t"].IsTrue());
+		EXPECT_TRUE(array[1]["f"].IsFalse());
+		EXPECT_TRUE(nested["empty"].IsArray());
+		EXPECT_EQ(nested["empty"].Size(), 0u);
+	}
+
+
+	// Source and cache files created for a test and removed at the end
+	class JsonBinaryCacheTest : public ::testing::Test
+	{
+	protected:
+
+		void SetUp() override
+		{
+			WriteFile(SOURCE_FILE_NAME, SOURCE_TEXT);
+			std::remove(CACHE_FILE_NAME);
+			Expected.Parse(SOURCE_TEXT.c_str(), SOURCE_TEXT.size());
+		}
+
+		void TearDown() override
+		{
+			std::remove(SOURCE_FILE_NAME);
+			std::remove(CACHE_FILE_NAME);
+		}
+
+		rapidjson::Document Expected;
+	};
+}
+
+
+// Every type of value is stored and loaded without changes
+TEST_F(JsonBinaryCacheTest, RoundTrip)
+{
+	ASSERT_FALSE(Expected.HasParseError());
+	CheckValues(Expected);
+	ASSERT_TRUE(JsonBinaryCache::Write(Expected, SOURCE_FILE_NAME, CACHE_FILE_NAME));
+
+	JsonBinaryCache cache;
+	ASSERT_TRUE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	ArenaDocument document;
+	ASSERT_TRUE(cache.Load(document));
+	CheckValues(document);
+	EXPECT_TRUE(document == Expected);
+	cache.Close();
+	EXPECT_FALSE(cache.IsOpen());
+
+	// the source file must exist
+	EXPECT_FALSE(JsonBinaryCache::Write(Expected, "missing_source.json", CACHE_FILE_NAME));
+	EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, "missing_source.json"));
+	EXPECT_FALSE(cache.Open("missing_cache.jbc", SOURCE_FILE_NAME));
+}
+
+
+// A cache is not used if the size or the modification time of the source file changed
+TEST_F(JsonBinaryCacheTest, Staleness)
+{
+	ASSERT_TRUE(JsonBinaryCache::Write(Expected, SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	JsonBinaryCache cache;
+	EXPECT_TRUE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	cache.Close();
+
+	// different size
+	WriteFile(SOURCE_FILE_NAME, SOURCE_TEXT + " ");
+	EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	EXPECT_FALSE(cache.IsOpen());
+
+	// same size, different time
+	WriteFile(SOURCE_FILE_NAME, SOURCE_TEXT);
+	ASSERT_TRUE(JsonBinaryCache::Write(Expected, SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_TRUE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	cache.Close();
+	ShiftFileTime(SOURCE_FILE_NAME, 10);
+	EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+
+	// the parser writes a new cache and uses it for the next loads
+	RapidJsonParser parser;
+	ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_EQ(parser.GetRootElement("uint64").GetUint64(), 18446744073709551615ULL);
+	parser.Reset();
+	EXPECT_TRUE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	cache.Close();
+	ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_EQ(parser.GetRootElement("int64").GetInt64(), -5000000000LL);
+	parser.Reset();
+
+	// a modified source is parsed again
+	WriteFile(SOURCE_FILE_NAME, "{ \"int\": 7 }");
+	ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_EQ(parser.GetInt(parser.GetRootElement("int")), 7);
+	EXPECT_FALSE(parser.HasRootElement("uint64"));
+	parser.Reset();
+
+	// a source rewritten with the same size within the same second is parsed again
+	// (the wait is much shorter than one second, but longer than the clock tick of the file system)
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	WriteFile(SOURCE_FILE_NAME, "{ \"int\": 8 }");
+	EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+	ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_EQ(parser.GetInt(parser.GetRootElement("int")), 8);
+	parser.Reset();
+	ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	EXPECT_EQ(parser.GetInt(parser.GetRootElement("int")), 8);
+}
+
+
+// A truncated or corrupted cache is rejected, the parser falls back to the text
+TEST_F(JsonBinaryCacheTest, Corrupted)
+{
+	ASSERT_TRUE(JsonBinaryCache::Write(Expected, SOURCE_FILE_NAME, CACHE_FILE_NAME));
+	const std::string cacheContent = ReadFile(CACHE_FILE_NAME);
+	// the payload follows a header of 32 bytes, it starts with the tag of the root object and its member count
+	const size_t payloadBegin = 32;
+	ASSERT_GT(cacheContent.size(), payloadBegin + 5);
+	ASSERT_EQ(cacheContent[payloadBegin + 1], '\x08');
+
+	JsonBinaryCache cache;
+	ArenaDocument document;
+	RapidJsonParser parser;
+
+	// truncated: the header does not match the file size
+	for (size_t size : { (size_t)0, (size_t)10, cacheContent.size() - 1 })
+	{
+		WriteFile(CACHE_FILE_NAME, cacheContent.substr(0, size));
+		EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME)) << size;
+		ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+		EXPECT_EQ(parser.GetRootElement("uint").GetUint(), 3000000000u);
+		EXPECT_EQ(parser.GetRootElement("strings")[0].GetStringLength(), 3u);
+		parser.Reset();
+		// the cache is written again
+		EXPECT_EQ(ReadFile(CACHE_FILE_NAME), cacheContent);
+	}
+
+	// corrupted payload: a wrong tag, a missing string terminator, wrong element counts
+	std::string badTag = cacheContent;
+	badTag[payloadBegin] = '\x7f';
+	std::string badString = cacheContent;
+	const size_t textPos = badString.find("text");
+	ASSERT_NE(textPos, std::string::npos);
+	badString[textPos + 4] = 'x';
+	std::string badCount = cacheContent;
+	badCount[payloadBegin + 1] = '\x7f';
+	for (const std::string& corrupted : { badTag, badString, badCount })
+	{
+		WriteFile(CACHE_FILE_NAME, corrupted);
+		ASSERT_TRUE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+		document.SetNull();
+		EXPECT_FALSE(cache.Load(document));
+		EXPECT_TRUE(document.IsNull());
+		cache.Close();
+
+		ASSERT_TRUE(parser.ParseFileCached(SOURCE_FILE_NAME, CACHE_FILE_NAME));
+		EXPECT_EQ(parser.GetRootElement("int").GetInt(), -5);
+		EXPECT_STREQ(parser.GetRootElement("strings")[3].GetString(), "text");
+		parser.Reset();
+		EXPECT_EQ(ReadFile(CACHE_FILE_NAME), cacheContent);
+	}
+
+	// another format
+	std::string badMagic = cacheContent;
+	badMagic[0] = 'X';
+	WriteFile(CACHE_FILE_NAME, badMagic);
+	EXPECT_FALSE(cache.Open(CACHE_FILE_NAME, SOURCE_FILE_NAME));
+}
@@ -0,0 +1,218 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// JsonLinesReader_test.cpp
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gpvulc/json/JsonLinesReader.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	struct Record
+	{
+		int Id = 0;
+		std::string Name;
+	};
+
+
+	// Read the "id" member (required) and the "name" member (optional)
+	void ConvertRecord(RapidJsonParser& parser, Record& record)
+	{
+		record.Id = parser.GetInt(parser.GetRootElement("id"), "id");
+		record.Name = parser.HasRootElement("name") ? parser.GetString(parser.GetRootElement("name"), "name") : "";
+	}
+
+
+	// Build a JSONL text with the given number of records
+	std::string MakeLines(int count)
+	{
+		std::string text;
+		for (int i = 0; i < count; i++)
+		{
+			text += "{ \"id\": " + std::to_string(i) + ", \"name\": \"record" + std::to_string(i) + "\" }\n";
+		}
+		return text;
+	}
+
+
+	// Read a text (copied, it is modified by the reader), collecting line numbers and records
+	void ReadText(
+		JsonLinesReader& reader,
+		std::string text,
+		std::vector<std::pair<size_t, Record>>& records,
+		std::vector<std::pair<size_t, std::string>>& errors)
+	{
+		reader.Read<Record>(&text[0], text.size(), ConvertRecord,
+			[&records](size_t lineNumber, Record& record) { records.emplace_back(lineNumber, record); },
+			[&errors](size_t lineNumber, const char* errorMessage) { errors.emplace_back(lineNumber, errorMessage); });
+	}
+}
+
+
+// Records are delivered in the order of the lines, across many batches
+TEST(JsonLinesReaderTest, OrderedBatches)
+{
+	for (size_t batchSize : { (size_t)1, (size_t)7, (size_t)64, JsonLinesReader::DEFAULT_BATCH_SIZE })
+	{
+		JsonLinesReader reader(4);
+		reader.SetBatchSize(batchSize);
+		std::vector<std::pair<size_t, Record>> records;
+		std::vector<std::pair<size_t, std::string>> errors;
+		ReadText(reader, MakeLines(1000), records, errors);
+		EXPECT_TRUE(errors.empty());
+		EXPECT_EQ(reader.GetRecordCount(), 1000u);
+		EXPECT_EQ(reader.GetErrorCount(), 0u);
+		ASSERT_EQ(records.size(), 1000u);
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			ASSERT_EQ(records[i].first, i + 1) << "batch size " << batchSize;
+			ASSERT_EQ(records[i].second.Id, (int)i);
+			ASSERT_EQ(records[i].second.Name, "record" + std::to_string(i));
+		}
+	}
+}
+
+
+// Blank lines are skipped but counted, CRLF line endings and a last line without newline are accepted
+TEST(JsonLinesReaderTest, LineNumbers)
+{
+	const std::string text =
+		"\n"
+		"{ \"id\": 1 }\r\n"
+		"   \r\n"
+		"\t\n"
+		"{ \"id\": 2, \"name\": \"two\" }  \r\n"
+		"\r\n"
+		"\n"
+		"{ \"id\": 3, \"name\": \"last\" }";
+	JsonLinesReader reader(2);
+	reader.SetBatchSize(2);
+	std::vector<std::pair<size_t, Record>> records;
+	std::vector<std::pair<size_t, std::string>> errors;
+	ReadText(reader, text, records, errors);
+	EXPECT_TRUE(errors.empty());
+	ASSERT_EQ(records.size(), 3u);
+	EXPECT_EQ(records[0].first, 2u);
+	EXPECT_EQ(records[0].second.Id, 1);
+	EXPECT_EQ(records[0].second.Name, "");
+	EXPECT_EQ(records[1].first, 5u);
+	EXPECT_EQ(records[1].second.Id, 2);
+	EXPECT_EQ(records[1].second.Name, "two");
+	EXPECT_EQ(records[2].first, 8u);
+	EXPECT_EQ(records[2].second.Id, 3);
+	EXPECT_EQ(records[2].second.Name, "last");
+
+	// empty and blank texts
+	records.clear();
+	ReadText(reader, "", records, errors);
+	ReadText(reader, "\n \r\n\n", records, errors);
+	EXPECT_TRUE(records.empty());
+	EXPECT_TRUE(errors.empty());
+	EXPECT_EQ(reader.GetRecordCount(), 0u);
+}
+
+
+// Parsing and content errors are reported for their lines, in order
+TEST(JsonLinesReaderTest, Errors)
+{
+	const std::string text =
+		"{ \"id\": 1 }\n"
+		"{ \"id\": 2\n"
+		"{ \"id\": \"3\" }\n"
+		"{ \"name\": \"four\" }\n"
+		"\n"
+		"{ \"id\": 5, \"name\": 5 }\n"
+		"{ \"id\": 6 }\n"
+		"not json\n"
+		"{ \"id\": 8 }";
+	JsonLinesReader reader(3);
+	reader.SetBatchSize(3);
+	std::vector<std::pair<size_t, Record>> records;
+	std::vector<std::pair<size_t, std::string>> errors;
+	ReadText(reader, text, records, errors);
+
+	ASSERT_EQ(records.size(), 3u);
+	EXPECT_EQ(records[0].second.Id, 1);
+	EXPECT_EQ(records[1].second.Id, 6);
+	EXPECT_EQ(records[1].first, 7u);
+	EXPECT_EQ(records[2].second.Id, 8);
+	EXPECT_EQ(reader.GetRecordCount(), 3u);
+	EXPECT_EQ(reader.GetErrorCount(), 5u);
+
+	ASSERT_EQ(errors.size(), 5u);
+	EXPECT_EQ(errors[0].first, 2u);
+	EXPECT_EQ(errors[0].second.find("parsing error"), 0u) << errors[0].second;
+	EXPECT_EQ(errors[1].first, 3u);
+	EXPECT_EQ(errors[1].second, "Wrong type for id\n");
+	EXPECT_EQ(errors[2].first, 4u);
+	EXPECT_EQ(errors[2].second, "Missing root element id\n");
+	EXPECT_EQ(errors[3].first, 6u);
+	EXPECT_EQ(errors[3].second, "Wrong type for name\n");
+	EXPECT_EQ(errors[4].first, 8u);
+	EXPECT_EQ(errors[4].second.find("parsing error"), 0u) << errors[4].second;
+
+	// errors are counted also without an error handler
+	std::string copy = text;
+	size_t recordCount = 0;
+	reader.Read<Record>(&copy[0], copy.size(), ConvertRecord, [&recordCount](size_t, Record&) { recordCount++; });
+	EXPECT_EQ(recordCount, 3u);
+	EXPECT_EQ(reader.GetErrorCount(), 5u);
+}
+
+
+// An exception thrown by the record handler stops the reading, the reader can be used again
+TEST(JsonLinesReaderTest, HandlerException)
+{
+	JsonLinesReader reader(3);
+	reader.SetBatchSize(8);
+	std::string text = MakeLines(100);
+	std::vector<int> ids;
+	EXPECT_THROW(reader.Read<Record>(&text[0], text.size(), ConvertRecord,
+		[&ids](size_t, Record& record)
+		{
+			if (record.Id == 50)
+			{
+				throw std::runtime_error("stop");
+			}
+			ids.push_back(record.Id);
+		}), std::runtime_error);
+	ASSERT_EQ(ids.size(), 50u);
+	EXPECT_EQ(ids.back(), 49);
+
+	// the worker threads are idle and all the lines are read again
+	std::vector<std::pair<size_t, Record>> records;
+	std::vector<std::pair<size_t, std::string>> errors;
+	ReadText(reader, MakeLines(100), records, errors);
+	EXPECT_TRUE(errors.empty());
+	ASSERT_EQ(records.size(), 100u);
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		EXPECT_EQ(records[i].second.Id, (int)i);
+	}
+
+	// an exception thrown by the error handler is handled in the same way
+	std::string invalid = "{}\n" + MakeLines(30);
+	EXPECT_THROW(reader.Read<Record>(&invalid[0], invalid.size(), ConvertRecord,
+		[](size_t, Record&) {},
+		[](size_t, const char*) { throw std::runtime_error("error"); }), std::runtime_error);
+	records.clear();
+	ReadText(reader, MakeLines(20), records, errors);
+	EXPECT_EQ(records.size(), 20u);
+}
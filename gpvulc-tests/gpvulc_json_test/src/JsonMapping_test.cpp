@@ -0,0 +1,320 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// JsonMapping_test.cpp
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gpvulc/json/JsonMapping.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	struct Point
+	{
+		float X = 0;
+		float Y = 0;
+		std::string Label;
+
+		static auto JsonFields()
+		{
+			return MakeJsonFields(
+				JsonField("x", &Point::X),
+				JsonField("y", &Point::Y),
+				JsonField("label", &Point::Label, true));
+		}
+
+		bool operator==(const Point& p) const { return X == p.X && Y == p.Y && Label == p.Label; }
+	};
+
+
+	struct Shape
+	{
+		std::string Name;
+		bool Visible = false;
+		int Layer = 0;
+		double Area = 0;
+		Point Center;
+		std::vector<Point> Points;
+		std::vector<std::vector<int>> Grid;
+		std::vector<std::vector<Point>> Paths;
+		std::vector<std::string> Tags;
+
+		static auto JsonFields()
+		{
+			return MakeJsonFields(
+				JsonField("name", &Shape::Name),
+				JsonField("visible", &Shape::Visible),
+				JsonField("layer", &Shape::Layer),
+				JsonField("area", &Shape::Area),
+				JsonField("center", &Shape::Center),
+				JsonField("points", &Shape::Points),
+				JsonField("grid", &Shape::Grid),
+				JsonField("paths", &Shape::Paths),
+				JsonField("tags", &Shape::Tags, true));
+		}
+	};
+
+
+	struct Scene
+	{
+		std::vector<Shape> Shapes;
+		std::vector<double> Weights;
+
+		static auto JsonFields()
+		{
+			return MakeJsonFields(
+				JsonField("shapes", &Scene::Shapes),
+				JsonField("weights", &Scene::Weights));
+		}
+	};
+
+
+	// Invalid mapping: the same name for two fields
+	struct Repeated
+	{
+		int A = 0;
+		int B = 0;
+
+		static auto JsonFields()
+		{
+			return MakeJsonFields(
+				JsonField("a", &Repeated::A),
+				JsonField("a", &Repeated::B));
+		}
+	};
+
+
+	void ExpectEqual(const Shape& expected, const Shape& shape)
+	{
+		EXPECT_EQ(shape.Name, expected.Name);
+		EXPECT_EQ(shape.Visible, expected.Visible);
+		EXPECT_EQ(shape.Layer, expected.Layer);
+		EXPECT_EQ(shape.Area, expected.Area);
+		EXPECT_TRUE(shape.Center == expected.Center);
+		EXPECT_TRUE(shape.Points == expected.Points);
+		EXPECT_EQ(shape.Grid, expected.Grid);
+		EXPECT_TRUE(shape.Paths == expected.Paths);
+		EXPECT_EQ(shape.Tags, expected.Tags);
+	}
+}
+
+
+// Write and read back a mapped type with nested types and arrays
+TEST(JsonMappingTest, RoundTrip)
+{
+	Scene scene;
+	Shape shape;
+	shape.Name = "polygon";
+	shape.Visible = true;
+	shape.Layer = -3;
+	shape.Area = 12.5;
+	shape.Center = { 1.5f, -2.25f, "center" };
+	shape.Points = { { 0.0f, 0.0f, "" }, { 4.0f, 0.5f, "corner" } };
+	shape.Grid = { { 1, 2, 3 }, {}, { -4 } };
+	shape.Paths = { { { 1.0f, 2.0f, "" } }, {}, { { 3.0f, 4.0f, "a" }, { 5.0f, 6.0f, "b" } } };
+	shape.Tags = { "red", "", "large" };
+	scene.Shapes.push_back(shape);
+	scene.Shapes.push_back(Shape());
+	scene.Weights = { 0.5, -1.0, 1e10 };
+
+	RapidJsonWriter writer;
+	std::string jsonText;
+	writer.StartDocument();
+	WriteJsonObject(writer, "scene", scene);
+	writer.EndDocument(jsonText);
+
+	RapidJsonParser parser;
+	parser.Parse(jsonText);
+	Scene restored;
+	EXPECT_TRUE(ReadJsonObject(parser, parser.GetRootElement("scene"), restored));
+	EXPECT_FALSE(parser.ErrorsOccurred()) << parser.GetJsonErrorSummary(true);
+	ASSERT_EQ(restored.Shapes.size(), 2u);
+	ExpectEqual(scene.Shapes[0], restored.Shapes[0]);
+	ExpectEqual(scene.Shapes[1], restored.Shapes[1]);
+	EXPECT_EQ(restored.Weights, scene.Weights);
+
+	// the members of the document are written in the same way
+	std::string membersText;
+	writer.StartDocument();
+	WriteJsonMembers(writer, scene);
+	writer.EndDocument(membersText);
+	parser.Parse("{ \"scene\": " + membersText + " }");
+	Scene restoredMembers;
+	EXPECT_TRUE(ReadJsonObject(parser, parser.GetRootElement("scene"), restoredMembers));
+	ASSERT_EQ(restoredMembers.Shapes.size(), 2u);
+	ExpectEqual(scene.Shapes[0], restoredMembers.Shapes[0]);
+}
+
+
+// Optional members can be missing, unknown members are ignored
+TEST(JsonMappingTest, OptionalMembers)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "shape": { "name": "s", "visible": false, "layer": 1, "area": 0, "center": { "x": 1, "y": 2 },
+		"points": [ { "y": 3, "x": 4, "color": "red" } ], "grid": [], "paths": [], "unknown": { "x": "?" } } })");
+	Shape shape;
+	shape.Tags = { "old" };
+	shape.Center.Label = "old";
+	EXPECT_TRUE(ReadJsonObject(parser, parser.GetRootElement("shape"), shape));
+	EXPECT_FALSE(parser.ErrorsOccurred()) << parser.GetJsonErrorSummary(true);
+	EXPECT_EQ(shape.Name, "s");
+	EXPECT_EQ(shape.Center.X, 1.0f);
+	// missing optional members are not changed
+	EXPECT_EQ(shape.Center.Label, "old");
+	EXPECT_EQ(shape.Tags, std::vector<std::string>{ "old" });
+	ASSERT_EQ(shape.Points.size(), 1u);
+	EXPECT_EQ(shape.Points[0].X, 4.0f);
+	EXPECT_EQ(shape.Points[0].Y, 3.0f);
+	EXPECT_TRUE(shape.Points[0].Label.empty());
+
+	// missing required members
+	parser.Parse(R"({ "shape": { "name": "s", "center": {} } })");
+	EXPECT_FALSE(ReadJsonObject(parser, parser.GetRootElement("shape"), shape));
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"center: Missing member x\n"
+		"center: Missing member y\n"
+		"Missing member visible\n"
+		"Missing member layer\n"
+		"Missing member area\n"
+		"Missing member points\n"
+		"Missing member grid\n"
+		"Missing member paths\n");
+}
+
+
+// Wrong types are reported with the path of the member
+TEST(JsonMappingTest, WrongTypes)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "scene": {
+		"shapes": [ {
+			"name": 5, "visible": true, "layer": 1.5, "area": 2,
+			"points": [ { "x": 1, "y": "a" } ],
+			"grid": [ [ 1, 2 ], [ 3, "x" ] ],
+			"paths": [ [ { "x": 0 } ] ],
+			"center": 3
+			} ],
+		"weights": [ 1, "w" ]
+		} })");
+	Scene scene;
+	parser.StartContext("scene");
+	EXPECT_FALSE(ReadJsonObject(parser, parser.GetRootElement("scene"), scene));
+	parser.EndContext();
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"scene/shapes/0: Wrong type for name\n"
+		"scene/shapes/0: Wrong type for layer\n"
+		"scene/shapes/0/points/0: Wrong type for y\n"
+		"scene/shapes/0/grid/1/1: Wrong type for grid\n"
+		"scene/shapes/0/paths/0/0: Missing member y\n"
+		"scene/shapes/0/center: Not an object\n"
+		"scene: Wrong type for weights/1\n");
+	EXPECT_THROW(parser.CheckJsonErrors(), ContentException);
+
+	// valid values are read anyway
+	ASSERT_EQ(scene.Shapes.size(), 1u);
+	EXPECT_TRUE(scene.Shapes[0].Visible);
+	EXPECT_EQ(scene.Shapes[0].Area, 2.0);
+	EXPECT_EQ(scene.Shapes[0].Grid, (std::vector<std::vector<int>>{ { 1, 2 }, { 3, 0 } }));
+	EXPECT_EQ(scene.Weights, (std::vector<double>{ 1.0, 0.0 }));
+}
+
+
+// The context is restored when the error limit stops the reading
+TEST(JsonMappingTest, MaxErrors)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "scene": {
+		"shapes": [ { "name": "s", "visible": true, "layer": 1, "area": 2, "grid": [], "paths": [],
+			"points": [ { "x": 1, "y": "a" }, { "x": "b", "y": 2 } ] } ],
+		"weights": [ "w" ]
+		} })");
+	Scene scene;
+	parser.SetMaxErrors(2);
+	parser.StartContext("scene");
+	EXPECT_THROW(ReadJsonObject(parser, parser.GetRootElement("scene"), scene), ContentException);
+	EXPECT_EQ(parser.GetErrorCount(), 2u);
+
+	// the context started by the caller is kept
+	parser.SetMaxErrors(0);
+	EXPECT_FALSE(parser.CheckIsArray(parser.GetRootElement("scene")));
+	parser.EndContext();
+	EXPECT_FALSE(ReadJsonObject(parser, parser.GetRootElement("scene"), scene));
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"scene/shapes/0/points/0: Wrong type for y\n"
+		"scene/shapes/0/points/1: Wrong type for x\n"
+		"scene: Not an array\n"
+		"shapes/0/points/0: Wrong type for y\n"
+		"shapes/0/points/1: Wrong type for x\n"
+		"shapes/0: Missing member center\n"
+		"Wrong type for weights/0\n");
+}
+
+
+// A name repeated in a mapping is a programming error
+TEST(JsonMappingTest, RepeatedField)
+{
+	const char* names[] = { "x", "y", "x" };
+	EXPECT_THROW(JsonFieldIndex(names, 3), FormatException);
+
+	RapidJsonParser parser;
+	parser.Parse(R"({ "repeated": { "a": 1 } })");
+	Repeated repeated;
+	EXPECT_THROW(ReadJsonObject(parser, parser.GetRootElement("repeated"), repeated), FormatException);
+}
+
+
+// Lookups in the index of field names
+TEST(JsonMappingTest, FieldIndex)
+{
+	const char* names[] = { "x", "y", "label", "lab", "" };
+	JsonFieldIndex index(names, 5);
+	for (size_t i = 0; i < 5; i++)
+	{
+		EXPECT_EQ(index.Find(names[i], std::strlen(names[i])), i);
+	}
+	EXPECT_EQ(index.Find("z", 1), JsonFieldIndex::NOT_FOUND);
+	EXPECT_EQ(index.Find("labe", 4), JsonFieldIndex::NOT_FOUND);
+	EXPECT_EQ(index.Find("labels", 6), JsonFieldIndex::NOT_FOUND);
+	EXPECT_EQ(index.Find("X", 1), JsonFieldIndex::NOT_FOUND);
+	// the length is compared, not the null terminator
+	EXPECT_EQ(index.Find("label", 3), 3u);
+	EXPECT_EQ(index.Find("xyz", 1), 0u);
+
+	// many names, each in its own slot
+	std::vector<std::string> strings;
+	for (int i = 0; i < 200; i++)
+	{
+		strings.push_back("field" + std::to_string(i));
+	}
+	std::vector<const char*> manyNames;
+	for (const std::string& str : strings)
+	{
+		manyNames.push_back(str.c_str());
+	}
+	JsonFieldIndex manyIndex(manyNames.data(), manyNames.size());
+	for (size_t i = 0; i < strings.size(); i++)
+	{
+		EXPECT_EQ(manyIndex.Find(strings[i].data(), strings[i].size()), i);
+		const std::string other = strings[i] + "_";
+		EXPECT_EQ(manyIndex.Find(other.data(), other.size()), JsonFieldIndex::NOT_FOUND);
+	}
+
+	// an empty index finds nothing
+	JsonFieldIndex emptyIndex(nullptr, 0);
+	EXPECT_EQ(emptyIndex.Find("x", 1), JsonFieldIndex::NOT_FOUND);
+}
@@ -0,0 +1,194 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// JsonValidator_test.cpp
+
+#include <string>
+
+#include <gpvulc/json/JsonValidator.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	const char* SPECIFICATION = R"({
+		"type": "object",
+		"required": [ "name", "size", "shape" ],
+		"properties": {
+			"name": { "type": "string", "minLength": 1, "maxLength": 8 },
+			"size": { "type": "integer", "minimum": 0, "maximum": 1000 },
+			"scale": { "type": "number", "minimum": -1, "maximum": 1 },
+			"shape": {
+				"type": "object",
+				"required": [ "kind", "points" ],
+				"properties": {
+					"kind": { "type": "string" },
+					"points": { "type": "array", "minItems": 2, "maxItems": 4, "items": { "type": "array", "items": { "type": "number" } } },
+					"closed": { "type": "boolean" }
+				}
+			},
+			"tags": { "type": "array", "items": { "type": "string" } },
+			"extra": { "type": "null" }
+		}
+	})";
+
+
+	// Validate the text both on the DOM and in streaming mode, expecting the same errors, and return the error summary
+	std::string Validate(const JsonValidator& validator, const std::string& jsonText)
+	{
+		RapidJsonParser domParser;
+		domParser.Parse(jsonText);
+		const bool domValid = validator.Validate(domParser);
+		const std::string domErrors = domParser.GetJsonErrorSummary(true);
+
+		RapidJsonParser streamParser;
+		const bool streamValid = validator.ValidateStream(streamParser, jsonText.data(), jsonText.size());
+		const std::string streamErrors = streamParser.GetJsonErrorSummary(true);
+
+		EXPECT_EQ(domErrors, streamErrors) << jsonText;
+		EXPECT_EQ(domValid, streamValid) << jsonText;
+		EXPECT_EQ(domValid, domErrors.empty()) << jsonText;
+		EXPECT_EQ(domParser.GetErrorCount(), streamParser.GetErrorCount()) << jsonText;
+		return domErrors;
+	}
+}
+
+
+// Valid documents and skipped members not listed in the specification
+TEST(JsonValidatorTest, ValidAndUnknownMembers)
+{
+	JsonValidator validator(SPECIFICATION);
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 3, "scale": 0.5, "shape": { "kind": "k", "points": [ [ 0, 1 ], [ 2.5, 3 ] ] }, "tags": [], "extra": null })"), "");
+
+	// unknown members are not checked, even if they contain names of the specification
+	EXPECT_EQ(Validate(validator, R"({ "zzz": { "name": 1, "size": [ { "shape": [] } ] }, "name": "ok", "size": 1,)"
+		R"( "shape": { "kind": "k", "points": [ [], [] ], "other": [ { "kind": 1, "points": "x" } ] }, "more": [ 1, [ 2, { "size": "x" } ] ] })"), "");
+
+	// escaped member names
+	EXPECT_EQ(Validate(validator, R"({ "na\u006De": "a", "\u0073ize": 3, "shape": { "kind": "k", "p\u006Fints": [ [], [] ] } })"), "");
+
+	// a validator without specification accepts anything
+	JsonValidator emptyValidator;
+	EXPECT_EQ(Validate(emptyValidator, R"([ 1, { "a": null } ])"), "");
+}
+
+
+// Missing required members at root and nested level
+TEST(JsonValidatorTest, RequiredMembers)
+{
+	JsonValidator validator(SPECIFICATION);
+	EXPECT_EQ(Validate(validator, R"({ "name": "a" })"), "Missing root element size\nMissing root element shape\n");
+	EXPECT_EQ(Validate(validator, R"({})"), "Missing root element name\nMissing root element size\nMissing root element shape\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1, "shape": { "closed": true } })"),
+		"shape: Missing member kind\nshape: Missing member points\n");
+	EXPECT_EQ(Validate(validator, R"({ "shape": { "points": [ [], [] ], "unknown": { "kind": "k" } }, "size": 1 })"),
+		"shape: Missing member kind\nMissing root element name\n");
+
+	// the root and the nested objects of wrong type
+	EXPECT_EQ(Validate(validator, R"([ 1, 2 ])"), "Not an object\n");
+	EXPECT_EQ(Validate(validator, R"("text")"), "Not an object\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1, "shape": [ { "kind": "k" } ] })"), "shape: Not an object\n");
+}
+
+
+// Integers and numbers, minimum and maximum
+TEST(JsonValidatorTest, Numbers)
+{
+	JsonValidator validator(SPECIFICATION);
+	const std::string shape = R"("shape": { "kind": "k", "points": [ [], [] ] })";
+
+	// integers are accepted as numbers, numbers with a fraction or exponent are not integers
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1000, "scale": 1, )" + shape + " }"), "");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 0, "scale": -1.0, )" + shape + " }"), "");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1.5, )" + shape + " }"), "Wrong type for size\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 2.0, )" + shape + " }"), "Wrong type for size\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1e2, )" + shape + " }"), "Wrong type for size\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": "1", "scale": true, )" + shape + " }"),
+		"Wrong type for size\nWrong type for scale\n");
+
+	// out of range, including unsigned and 64 bit integers
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": -1, "scale": 1.5, )" + shape + " }"),
+		"Invalid value for size\nInvalid value for scale\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1001, "scale": -2, )" + shape + " }"),
+		"Invalid value for size\nInvalid value for scale\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 4294967295, )" + shape + " }"), "Invalid value for size\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": -9223372036854775808, )" + shape + " }"), "Invalid value for size\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 18446744073709551615, )" + shape + " }"), "Invalid value for size\n");
+
+	// a repeated member is checked each time
+	EXPECT_EQ(Validate(validator, R"({ "name": "a", "size": 1, "size": "x", )" + shape + " }"), "Wrong type for size\n");
+}
+
+
+// Arrays, their size and items, strings length and the other types
+TEST(JsonValidatorTest, ArraysAndItems)
+{
+	JsonValidator validator(SPECIFICATION);
+	const std::string root = R"("name": "a", "size": 1, )";
+
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": [ [ 0 ], [ 1, 2, 3 ], [], [ 4.5 ] ] } })"), "");
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": [ [ 0 ] ] } })"),
+		"shape: Invalid value for points\n");
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": [ [], [], [], [], [] ] } })"),
+		"shape: Invalid value for points\n");
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": {} } })"),
+		"shape/points: Not an array\n");
+
+	// the errors of the elements come before the size error of their array
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": [ [ 0, "x", 1 ] ] } })"),
+		"shape/points/0: Wrong type for 1\nshape: Invalid value for points\n");
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": "k", "points": [ [], 5, { "x": 1 }, [ null, [] ] ] } })"),
+		"shape/points/1: Not an array\nshape/points/2: Not an array\nshape/points/3: Wrong type for 0\nshape/points/3: Wrong type for 1\n");
+	EXPECT_EQ(Validate(validator, "{ " + root + R"("shape": { "kind": 1, "points": [ [], [] ], "closed": "no" }, "tags": [ "a", 1, null, "b" ], "extra": 0 })"),
+		"shape: Wrong type for kind\nshape: Wrong type for closed\ntags: Wrong type for 1\ntags: Wrong type for 2\nWrong type for extra\n");
+
+	// string length in bytes
+	const std::string shape = R"(, "size": 1, "shape": { "kind": "k", "points": [ [], [] ] } })";
+	EXPECT_EQ(Validate(validator, R"({ "name": "12345678")" + shape), "");
+	EXPECT_EQ(Validate(validator, R"({ "name": "")" + shape), "Invalid value for name\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": "123456789")" + shape), "Invalid value for name\n");
+	EXPECT_EQ(Validate(validator, R"({ "name": ")" + std::string("\xC3\xA8\xC3\xA8\xC3\xA8\xC3\xA8\xC3\xA8") + "\"" + shape), "Invalid value for name\n");
+}
+
+
+
+// The context is restored when the error limit stops the validation
+TEST(JsonValidatorTest, MaxErrors)
+{
+	JsonValidator validator(SPECIFICATION);
+	const std::string jsonText = R"({ "name": "a", "size": 1, "shape": { "kind": 1, "points": [ [ "x" ], [] ], "closed": 0 }, "tags": [ 2 ] })";
+	const std::string errors = "shape: Wrong type for kind\nshape/points/0: Wrong type for 0\nshape: Wrong type for closed\ntags: Wrong type for 0\n";
+	EXPECT_EQ(Validate(validator, jsonText), errors);
+
+	for (bool stream : { false, true })
+	{
+		RapidJsonParser parser;
+		parser.Parse(jsonText);
+		parser.SetMaxErrors(2);
+		if (stream)
+		{
+			EXPECT_THROW(validator.ValidateStream(parser, jsonText.data(), jsonText.size()), ContentException);
+		}
+		else
+		{
+			EXPECT_THROW(validator.Validate(parser), ContentException);
+		}
+		EXPECT_EQ(parser.GetErrorCount(), 2u);
+
+		// the errors of a new validation have the same paths
+		parser.SetMaxErrors(0);
+		EXPECT_FALSE(stream ? validator.ValidateStream(parser, jsonText.data(), jsonText.size()) : validator.Validate(parser));
+		EXPECT_EQ(parser.GetJsonErrorSummary(true), "shape: Wrong type for kind\nshape/points/0: Wrong type for 0\n" + errors);
+	}
+}
@@ -0,0 +1,457 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// RapidJsonParser_test.cpp
+
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gpvulc/json/RapidJsonParser.h>
+#include <gpvulc/json/RapidJsonWriter.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+
+// Integers of any size in streaming mode: rapidjson reports them as int, unsigned, int64 or uint64
+TEST(RapidJsonParserTest, ParseStreamIntegers)
+{
+	const std::string jsonText = R"({
+		"positive": 5, "negative": -7, "max": 2147483647, "min": -2147483648,
+		"unsigned": 3000000000, "large": 4294967296, "negativeLarge": -4294967296, "huge": 18446744073709551615,
+		"values": [ 0, 1, -1, 2147483648 ],
+		"ratio": 3, "number": 4294967296, "unhandled": 12345678901234
+		})";
+
+	RapidJsonParser parser;
+	std::vector<int> ints;
+	std::vector<int> elements;
+	float ratio = 0.0f;
+	double number = 0.0;
+	auto addInt = [&ints](int value) { ints.push_back(value); };
+	for (const char* path : { "positive", "negative", "max", "min", "unsigned", "large", "negativeLarge", "huge" })
+	{
+		parser.AddIntHandler(path, addInt);
+	}
+	parser.AddIntHandler("values/*", [&elements](int value) { elements.push_back(value); });
+	parser.AddFloatHandler("ratio", [&ratio](float value) { ratio = value; });
+	parser.AddDoubleHandler("number", [&number](double value) { number = value; });
+	parser.ParseStream(jsonText.data(), jsonText.size());
+
+	// integers handlers are called for values in the int range
+	EXPECT_EQ(ints, (std::vector<int>{ 5, -7, INT_MAX, INT_MIN }));
+	EXPECT_EQ(elements, (std::vector<int>{ 0, 1, -1 }));
+	// floating point handlers accept integers
+	EXPECT_EQ(ratio, 3.0f);
+	EXPECT_EQ(number, 4294967296.0);
+
+	// the other integers are invalid values, not wrong types
+	EXPECT_EQ(parser.GetErrorCount(), 5u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"Invalid value for unsigned\n"
+		"Invalid value for large\n"
+		"Invalid value for negativeLarge\n"
+		"Invalid value for huge\n"
+		"values: Invalid value for 3\n");
+	EXPECT_THROW(parser.CheckJsonErrors(), ContentException);
+
+	// a string is still a wrong type
+	parser.Reset();
+	parser.ClearHandlers();
+	parser.AddIntHandler("count", addInt);
+	ints.clear();
+	const std::string countText = R"({ "count": "5" })";
+	parser.ParseStream(countText.data(), countText.size());
+	EXPECT_TRUE(ints.empty());
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true), "Wrong type for count\n");
+}
+
+
+// Parsing in place: strings are decoded in the given buffer
+TEST(RapidJsonParserTest, ParseInsitu)
+{
+	const std::string jsonText = R"({ "name": "a\"b\u00e8\n", "count": 3, "empty": "", "list": [ "x", "y" ] })";
+	std::vector<char> buffer(jsonText.begin(), jsonText.end());
+	buffer.push_back('\0');
+
+	RapidJsonParser parser;
+	parser.ParseInsitu(buffer.data());
+	const rapidjson::Value& name = parser.GetRootElement("name");
+	EXPECT_EQ(std::string(name.GetString(), name.GetStringLength()), "a\"b\xc3\xa8\n");
+	EXPECT_EQ(parser.GetInt(parser.GetRootElement("count")), 3);
+	EXPECT_STREQ(parser.GetString(parser.GetRootElement("empty")), "");
+	EXPECT_STREQ(parser.GetRootElement("list")[1].GetString(), "y");
+	EXPECT_FALSE(parser.ErrorsOccurred());
+
+	// the strings are not copied
+	const char* begin = buffer.data();
+	const char* end = buffer.data() + buffer.size();
+	EXPECT_TRUE(name.GetString() >= begin && name.GetString() < end);
+	EXPECT_TRUE(parser.GetRootElement("list")[0].GetString() >= begin);
+
+	// a new document replaces the previous one
+	char other[] = "{ \"count\": 4 }";
+	parser.ParseInsitu(other);
+	EXPECT_EQ(parser.GetInt(parser.GetRootElement("count")), 4);
+	EXPECT_FALSE(parser.HasRootElement("name"));
+
+	char invalid[] = "{ \"count\": }";
+	EXPECT_THROW(parser.ParseInsitu(invalid), ParseException);
+}
+
+
+// Parsing a file mapped in memory, the file is not changed
+TEST(RapidJsonParserTest, ParseFile)
+{
+	const char* const fileName = "gpvulc_json_parse_test.json";
+	const std::string jsonText = "{ \"name\": \"tab\\there\", \"values\": [ 1.5, 2 ],\r\n \"nested\": { \"flag\": true } }\n";
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file << jsonText;
+	}
+
+	RapidJsonParser parser;
+	ASSERT_TRUE(parser.ParseFile(fileName));
+	EXPECT_STREQ(parser.GetString(parser.GetRootElement("name")), "tab\there");
+	std::vector<double> values;
+	EXPECT_TRUE(parser.GetAsArray(parser.GetRootElement("nested"), "missing", values, true));
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("values"), values));
+	EXPECT_EQ(values, (std::vector<double>{ 1.5, 2.0 }));
+	EXPECT_TRUE(parser.GetAsBool(parser.GetRootElement("nested"), "flag"));
+	EXPECT_FALSE(parser.ErrorsOccurred());
+
+	// the strings are decoded in a private copy of the file
+	{
+		std::ifstream file(fileName, std::ios::binary);
+		const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		EXPECT_EQ(content, jsonText);
+	}
+
+	// the same file can be parsed again, a missing file is reported
+	ASSERT_TRUE(parser.ParseFile(fileName));
+	EXPECT_STREQ(parser.GetString(parser.GetRootElement("name")), "tab\there");
+	EXPECT_FALSE(parser.ParseFile("missing_file.json"));
+	EXPECT_FALSE(parser.HasRootElement("name"));
+	parser.Reset();
+
+	{
+		std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		file << "{ \"name\": ";
+	}
+	EXPECT_THROW(parser.ParseFile(fileName), ParseException);
+	parser.Reset();
+	std::remove(fileName);
+}
+
+
+// Numeric arrays read in a single pass, with a single error for each array
+TEST(RapidJsonParserTest, GetArray)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "ints": [ 1, -2, 3 ], "mixed": [ 1, 2.5, "x", 4 ], "empty": [] })");
+
+	std::vector<int> ints;
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("ints"), ints, "ints"));
+	EXPECT_EQ(ints, (std::vector<int>{ 1, -2, 3 }));
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("empty"), ints, "empty"));
+	EXPECT_TRUE(ints.empty());
+	EXPECT_FALSE(parser.ErrorsOccurred());
+
+	// invalid elements are set to 0, the first one is reported
+	EXPECT_FALSE(parser.GetArray(parser.GetRootElement("mixed"), ints, "mixed"));
+	EXPECT_EQ(ints, (std::vector<int>{ 1, 0, 0, 4 }));
+	std::vector<float> floats;
+	EXPECT_FALSE(parser.GetArray(parser.GetRootElement("mixed"), floats, "mixed"));
+	EXPECT_EQ(floats, (std::vector<float>{ 1.0f, 2.5f, 0.0f, 4.0f }));
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true), "Wrong type for mixed/1\nWrong type for mixed/2\n");
+
+	// not an array
+	parser.Reset();
+	parser.Parse(R"({ "object": { "a": 1 } })");
+	std::vector<double> doubles = { 1.0 };
+	EXPECT_FALSE(parser.GetArray(parser.GetRootElement("object"), doubles, "object"));
+	EXPECT_TRUE(doubles.empty());
+	EXPECT_EQ(parser.GetErrorCount(), 1u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true), "object: Not an array\n");
+	parser.Reset();
+	parser.Parse(R"({ "object": { "a": 1 } })");
+	EXPECT_FALSE(parser.GetArray(parser.GetRootElement("object"), doubles));
+	int objectBuffer[2] = { 0, 0 };
+	EXPECT_EQ(parser.GetArray(parser.GetRootElement("object"), objectBuffer, 2, "values"), 0u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true), "Not an array\nvalues: Not an array\n");
+
+	// into a buffer: only the first elements are stored, the array size is returned
+	parser.Reset();
+	parser.Parse(R"({ "values": [ 1, 2, 3, 4, 5 ] })");
+	int buffer[3] = { 0, 0, 0 };
+	EXPECT_EQ(parser.GetArray(parser.GetRootElement("values"), buffer, 3), 5u);
+	EXPECT_EQ(buffer[0], 1);
+	EXPECT_EQ(buffer[2], 3);
+	double doubleBuffer[8] = {};
+	EXPECT_EQ(parser.GetArray(parser.GetRootElement("values"), doubleBuffer, 8), 5u);
+	EXPECT_EQ(doubleBuffer[4], 5.0);
+	EXPECT_EQ(doubleBuffer[5], 0.0);
+	EXPECT_FALSE(parser.ErrorsOccurred());
+}
+
+
+// Numeric arrays read as members of an object
+TEST(RapidJsonParserTest, GetAsArray)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "data": { "floats": [ 0.5, 2 ], "doubles": [ 1e-10, 3 ], "ints": [ 7 ], "bad": [ true ], "number": 1 } })");
+	const rapidjson::Value& data = parser.GetRootElement("data");
+
+	std::vector<float> floats;
+	std::vector<double> doubles;
+	std::vector<int> ints;
+	EXPECT_TRUE(parser.GetAsArray(data, "floats", floats));
+	EXPECT_EQ(floats, (std::vector<float>{ 0.5f, 2.0f }));
+	EXPECT_TRUE(parser.GetAsArray(data, "doubles", doubles));
+	EXPECT_EQ(doubles, (std::vector<double>{ 1e-10, 3.0 }));
+	EXPECT_TRUE(parser.GetAsArray(data, "ints", ints));
+	EXPECT_EQ(ints, std::vector<int>{ 7 });
+	// floating point values are not integers
+	EXPECT_FALSE(parser.GetAsArray(data, "floats", ints));
+	EXPECT_TRUE(parser.ErrorsOccurred());
+	parser.Reset();
+
+	parser.Parse(R"({ "data": { "bad": [ true ], "number": 1 } })");
+	const rapidjson::Value& other = parser.GetRootElement("data");
+	// optional missing members clear the values without errors
+	ints = { 1, 2 };
+	EXPECT_TRUE(parser.GetAsArray(other, "missing", ints, true));
+	EXPECT_TRUE(ints.empty());
+	EXPECT_FALSE(parser.ErrorsOccurred());
+	EXPECT_FALSE(parser.GetAsArray(other, "missing", ints));
+	EXPECT_FALSE(parser.GetAsArray(other, "bad", floats));
+	EXPECT_EQ(floats, std::vector<float>{ 0.0f });
+	EXPECT_FALSE(parser.GetAsArray(other, "number", doubles));
+	EXPECT_FALSE(parser.GetAsArray(other["bad"], "x", doubles));
+	EXPECT_EQ(parser.GetErrorCount(), 4u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"Missing member missing\nWrong type for bad/0\nnumber: Not an array\nNot an object\n");
+
+	// the context of the member is closed after the error
+	parser.StartContext("data");
+	EXPECT_FALSE(parser.GetAsArray(other, "number", ints));
+	parser.EndContext();
+	EXPECT_FALSE(parser.GetAsArray(other, "number", ints));
+	const std::string summary = parser.GetJsonErrorSummary(true);
+	EXPECT_NE(summary.find("\ndata/number: Not an array\nnumber: Not an array\n"), std::string::npos) << summary;
+}
+
+
+// Limit of recorded errors, with and without stopping
+TEST(RapidJsonParserTest, MaxErrors)
+{
+	RapidJsonParser parser;
+	parser.Parse(R"({ "data": { "a": "x", "b": "y", "c": "z", "list": 5 } })");
+	const rapidjson::Value& data = parser.GetRootElement("data");
+
+	// further errors are only counted
+	parser.SetMaxErrors(2, false);
+	for (const char* name : { "a", "b", "c", "missing" })
+	{
+		EXPECT_EQ(parser.GetAsInt(data, name), 0);
+	}
+	EXPECT_TRUE(parser.ErrorsOccurred());
+	EXPECT_EQ(parser.GetErrorCount(), 4u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true), "Wrong type for a\nWrong type for b\n(2 more errors)\n");
+	EXPECT_THROW(parser.CheckJsonErrors(), ContentException);
+	parser.Reset();
+	EXPECT_EQ(parser.GetErrorCount(), 0u);
+	EXPECT_EQ(parser.GetJsonErrorSummary(), nullptr);
+
+	// the exception is thrown when the limit is reached
+	parser.SetMaxErrors(2);
+	parser.Parse(R"({ "data": { "a": "x", "b": "y", "c": "z", "list": 5 } })");
+	const rapidjson::Value& newData = parser.GetRootElement("data");
+	parser.StartContext("data");
+	EXPECT_EQ(parser.GetAsInt(newData, "a"), 0);
+	std::vector<double> values;
+	try
+	{
+		parser.GetAsArray(newData, "list", values);
+		ADD_FAILURE() << "ContentException expected";
+	}
+	catch (const ContentException& e)
+	{
+		EXPECT_STREQ(e.what(), "data: Wrong type for a\ndata/list: Not an array\n");
+	}
+	EXPECT_EQ(parser.GetErrorCount(), 2u);
+
+	// the context started by the parser is closed, the one started by the caller is kept
+	parser.SetMaxErrors(0);
+	EXPECT_EQ(parser.GetAsInt(newData, "b"), 0);
+	parser.EndContext();
+	EXPECT_EQ(parser.GetAsInt(newData, "c"), 0);
+	EXPECT_EQ(parser.GetErrorCount(), 4u);
+	EXPECT_STREQ(parser.GetJsonErrorSummary(true),
+		"data: Wrong type for a\ndata/list: Not an array\ndata: Wrong type for b\nWrong type for c\n");
+}
+
+
+// Numeric arrays written with a single call and read back
+TEST(RapidJsonParserTest, WriteArray)
+{
+	const std::vector<int> ints = { 1, -2, 2147483647 };
+	const std::vector<float> floats = { 0.5f, 2.0f, -0.25f };
+	const std::vector<double> doubles = { 0.125, 3.0, 123456789.125 };
+	const std::vector<int> empty;
+
+	RapidJsonWriter writer;
+	writer.SetCompact(true);
+	std::string jsonText;
+	writer.StartDocument();
+	writer.WriteArray("ints", ints);
+	writer.WriteArray("floats", floats);
+	writer.WriteArray("doubles", doubles);
+	writer.WriteArray("empty", empty);
+	writer.WriteArray("first", ints.data(), 1);
+	writer.StartArray("nested");
+	writer.WriteArray(nullptr, floats.data(), 2);
+	writer.EndArray();
+	writer.EndDocument(jsonText);
+	EXPECT_EQ(jsonText, R"({"ints":[1,-2,2147483647],"floats":[0.5,2.0,-0.25],"doubles":[0.125,3.0,123456789.125],)"
+		R"("empty":[],"first":[1],"nested":[[0.5,2.0]]})");
+
+	RapidJsonParser parser;
+	parser.Parse(jsonText);
+	std::vector<int> readInts;
+	std::vector<float> readFloats;
+	std::vector<double> readDoubles;
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("ints"), readInts));
+	EXPECT_EQ(readInts, ints);
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("floats"), readFloats));
+	EXPECT_EQ(readFloats, floats);
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("doubles"), readDoubles));
+	EXPECT_EQ(readDoubles, doubles);
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("empty"), readInts));
+	EXPECT_TRUE(readInts.empty());
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("nested")[0], readFloats));
+	EXPECT_EQ(readFloats, (std::vector<float>{ 0.5f, 2.0f }));
+
+	// the decimal digits are limited (5 by default)
+	writer.StartDocument();
+	writer.WriteArray("doubles", std::vector<double>{ 1.23456789, 1e-10 });
+	writer.SetDecimalPrecision(2);
+	writer.WriteArray("floats", std::vector<float>{ 1.23456f });
+	writer.EndDocument(jsonText);
+	EXPECT_EQ(jsonText, R"({"doubles":[1.23456,0.0],"floats":[1.23]})");
+	writer.SetDecimalPrecision(5);
+
+	// a large array streamed in chunks
+	std::vector<int> large(100000);
+	for (size_t i = 0; i < large.size(); i++)
+	{
+		large[i] = (int)(i * 7) - 1000;
+	}
+	std::ostringstream stream;
+	writer.StreamTo(stream, 1024);
+	writer.StartDocument();
+	writer.WriteArray("large", large);
+	writer.EndDocument();
+	writer.StopStreaming();
+	parser.Parse(stream.str());
+	EXPECT_TRUE(parser.GetArray(parser.GetRootElement("large"), readInts));
+	EXPECT_EQ(readInts, large);
+}
+
+
+// Member lookups with the index find the same values as the linear search
+TEST(RapidJsonParserTest, IndexedFindMember)
+{
+	std::string jsonText = "{ \"big\": { ";
+	std::vector<std::string> names;
+	for (int i = 0; i < 200; i++)
+	{
+		names.push_back("m" + std::to_string(i));
+		jsonText += "\"" + names.back() + "\": " + std::to_string(i) + ", ";
+	}
+	// a repeated name (the first member is found), an empty name, names with '/' and '~'
+	jsonText += R"("m5": -1, "": "empty", "a/b": "slash", "t~n": "tilde" },)";
+	jsonText += R"( "small": { "x": 1, "y": 2, "x": 3 }, "none": {}, "list": [ { "name": "first" }, { "name": "second" } ], "text": "t" })";
+	names.insert(names.end(), { "", "a/b", "t~n", "x", "y", "name", "m200", "m", "m1000", "M1", "big", "small" });
+
+	RapidJsonParser parser;
+	parser.Parse(jsonText);
+	std::vector<const rapidjson::Value*> objects;
+	for (const char* name : { "big", "small", "none", "list", "text" })
+	{
+		objects.push_back(&parser.GetRootElement(name));
+	}
+	objects.push_back(&parser.GetRootElement("list")[1]);
+
+	// linear search results
+	EXPECT_FALSE(parser.IsIndexing());
+	std::vector<const rapidjson::Value*> expected;
+	for (const rapidjson::Value* object : objects)
+	{
+		for (const std::string& name : names)
+		{
+			expected.push_back(parser.FindMember(*object, name.c_str()));
+		}
+	}
+	EXPECT_EQ(parser.FindMember(*objects[0], "m5")->GetInt(), 5);
+	EXPECT_EQ(parser.FindMember(*objects[1], "x")->GetInt(), 1);
+	const std::vector<const char*> pointers = { "", "/big/m42", "/big/m5", "/big/", "/big/a~1b", "/big/t~0n", "/big/~2",
+		"/small/x", "/list/1/name", "/list/01", "/list/2", "/list/x", "/text/0", "/missing/x", "x" };
+	std::vector<const rapidjson::Value*> expectedValues;
+	for (const char* pointer : pointers)
+	{
+		expectedValues.push_back(parser.FindValue(pointer));
+	}
+	EXPECT_EQ(expectedValues[1]->GetInt(), 42);
+	EXPECT_STREQ(expectedValues[4]->GetString(), "slash");
+
+	// the same results with any size of indexed objects, repeating the lookups
+	for (size_t minIndexedMembers : { (size_t)1, JsonPathIndex::DEFAULT_MIN_INDEXED_MEMBERS, (size_t)1000 })
+	{
+		parser.SetIndexing(true, minIndexedMembers);
+		EXPECT_TRUE(parser.IsIndexing());
+		for (int repeat = 0; repeat < 2; repeat++)
+		{
+			size_t k = 0;
+			for (const rapidjson::Value* object : objects)
+			{
+				for (const std::string& name : names)
+				{
+					ASSERT_EQ(parser.FindMember(*object, name.c_str()), expected[k++]) << name << " (" << minIndexedMembers << ")";
+				}
+			}
+			for (size_t i = 0; i < pointers.size(); i++)
+			{
+				ASSERT_EQ(parser.FindValue(pointers[i]), expectedValues[i]) << pointers[i] << " (" << minIndexedMembers << ")";
+			}
+		}
+		EXPECT_EQ(parser.GetAsInt(*objects[0], "m199"), 199);
+		EXPECT_STREQ(parser.GetAsString(*objects[0], "t~n"), "tilde");
+		EXPECT_EQ(parser.GetAsInt(*objects[0], "m200", true, -5), -5);
+		EXPECT_FALSE(parser.ErrorsOccurred());
+		parser.SetIndexing(false);
+	}
+
+	// the index is cleared for a new document
+	parser.SetIndexing(true, 1);
+	EXPECT_EQ(parser.FindValue("/big/m7")->GetInt(), 7);
+	parser.Parse(R"({ "big": { "m7": "seven", "m8": 8 } })");
+	EXPECT_TRUE(parser.IsIndexing());
+	EXPECT_STREQ(parser.FindValue("/big/m7")->GetString(), "seven");
+	EXPECT_EQ(parser.FindValue("/big/m9"), nullptr);
+	EXPECT_EQ(parser.GetAsInt(parser.GetRootElement("big"), "m8"), 8);
+}
@@ -158,6 +158,27 @@ TEST(PathInfoTest, SetRelativeToPath)
 }
 
 
+// SetRelativeToPath with paths on different devices
+TEST(PathInfoTest, SetRelativeToPathDevice)
+{
+	gpvulc::PathInfo::SetDefaultBackSlash(false);
+
+	gpvulc::PathInfo path1("C:/TEMP/dir/");
+	EXPECT_FALSE(path1.SetRelativeToPath("D:/TEMP/"));
+	EXPECT_EQ(path1.GetPath(), "C:/TEMP/dir/");
+	EXPECT_FALSE(path1.SetRelativeToPath("/TEMP/"));
+	EXPECT_EQ(path1.GetPath(), "C:/TEMP/dir/");
+	EXPECT_TRUE(path1.SetRelativeToPath("C:/TEMP/"));
+	EXPECT_EQ(path1.GetPath(), "dir/");
+
+	gpvulc::PathInfo path2("/TEMP/dir/");
+	EXPECT_FALSE(path2.SetRelativeToPath("C:/TEMP/"));
+	EXPECT_EQ(path2.GetPath(), "/TEMP/dir/");
+	EXPECT_TRUE(path2.SetRelativeToPath("/TEMP/"));
+	EXPECT_EQ(path2.GetPath(), "dir/");
+}
+
+
 // Tests UpperPath
 TEST(PathInfoTest, Upper)
 {
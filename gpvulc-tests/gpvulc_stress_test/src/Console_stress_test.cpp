@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent use of the global message logger
+
+#include "StressTest.h"
+
+#include <gpvulc/console/MessageLogger.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+// the global logger is created once, also if the first calls are concurrent
+TEST(ConsoleStressTest, GetGlobalLogger)
+{
+	const unsigned threadCount = StressThreadCount();
+	std::vector<MessageLogger*> loggers(threadCount);
+
+	RunConcurrently(threadCount, [&](unsigned thread)
+	{
+		loggers[thread] = MessageLogger::GetGlobalLogger().get();
+	});
+
+	ASSERT_NE(loggers[0], nullptr);
+	for (unsigned i = 1; i < threadCount; i++)
+	{
+		EXPECT_EQ(loggers[i], loggers[0]);
+	}
+}
+
+
+// messages are logged by many threads with the global logger, configured in advance
+TEST(ConsoleStressTest, LogMessage)
+{
+	std::atomic<int> messages(0);
+	std::atomic<int> warnings(0);
+	std::shared_ptr<MessageLogger> logger = GetGlobalLogger();
+	logger->DisplayMessage = [&](int severity, const std::string& message, const std::string&, bool, bool, const std::string&)
+	{
+		if (!message.empty())
+		{
+			messages++;
+		}
+		if (severity == LOG_WARNING)
+		{
+			warnings++;
+		}
+	};
+
+	RunConcurrently([](unsigned thread)
+	{
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			LogMessage(i % 2 ? LOG_WARNING : LOG, "message " + std::to_string(i), "thread " + std::to_string(thread));
+		}
+	});
+	logger->DisplayMessage = nullptr;
+
+	EXPECT_EQ(messages.load(), (int)StressThreadCount() * STRESS_ITERATIONS);
+	EXPECT_EQ(warnings.load(), (int)StressThreadCount() * STRESS_ITERATIONS / 2);
+}
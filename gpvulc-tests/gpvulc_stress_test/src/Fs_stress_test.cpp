@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent use of file system functions (one file for each thread)
+
+#include "StressTest.h"
+
+#include <gpvulc/fs/FileUtil.h>
+#include <gpvulc/text/text_util.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+TEST(FsStressTest, FileInfo)
+{
+	const std::string currDir = GetCurrDir();
+	ASSERT_FALSE(currDir.empty());
+
+	RunConcurrently([&](unsigned thread)
+	{
+		const std::string fileName = "gpvulc_stress_" + std::to_string(thread) + ".txt";
+		const std::string text = "thread " + std::to_string(thread) + "\n";
+		ASSERT_TRUE(SaveText(fileName, text));
+		for (int i = 0; i < STRESS_ITERATIONS / 10; i++)
+		{
+			ASSERT_EQ(GetCurrDir(), currDir);
+			FileObject file(fileName);
+			ASSERT_EQ(file.GetSize(), (long long)text.size());
+			DateTime writeTime = file.GetWriteTime();
+			ASSERT_TRUE(writeTime.Year >= 2015);
+		}
+		EXPECT_TRUE(FileDelete(fileName, false));
+	});
+}
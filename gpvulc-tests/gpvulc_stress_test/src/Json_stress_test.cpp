@@ -0,0 +1,100 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent parsing and validation (one parser for each thread, sharing a validator)
+
+#include "StressTest.h"
+
+#include <gpvulc/json/RapidJsonParser.h>
+#include <gpvulc/json/JsonValidator.h>
+
+using namespace gpvulc::json;
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+namespace
+{
+	const char* const ITEMS_SPECIFICATION = R"({
+		"type": "object",
+		"required": [ "items" ],
+		"properties": {
+			"items": {
+				"type": "array",
+				"items": {
+					"type": "object",
+					"required": [ "name", "size" ],
+					"properties": {
+						"name": { "type": "string", "minLength": 1 },
+						"size": { "type": "integer", "minimum": 0, "maximum": 100 }
+					}
+				}
+			}
+		}
+	})";
+
+
+	// Build a document with the given number of items, the last one is invalid if required
+	std::string MakeItems(int count, bool lastInvalid)
+	{
+		std::string text = "{ \"items\": [";
+		for (int i = 0; i < count; i++)
+		{
+			int size = (lastInvalid && i == count - 1) ? 1000 : i % 100;
+			text += (i > 0 ? ", " : " ");
+			text += "{ \"name\": \"item" + std::to_string(i) + "\", \"size\": " + std::to_string(size) + " }";
+		}
+		text += " ] }";
+		return text;
+	}
+
+
+	// Parse and validate a document, returning the error summary
+	std::string ParseAndValidate(const JsonValidator& validator, const std::string& jsonText, int& sizeSum)
+	{
+		RapidJsonParser parser;
+		parser.Parse(jsonText);
+		validator.Validate(parser);
+		const rapidjson::Value& items = parser.GetRootElement("items");
+		sizeSum = 0;
+		for (auto item = items.Begin(); item != items.End(); ++item)
+		{
+			sizeSum += parser.GetAsInt(*item, "size");
+		}
+		return parser.GetJsonErrorSummary(true);
+	}
+}
+
+
+TEST(JsonStressTest, ParseAndValidate)
+{
+	const JsonValidator validator(ITEMS_SPECIFICATION);
+	const std::string validText = MakeItems(64, false);
+	const std::string invalidText = MakeItems(64, true);
+	int expectedValidSum = 0;
+	int expectedInvalidSum = 0;
+	ASSERT_EQ(ParseAndValidate(validator, validText, expectedValidSum), "");
+	const std::string expectedSummary = ParseAndValidate(validator, invalidText, expectedInvalidSum);
+	ASSERT_FALSE(expectedSummary.empty());
+
+	RunConcurrently([&](unsigned)
+	{
+		for (int i = 0; i < STRESS_ITERATIONS / 20; i++)
+		{
+			int sizeSum = 0;
+			ASSERT_EQ(ParseAndValidate(validator, validText, sizeSum), "");
+			ASSERT_EQ(sizeSum, expectedValidSum);
+			ASSERT_EQ(ParseAndValidate(validator, invalidText, sizeSum), expectedSummary);
+			ASSERT_EQ(sizeSum, expectedInvalidSum);
+		}
+	});
+}
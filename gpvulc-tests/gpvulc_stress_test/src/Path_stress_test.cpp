@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent use of paths
+
+#include "StressTest.h"
+
+#include <gpvulc/path/PathInfo.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+// paths are created while the default separator is changed by another thread
+TEST(PathStressTest, DefaultDirSep)
+{
+	RunConcurrently([](unsigned thread)
+	{
+		const std::string name = "file" + std::to_string(thread);
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			if (thread == 0)
+			{
+				PathInfo::SetDefaultBackSlash(i % 2 == 0);
+			}
+			PathInfo path("/root/dir/", name, "ext");
+			ASSERT_TRUE(path.GetDirSep() == '/' || path.GetDirSep() == '\\');
+			path.SetBackSlash(false);
+			ASSERT_EQ(path.GetFullPath(), "/root/dir/" + name + ".ext");
+		}
+	});
+#ifdef _WIN32
+	PathInfo::SetDefaultBackSlash(true);
+#else
+	PathInfo::SetDefaultBackSlash(false);
+#endif
+}
+
+
+// copies of a path are used by other threads
+TEST(PathStressTest, Copies)
+{
+	const PathInfo original("/data/models/scene.obj");
+	// cached values are computed before copying, so copies do not write the original
+	original.GetFullPath();
+	original.GetRootPath();
+
+	RunConcurrently([&](unsigned thread)
+	{
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			PathInfo path(original);
+			path.SetBackSlash(false);
+			ASSERT_TRUE(path.MatchesPattern("*.obj"));
+			path.SetName("scene" + std::to_string(thread));
+			ASSERT_EQ(path.GetFullPath(), "/data/models/scene" + std::to_string(thread) + ".obj");
+			ASSERT_TRUE(path.SetRelativeToPath("/data/"));
+			ASSERT_EQ(path.GetPath(), "models/");
+		}
+	});
+}
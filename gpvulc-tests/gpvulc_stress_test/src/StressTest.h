@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Helpers for the concurrent stress tests
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+
+//! Number of threads used by each test (at least 4, to get interleavings also on small machines)
+inline unsigned StressThreadCount()
+{
+	unsigned count = std::thread::hardware_concurrency();
+	return std::max(4u, std::min(count, 16u));
+}
+
+
+//! Number of iterations run by each thread (kept low enough for ThreadSanitizer builds)
+const int STRESS_ITERATIONS = 2000;
+
+
+/*!
+Run a function in the given number of threads, passing the thread index.
+The threads wait for each other before calling the function, so that they run at the same time.
+*/
+inline void RunConcurrently(unsigned threadCount, const std::function<void(unsigned)>& func)
+{
+	std::atomic<unsigned> ready(0);
+	std::atomic<bool> start(false);
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (unsigned i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back([&, i]()
+		{
+			ready++;
+			while (!start.load())
+			{
+				std::this_thread::yield();
+			}
+			func(i);
+		});
+	}
+	while (ready.load() < threadCount)
+	{
+		std::this_thread::yield();
+	}
+	start = true;
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+
+//! Run a function in StressThreadCount() threads (see RunConcurrently(unsigned, const std::function<void(unsigned)>&)).
+inline void RunConcurrently(const std::function<void(unsigned)>& func)
+{
+	RunConcurrently(StressThreadCount(), func);
+}
@@ -0,0 +1,65 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent use of text buffers and parsers (one for each thread, sharing the source text)
+
+#include "StressTest.h"
+
+#include <gpvulc/text/TextBuffer.h>
+#include <gpvulc/text/TextParser.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+namespace
+{
+	// Build a source text with a known number of tokens (7 for each line)
+	std::string MakeSourceText(int numLines)
+	{
+		std::string text;
+		for (int i = 0; i < numLines; i++)
+		{
+			text += "value" + std::to_string(i) + " = Name , other ; last\n";
+		}
+		return text;
+	}
+}
+
+
+TEST(TextStressTest, ParseSharedSource)
+{
+	const int numLines = 200;
+	const std::string source = MakeSourceText(numLines);
+
+	RunConcurrently([&](unsigned)
+	{
+		for (int i = 0; i < STRESS_ITERATIONS / 100; i++)
+		{
+			TextParser parser(source);
+			int tokens = 0;
+			while (parser.GetToken())
+			{
+				tokens++;
+			}
+			ASSERT_EQ(tokens, numLines * 7);
+
+			TextBuffer text(source);
+			ASSERT_EQ(text.CountLines(), numLines);
+			// the text ends with a new line, the last substring is empty
+			ASSERT_EQ(text.Split('\n').size(), (size_t)numLines + 1);
+			ASSERT_EQ(text.ReplaceAll("name", "NAME", true), numLines);
+			ASSERT_EQ(text.ReplaceAll("NAME", "id"), numLines);
+		}
+	});
+}
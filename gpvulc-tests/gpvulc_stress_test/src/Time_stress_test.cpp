@@ -0,0 +1,133 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Concurrent use of date/time functions
+
+#include "StressTest.h"
+
+#include <gpvulc/time/DateTimeUtil.h>
+#include <gpvulc/time/DateTimeBatch.h>
+#include <gpvulc/time/TimeUtil.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	// A different date/time for each thread and iteration
+	DateTime MakeDateTime(unsigned thread, int iteration)
+	{
+		const long long startMs = 1420070400000LL; // 2015-01-01
+		return EpochMsToDateTime(startMs + thread * 86400000LL * 365 + iteration * 3723001LL, 60);
+	}
+}
+
+
+// results of DateTimeToString() and DateTimeToCString() are not overwritten by other threads
+TEST(TimeStressTest, DateTimeToString)
+{
+	RunConcurrently([](unsigned thread)
+	{
+		std::string expected;
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			DateTime dateTime = MakeDateTime(thread, i);
+			DateTimeFormat(dateTime, expected);
+			const std::string& str = DateTimeToString(dateTime);
+			const char* cstr = DateTimeToCString(dateTime);
+			std::this_thread::yield();
+			ASSERT_EQ(str, expected);
+			ASSERT_STREQ(cstr, expected.c_str());
+			ASSERT_TRUE(StringToDateTime(str) == dateTime);
+		}
+	});
+}
+
+
+// the run time origin is set once, also if the first calls are concurrent
+TEST(TimeStressTest, RunTime)
+{
+	RunConcurrently([](unsigned)
+	{
+		long long last = GetRunTimeMicroseconds();
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			long long now = GetRunTimeMicroseconds();
+			ASSERT_GE(now, last);
+			last = now;
+		}
+		EXPECT_GE(GetRunTimeMilliseconds(), 0);
+	});
+}
+
+
+// the UTC offset cache of each thread is refreshed while another thread invalidates it
+TEST(TimeStressTest, UtcOffsetCache)
+{
+	const long long startMs = 1420070400000LL;
+	const long long stepMs = 3600000LL * 7;
+	std::vector<int> expected(STRESS_ITERATIONS);
+	for (int i = 0; i < STRESS_ITERATIONS; i++)
+	{
+		expected[i] = GetUtcOffsetMinutes(startMs + i * stepMs);
+	}
+
+	RunConcurrently([&](unsigned thread)
+	{
+		for (int i = 0; i < STRESS_ITERATIONS; i++)
+		{
+			if (thread == 0 && i % 100 == 0)
+			{
+				ResetUtcOffsetCache();
+			}
+			// threads walk through the times in different orders
+			int index = (thread % 2) ? i : STRESS_ITERATIONS - 1 - i;
+			ASSERT_EQ(GetUtcOffsetMinutes(startMs + index * stepMs), expected[index]);
+			TimeStamp timeStamp = GetTimeStampNow(i % 2 == 0);
+			ASSERT_GT(timeStamp.GetEpochMs(), startMs);
+		}
+	});
+}
+
+
+// batch conversions (using their own worker threads) called by several threads
+TEST(TimeStressTest, BatchConversion)
+{
+	const size_t count = 4096;
+	std::vector<DateTime> dateTimes(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		dateTimes[i] = MakeDateTime(0, (int)i);
+	}
+	std::vector<TimeStamp> expected(count);
+	DateTimesToTimeStamps(dateTimes.data(), count, expected.data());
+
+	RunConcurrently(4, [&](unsigned)
+	{
+		std::vector<TimeStamp> timeStamps(count);
+		std::vector<DateTime> converted(count);
+		for (int i = 0; i < 10; i++)
+		{
+			DateTimesToTimeStamps(dateTimes.data(), count, timeStamps.data(), 2);
+			TimeStampsToDateTimes(timeStamps.data(), count, converted.data(), 2);
+			for (size_t j = 0; j < count; j++)
+			{
+				ASSERT_TRUE(timeStamps[j] == expected[j]);
+				ASSERT_TRUE(converted[j] == dateTimes[j]);
+			}
+		}
+	});
+}
@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// KeywordSet_test.cpp
+
+#include <string>
+#include <vector>
+
+#include <gpvulc/text/KeywordSet.h>
+#include <gpvulc/text/TextParser.h>
+#include <gpvulc/text/text_util.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+// Keyword lookups
+TEST(KeywordSetTest, Find)
+{
+	const std::vector<std::string> words = { "if", "else", "while", "", "for", "If", "elseif" };
+	KeywordSet keywords(words);
+	EXPECT_EQ(keywords.GetSize(), 7);
+	EXPECT_FALSE(keywords.IsCaseInsensitive());
+	EXPECT_EQ(keywords.Find("if"), 0);
+	EXPECT_EQ(keywords.Find("If"), 5);
+	EXPECT_EQ(keywords.Find("elseif"), 6);
+	EXPECT_EQ(keywords.Find("IF"), -1);
+	EXPECT_EQ(keywords.Find("els"), -1);
+	EXPECT_EQ(keywords.Find(""), -1);
+	EXPECT_TRUE(keywords.Contains("for"));
+	EXPECT_FALSE(keywords.Contains("do"));
+	EXPECT_EQ(keywords.GetKeyword(2), "while");
+
+	// the longest keyword at the beginning of the text
+	const std::string text = "elseif (a)";
+	EXPECT_EQ(keywords.FindPrefix(text.data(), text.size()), 6);
+	EXPECT_EQ(keywords.FindPrefix(text.data(), 5), 1);
+	EXPECT_EQ(keywords.FindPrefix(text.data() + 6, text.size() - 6), -1);
+	EXPECT_TRUE(keywords.IsFirstChar('w'));
+	EXPECT_FALSE(keywords.IsFirstChar('W'));
+
+	// repeated keywords are found with the first identifier
+	keywords.Build(words, true);
+	EXPECT_TRUE(keywords.IsCaseInsensitive());
+	EXPECT_EQ(keywords.Find("IF"), 0);
+	EXPECT_EQ(keywords.Find("If"), 0);
+	EXPECT_EQ(keywords.Find("WHILE"), 2);
+	EXPECT_TRUE(keywords.IsFirstChar('W'));
+
+	keywords.Clear();
+	EXPECT_TRUE(keywords.IsEmpty());
+	EXPECT_EQ(keywords.Find("if"), -1);
+}
+
+
+// Every keyword of a large set is found, other strings are not
+TEST(KeywordSetTest, LargeSet)
+{
+	std::vector<std::string> words;
+	for (int i = 0; i < 500; i++)
+	{
+		words.push_back("keyword_" + std::to_string(i * 7));
+	}
+	for (bool caseInsensitive : { false, true })
+	{
+		KeywordSet keywords(words, caseInsensitive);
+		for (int i = 0; i < (int)words.size(); i++)
+		{
+			EXPECT_EQ(keywords.Find(words[i]), i);
+			EXPECT_EQ(keywords.Find(GetUpperStr(words[i])), caseInsensitive ? i : -1);
+			EXPECT_EQ(keywords.Find(words[i] + "_"), -1);
+			EXPECT_EQ(keywords.Find("keyword_" + std::to_string(i * 7 + 1)), -1);
+		}
+	}
+}
+
+
+// KeywordSet in TextParser
+TEST(KeywordSetTest, TextParser)
+{
+	KeywordSet keywords({ "return", "const", "float" });
+	TextParser parser("int f(float a) { const int b = 2; return a * b; }");
+	EXPECT_FALSE(parser.CompareList(keywords));
+	EXPECT_TRUE(parser.ReachFirstAmong(keywords));
+	EXPECT_EQ(parser.Result(), "int f(");
+	int id = -1;
+	EXPECT_TRUE(parser.CompareList(keywords, id));
+	EXPECT_EQ(id, 2);
+	EXPECT_TRUE(parser.Forward());
+	EXPECT_TRUE(parser.ReachFirstAmong(keywords));
+	EXPECT_EQ(parser.Result(), "loat a) { ");
+	EXPECT_TRUE(parser.CompareList(keywords, id));
+	EXPECT_EQ(id, 1);
+	EXPECT_TRUE(parser.Forward());
+	EXPECT_TRUE(parser.ReachFirstAmong(keywords));
+	EXPECT_TRUE(parser.CompareList(keywords, id));
+	EXPECT_EQ(id, 0);
+	EXPECT_TRUE(parser.Forward());
+	EXPECT_FALSE(parser.ReachFirstAmong(keywords));
+
+	// the same results as with the list of strings
+	const std::vector<std::string> words = { "RETURN", "Const" };
+	KeywordSet caseInsensitiveKeywords(words, true);
+	parser.SetText("x = 1; CONST y = 2; return x;");
+	parser.SetCaseInsensitive(true);
+	EXPECT_TRUE(parser.ReachFirstAmong(words));
+	const std::string skipped = parser.Result();
+	parser.ResetParsing();
+	EXPECT_TRUE(parser.ReachFirstAmong(caseInsensitiveKeywords));
+	EXPECT_EQ(parser.Result(), skipped);
+	EXPECT_EQ(skipped, "x = 1; ");
+	EXPECT_EQ(parser.CompareList(words), parser.CompareList(caseInsensitiveKeywords));
+}
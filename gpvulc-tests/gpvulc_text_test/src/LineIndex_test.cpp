@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// LineIndex_test.cpp
+
+#include <random>
+#include <string>
+
+#include <gpvulc/text/LineIndex.h>
+#include <gpvulc/text/TextParser.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+// Offset and line lookups
+TEST(LineIndexTest, Lookup)
+{
+	const std::string text = "first\n\nthird line\nlast";
+	LineIndex index(text);
+	EXPECT_TRUE(index.IsBuilt());
+	EXPECT_EQ(index.GetLineCount(), TextBuffer(text).CountLines());
+	EXPECT_EQ(index.GetLineCount(), 4);
+	EXPECT_EQ(index.GetLineStart(0), 0);
+	EXPECT_EQ(index.GetLineStart(1), 6);
+	EXPECT_EQ(index.GetLineStart(2), 7);
+	EXPECT_EQ(index.GetLineStart(3), 18);
+	EXPECT_EQ(index.GetLineStart(4), -1);
+	EXPECT_EQ(index.GetLine(0), 0);
+	EXPECT_EQ(index.GetLine(5), 0);
+	EXPECT_EQ(index.GetLine(6), 1);
+	EXPECT_EQ(index.GetLine(17), 2);
+	EXPECT_EQ(index.GetLine((int)text.length()), 3);
+	EXPECT_EQ(index.GetLine((int)text.length() + 1), -1);
+	EXPECT_EQ(index.GetLine(-1), -1);
+	int line = 0;
+	int column = 0;
+	EXPECT_TRUE(index.GetLineAndColumn(12, line, column));
+	EXPECT_EQ(line, 2);
+	EXPECT_EQ(column, 5);
+
+	// a final newline does not start a new line
+	index.Build("a\nb\n");
+	EXPECT_EQ(index.GetLineCount(), 2);
+	EXPECT_EQ(index.GetLine(4), 1);
+
+	index.Build("");
+	EXPECT_EQ(index.GetLineCount(), 0);
+	EXPECT_EQ(index.GetLine(0), 0);
+
+	index.Clear();
+	EXPECT_FALSE(index.IsBuilt());
+	EXPECT_EQ(index.GetLine(0), -1);
+}
+
+
+// Updated index must be equal to the index built from scratch
+TEST(LineIndexTest, Update)
+{
+	std::mt19937 random(7);
+	const std::string pieces[] = { "", "\n", "abc", "x\ny", "\n\n", "line\n" };
+	std::string text = "one\ntwo\nthree\n";
+	LineIndex index(text);
+	for (int i = 0; i < 500; i++)
+	{
+		int offset = (int)(random() % (text.length() + 1));
+		int removed = (int)(random() % (text.length() - offset + 1) % 6);
+		const std::string& inserted = pieces[random() % 6];
+		text.replace(offset, removed, inserted);
+		index.Update(text, offset, removed, (int)inserted.length());
+
+		LineIndex built(text);
+		ASSERT_EQ(index.GetLineCount(), built.GetLineCount());
+		for (int pos = 0; pos <= (int)text.length(); pos++)
+		{
+			ASSERT_EQ(index.GetLine(pos), built.GetLine(pos));
+		}
+	}
+}
+
+
+// Line and column in TextParser
+TEST(LineIndexTest, TextParser)
+{
+	TextParser parser("first line\nsecond line\n");
+	EXPECT_EQ(parser.GetLineCount(), 2);
+	int line = 0;
+	int column = 0;
+	EXPECT_TRUE(parser.GetPosition(line, column));
+	EXPECT_EQ(line, 1);
+	EXPECT_EQ(column, 1);
+	EXPECT_TRUE(parser.GetLine());
+	EXPECT_TRUE(parser.GetToken());
+	EXPECT_EQ(parser.Result(), "second");
+	EXPECT_TRUE(parser.GetPosition(line, column));
+	EXPECT_EQ(line, 2);
+	EXPECT_EQ(column, 8);
+
+	// the index is built again when the text changes
+	parser.SetText("a\nb\nc");
+	EXPECT_EQ(parser.GetLineCount(), 3);
+	EXPECT_TRUE(parser.GetLineAndColumn(4, line, column));
+	EXPECT_EQ(line, 3);
+	EXPECT_EQ(column, 1);
+	EXPECT_FALSE(parser.GetLineAndColumn(10, line, column));
+}
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// LineReader_test.cpp
+
+#include <sstream>
+#include <string>
+
+#include <gpvulc/text/LineReader.h>
+#include <gpvulc/text/TextParser.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+// Read lines
+TEST(LineReaderTest, ReadLine)
+{
+	std::istringstream text("Line 1\n\nLine 3\r\nLine 4");
+	LineReader reader(text);
+	std::string line;
+	EXPECT_TRUE(reader.ReadLine(line));
+	EXPECT_EQ(line, "Line 1");
+	EXPECT_TRUE(reader.NewlineFound());
+	EXPECT_TRUE(reader.ReadLine(line));
+	EXPECT_EQ(line, "");
+	EXPECT_TRUE(reader.ReadLine(line));
+	EXPECT_EQ(line, "Line 3\r");
+	EXPECT_TRUE(reader.ReadLine(line));
+	EXPECT_EQ(line, "Line 4");
+	EXPECT_FALSE(reader.NewlineFound());
+	EXPECT_EQ(reader.GetLineNumber(), (size_t)4);
+	EXPECT_TRUE(reader.Eof());
+	EXPECT_FALSE(reader.ReadLine(line));
+
+	// no empty line is returned after a final newline
+	std::istringstream text2("Line 1\nLine 2\n");
+	LineReader reader2(text2);
+	EXPECT_TRUE(reader2.ReadLine(line));
+	EXPECT_TRUE(reader2.ReadLine(line));
+	EXPECT_EQ(line, "Line 2");
+	EXPECT_FALSE(reader2.ReadLine(line));
+
+	std::istringstream empty;
+	LineReader reader3(empty);
+	EXPECT_FALSE(reader3.ReadLine(line));
+	EXPECT_TRUE(reader3.Eof());
+}
+
+
+// Lines longer than the blocks read from the stream
+TEST(LineReaderTest, SmallBlocks)
+{
+	std::string text;
+	for (int i = 0; i < 100; i++)
+	{
+		text += std::string(i, 'a' + i % 26) + "\n";
+	}
+	for (size_t blockSize : { 1, 3, 7, 64 })
+	{
+		std::istringstream textStream(text);
+		LineReader reader(textStream, blockSize);
+		const char* line = nullptr;
+		size_t length = 0;
+		int lineCount = 0;
+		while (reader.ReadLine(line, length))
+		{
+			EXPECT_EQ(std::string(line, length), std::string(lineCount, 'a' + lineCount % 26));
+			lineCount++;
+		}
+		EXPECT_EQ(lineCount, 100);
+	}
+}
+
+
+// Read lines split with backslash
+TEST(LineReaderTest, ReadSplitLine)
+{
+	const std::string text =
+		"This is \\ \n"
+		"  \ta split line\n"
+		"single line\n"
+		"first\\\n"
+		"second\\\n"
+		"third";
+	for (size_t blockSize : { 2, 5, 1024 })
+	{
+		std::istringstream textStream(text);
+		LineReader reader(textStream, blockSize);
+		std::string line;
+		EXPECT_TRUE(reader.ReadSplitLine(line));
+		EXPECT_EQ(line, "This is a split line");
+		EXPECT_TRUE(reader.ReadSplitLine(line));
+		EXPECT_EQ(line, "single line");
+		EXPECT_TRUE(reader.ReadSplitLine(line, false));
+		EXPECT_EQ(line, "firstsecondthird");
+		EXPECT_EQ(reader.GetLineNumber(), (size_t)6);
+		EXPECT_FALSE(reader.ReadSplitLine(line));
+	}
+}
+
+
+// TextBuffer and TextParser methods with a line reader
+TEST(LineReaderTest, TextBuffer)
+{
+	std::istringstream text("Line 1\nLine 2\nsplit \\\n line");
+	LineReader reader(text, 4);
+	TextBuffer buffer;
+	EXPECT_TRUE(buffer.ReadLine(reader, true));
+	EXPECT_EQ(buffer, "Line 1\n");
+	EXPECT_TRUE(buffer.AppendLine(reader));
+	EXPECT_EQ(buffer, "Line 1\nLine 2");
+	EXPECT_TRUE(buffer.ReadSplitLine(reader, true, true, true));
+	EXPECT_EQ(buffer, "split line\n");
+	EXPECT_FALSE(buffer.ReadLine(reader));
+
+	std::istringstream text2("first line\nsecond line");
+	LineReader reader2(text2);
+	TextParser parser;
+	EXPECT_TRUE(parser.ReadLine(reader2));
+	EXPECT_TRUE(parser.GetToken());
+	EXPECT_EQ(parser.Result(), "first");
+	EXPECT_TRUE(parser.ReadLine(reader2, true));
+	EXPECT_EQ(parser.GetText(), "second line");
+	EXPECT_FALSE(parser.ReadLine(reader2));
+}
@@ -185,6 +185,22 @@ TEST(TextBufferTest, CompareEqual)
 	EXPECT_FALSE(TextBuffer() < (const char*)NULL);
 }
 
+// Tests that comparison results are always -1, 0 or 1.
+TEST(TextBufferTest, CompareSign)
+{
+	TextBuffer txt("abc");
+	EXPECT_EQ(txt.Compare("abz"), -1);
+	EXPECT_EQ(txt.Compare("ab"), 1);
+	EXPECT_EQ(txt.Compare("abcdef"), -1);
+	EXPECT_EQ(txt.Compare("ABC"), 1);
+	EXPECT_EQ(txt.Compare("~"), -1);
+	EXPECT_EQ(txt.Compare("ABZ", true), -1);
+	EXPECT_EQ(txt.Compare("AB", true), 1);
+	EXPECT_EQ(txt.Compare("ABCDEF", true), -1);
+	EXPECT_EQ(TextBuffer("\xff").Compare("a"), 1);
+	EXPECT_EQ(TextBuffer("a").Compare("\xff"), -1);
+}
+
 // Tests conversion to numbers
 TEST(TextBufferTest, GetNum)
 {
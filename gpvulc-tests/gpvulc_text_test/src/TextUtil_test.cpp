@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
 
 #include <gpvulc/text/text_util.h>
@@ -43,3 +44,193 @@ TEST(TextUtilTest, UtilFunc)
 	LoadText("gpvulc_SaveText.txt", loadedStr);
 	EXPECT_EQ(loadedStr, orig_str);
 }
+
+
+// ASCII case folding, compared with the character by character conversion
+TEST(TextUtilTest, AsciiCase)
+{
+	std::string allChars;
+	for (int c = 1; c < 256; c++)
+	{
+		allChars += (char)c;
+	}
+	for (size_t len = 0; len <= allChars.size(); len += (len < 20 ? 1 : 17))
+	{
+		std::string text = allChars.substr(allChars.size() - len);
+		std::string lower = text;
+		std::string upper = text;
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			unsigned char c = (unsigned char)text[i];
+			if (c >= 'A' && c <= 'Z') lower[i] = (char)(c + 32);
+			if (c >= 'a' && c <= 'z') upper[i] = (char)(c - 32);
+		}
+		EXPECT_EQ(GetLowerStr(text), lower);
+		EXPECT_EQ(GetUpperStr(text), upper);
+		std::string inPlace = text;
+		StrUpper(inPlace);
+		EXPECT_EQ(inPlace, upper);
+		StrLower(inPlace);
+		EXPECT_EQ(inPlace, lower);
+		EXPECT_TRUE(StrEqual(lower, upper, true));
+		EXPECT_EQ(AsciiCaseCompare(text.data(), upper.data(), len), 0);
+	}
+	// non ASCII characters (UTF-8) are not changed
+	EXPECT_EQ(GetUpperStr("perch\xc3\xa9 \xc3\x80 perch\xc3\xa9"), "PERCH\xc3\xa9 \xc3\x80 PERCH\xc3\xa9");
+
+	EXPECT_LT(AsciiCaseCompare("ABCDEFGHIJa", "abcdefghijB", 11), 0);
+	EXPECT_GT(AsciiCaseCompare("abcdefghij{", "ABCDEFGHIJA", 11), 0);
+	EXPECT_LT(AsciiCaseCompare("a\x7f", "A\x80", 2), 0);
+	EXPECT_FALSE(StrEqual("abc", "abcd", true));
+	EXPECT_TRUE(StrIsOneOf("Two", { "one", "TWO" }, true));
+
+	const std::string text = "The quick brown fox jumps over the lazy dog, the END.";
+	EXPECT_EQ(AsciiCaseFind(text, "THE"), (size_t)0);
+	EXPECT_EQ(AsciiCaseFind(text, "THE", 1), (size_t)31);
+	EXPECT_EQ(AsciiCaseFind(text, "the end."), text.size() - 8);
+	EXPECT_EQ(AsciiCaseFind(text, ", THE"), (size_t)43);
+	EXPECT_EQ(AsciiCaseFind(text, "cat"), std::string::npos);
+	EXPECT_EQ(AsciiCaseFind(text, "", 5), (size_t)5);
+	EXPECT_EQ(AsciiCaseFind(text, "x", text.size()), std::string::npos);
+	EXPECT_EQ(AsciiCaseRFind(text, "THE"), (size_t)45);
+	EXPECT_EQ(AsciiCaseRFind(text, "THE", 44), (size_t)31);
+	EXPECT_EQ(AsciiCaseRFind(text, "the", 30), (size_t)0);
+	EXPECT_EQ(AsciiCaseRFind(text, "Dog"), (size_t)40);
+	EXPECT_EQ(AsciiCaseRFind(text, "cat"), std::string::npos);
+	EXPECT_EQ(AsciiCaseRFind(text, ""), text.size());
+	for (size_t pos = 0; pos <= text.size(); pos++)
+	{
+		EXPECT_EQ(AsciiCaseFind(text, "o", pos), text.find('o', pos));
+		EXPECT_EQ(AsciiCaseFind(GetUpperStr(text), "e", pos), GetLowerStr(text).find('e', pos));
+		EXPECT_EQ(AsciiCaseRFind(GetUpperStr(text), "e", pos), GetLowerStr(text).rfind('e', pos));
+	}
+}
+
+
+// UTF-16 conversion, text files with byte order mark
+TEST(TextUtilTest, Utf16)
+{
+	// A, euro sign, grinning face (surrogate pair)
+	const std::string text = "A\xe2\x82\xac\xf0\x9f\x98\x80";
+	std::string data;
+	Utf8ToUtf16(text.data(), text.size(), false, data);
+	EXPECT_EQ(data, std::string("A\0\xac\x20\x3d\xd8\x00\xde", 8));
+	data.clear();
+	Utf8ToUtf16(text.data(), text.size(), true, data);
+	EXPECT_EQ(data, std::string("\0A\x20\xac\xd8\x3d\xde\x00", 8));
+	std::string converted;
+	EXPECT_EQ(Utf16ToUtf8(data.data(), data.size(), true, converted), data.size());
+	EXPECT_EQ(converted, text);
+
+	const std::string samples[] = { "", "plain ASCII text, longer than 8 characters", "perch\xc3\xa9 \xc3\xa0 100\xe2\x82\xac",
+		"\xf0\x9f\x98\x80 at the beginning, at the end \xf0\x9f\x98\x80", "\xe4\xb8\xad\xe6\x96\x87 text" };
+	for (const std::string& sample : samples)
+	{
+		for (bool bigEndian : { false, true })
+		{
+			data.clear();
+			converted.clear();
+			Utf8ToUtf16(sample.data(), sample.size(), bigEndian, data);
+			EXPECT_EQ(Utf16ToUtf8(data.data(), data.size(), bigEndian, converted), data.size());
+			EXPECT_EQ(converted, sample);
+		}
+	}
+
+	// unpaired surrogates and invalid UTF-8 bytes are replaced with U+FFFD
+	const std::string replacement = "\xef\xbf\xbd";
+	converted.clear();
+	Utf16ToUtf8("\x00\xd8" "A\x00" "\x00\xdc" "B\x00" "\x00\xd8", 10, false, converted);
+	EXPECT_EQ(converted, replacement + "A" + replacement + "B" + replacement);
+	data.clear();
+	Utf8ToUtf16("\xc0\xaf" "a" "\xed\xa0\x80" "\xe2\x82", 8, false, data);
+	converted.clear();
+	Utf16ToUtf8(data.data(), data.size(), false, converted);
+	EXPECT_EQ(converted, replacement + replacement + "a" + replacement + replacement + replacement + replacement + replacement);
+
+	// incomplete characters at the end of a block are left for the next block
+	converted.clear();
+	EXPECT_EQ(Utf16ToUtf8("A\x00\x3d\xd8", 4, false, converted, false), (size_t)2);
+	EXPECT_EQ(Utf16ToUtf8("A\x00" "B", 3, false, converted, false), (size_t)2);
+	EXPECT_EQ(converted, "AA");
+	EXPECT_EQ(Utf16ToUtf8("B", 1, false, converted), (size_t)1);
+	EXPECT_EQ(converted, "AA" + replacement);
+
+	size_t bomSize = 0;
+	EXPECT_EQ(DetectTextEncoding("\xef\xbb\xbf" "abc", 6, bomSize), TextEncoding::UTF8);
+	EXPECT_EQ(bomSize, (size_t)3);
+	EXPECT_EQ(DetectTextEncoding("\xfe\xff", 2, bomSize), TextEncoding::UTF16BE);
+	EXPECT_EQ(DetectTextEncoding("\xff\xfe", 2, bomSize), TextEncoding::UTF16LE);
+	EXPECT_EQ(DetectTextEncoding("ab", 2, bomSize, TextEncoding::UTF16LE), TextEncoding::UTF16LE);
+	EXPECT_EQ(bomSize, (size_t)0);
+
+	// large text read in blocks, surrogate pairs cross the block boundaries
+	std::string largeText;
+	for (int i = 0; largeText.size() < 300000; i++)
+	{
+		largeText += "line " + std::to_string(i) + (i % 3 ? " \xf0\x9f\x98\x80" : " \xc3\xa8") + "\n";
+	}
+	for (bool bigEndian : { false, true })
+	{
+		for (bool writeBom : { true, false })
+		{
+			std::ostringstream outStream;
+			EXPECT_TRUE(WriteText16(outStream, largeText, bigEndian, writeBom));
+			std::istringstream inStream(outStream.str());
+			std::string loaded = "prefix";
+			EXPECT_TRUE(ReadText16(inStream, loaded, true));
+			EXPECT_EQ(loaded, "prefix" + largeText);
+		}
+	}
+
+	// files
+	EXPECT_TRUE(SaveText("gpvulc_SaveText16.txt", text, false, true));
+	EXPECT_TRUE(SaveText("gpvulc_SaveText16.txt", "\n" + text, true, true));
+	std::string loaded;
+	EXPECT_TRUE(LoadText("gpvulc_SaveText16.txt", loaded));
+	EXPECT_EQ(loaded, text + "\n" + text);
+	std::ifstream rawFile("gpvulc_SaveText16.txt", std::ios::binary);
+	std::string raw((std::istreambuf_iterator<char>(rawFile)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(raw.substr(0, 4), std::string("\xff\xfe" "A\0", 4));
+	EXPECT_EQ(raw.size(), (size_t)(2 + 8 + 2 + 8));
+	EXPECT_TRUE(SaveText("gpvulc_SaveText8.txt", "\xef\xbb\xbf" + text));
+	EXPECT_TRUE(LoadText("gpvulc_SaveText8.txt", loaded, false, true));
+	EXPECT_EQ(loaded, text);
+	EXPECT_FALSE(LoadText("gpvulc_missing_file.txt", loaded, false, true));
+}
+
+// Tests that files are saved back with their encoding
+TEST(TextUtilTest, SaveTextEncoding)
+{
+	const std::string text = "A\xe2\x82\xac\xf0\x9f\x98\x80";
+	const char* path = "gpvulc_SaveTextEncoding.txt";
+	const std::string boms[] = { "\xef\xbb\xbf", "\xff\xfe", "\xfe\xff" };
+	const TextEncoding encodings[] = { TextEncoding::UTF8, TextEncoding::UTF16LE, TextEncoding::UTF16BE };
+	for (int i = 0; i < 3; i++)
+	{
+		for (bool writeBom : { true, false })
+		{
+			EXPECT_TRUE(SaveText(path, text, encodings[i], writeBom));
+			EXPECT_TRUE(SaveText(path, text, encodings[i], writeBom, true));
+			std::ifstream rawFile(path, std::ios::binary);
+			std::string raw((std::istreambuf_iterator<char>(rawFile)), std::istreambuf_iterator<char>());
+			rawFile.close();
+			EXPECT_EQ(raw.compare(0, boms[i].size(), boms[i]) == 0, writeBom);
+
+			std::string loaded;
+			TextEncoding encoding = TextEncoding::UTF8;
+			bool hasBom = !writeBom;
+			EXPECT_TRUE(LoadText(path, loaded, encoding, hasBom, false, i != 0));
+			EXPECT_EQ(loaded, text + text);
+			EXPECT_EQ(encoding, encodings[i]);
+			EXPECT_EQ(hasBom, writeBom);
+
+			// saved again as loaded, the file does not change
+			EXPECT_TRUE(SaveText(path, loaded, encoding, hasBom));
+			rawFile.open(path, std::ios::binary);
+			std::string saved((std::istreambuf_iterator<char>(rawFile)), std::istreambuf_iterator<char>());
+			rawFile.close();
+			EXPECT_EQ(saved, raw);
+		}
+	}
+	std::remove(path);
+}
@@ -0,0 +1,297 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// DateTimeBatch_test.cpp
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gpvulc/time/DateTimeBatch.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	// Parse a string with DateTimeParse(), as ParseTimeStamps() does for the strings not in canonical format
+	DateTimeParseError ParseReference(const std::string& text, TimeStamp& timeStamp)
+	{
+		DateTime dateTime;
+		DateTimeParseError parseError = DateTimeParse(text.data(), text.size(), dateTime);
+		if (parseError == DateTimeParseError::NONE && dateTime.Month == 0)
+		{
+			parseError = DateTimeParseError::OUT_OF_RANGE;
+		}
+		timeStamp = parseError == DateTimeParseError::NONE ? TimeStamp::FromDateTime(dateTime) : TimeStamp();
+		return parseError;
+	}
+
+
+	// More elements than MIN_ITEMS_PER_THREAD (4096) for each of 3 threads
+	const size_t LARGE_COUNT = 3 * 4096 + 17;
+
+
+	// Canonical strings and some strings in other formats or invalid
+	std::vector<std::string> MakeLargeTextList()
+	{
+		std::vector<std::string> texts(LARGE_COUNT);
+		for (size_t i = 0; i < texts.size(); i++)
+		{
+			TimeStamp timeStamp(1600000000000LL + (long long)i * 1000003LL);
+			DateTimeFormat(timeStamp.ToDateTime(), texts[i]);
+			if (i % 1000 == 1)
+			{
+				texts[i] += "Z";
+			}
+			else if (i % 1000 == 2)
+			{
+				texts[i][10] = ' ';
+			}
+			else if (i % 1000 == 3)
+			{
+				texts[i][4] = '/';
+			}
+		}
+		return texts;
+	}
+}
+
+
+// The fixed-width parser gives the same results as DateTimeParse()
+TEST(DateTimeBatchTest, FastPathMatchesDateTimeParse)
+{
+	const std::vector<std::string> texts = {
+		// with and without milliseconds and 'Z'
+		"2021-03-28T02:30:15", "2021-03-28T02:30:15.250", "2021-03-28T02:30:15Z", "2021-03-28T02:30:15.250Z",
+		"1969-12-31T23:59:59.999", "0001-01-01T00:00:00", "9999-12-31T23:59:59.999Z",
+		// February 29 in leap and non-leap years
+		"2020-02-29T12:00:00", "2000-02-29T12:00:00.001Z", "2021-02-29T12:00:00", "1900-02-29T12:00:00Z",
+		// second 60 and other out of range fields
+		"2016-12-31T23:59:60", "2016-12-31T23:59:60.999Z", "2016-12-31T23:59:61",
+		"2021-13-01T00:00:00", "2021-00-01T00:00:00", "2021-01-00T00:00:00", "2021-04-31T00:00:00",
+		"2021-01-01T24:00:00", "2021-01-01T00:60:00",
+		// bad separators and non-digits
+		"2021/01/01T00:00:00", "2021-01-01T00-00-00", "2021-01-01T00:00:00:000", "2021-01-01X00:00:00",
+		"2O21-01-01T00:00:00", "2021-01-0aT00:00:00", "2021-01-01T0 :00:00", "2021-01-01T00:00:0/",
+		"2021-01-01T00:00:00.12a", "2021-01-01T00:00:00.123z", "2021-01-01T00:00:00ZZ", "2021-01-01T00:00:00.123 ",
+		// other formats parsed by DateTimeParse()
+		"2021-01-01 00:00:00", "2021-01-01T00:00:00,500", "2021-01-01T00:00:00.5", "2021-01-01T00:00:00.1234Z",
+		"2021-01-01T00:00", "2021-01-01", "2021-01-01T00:00:00+01:00", "2021-01-01T00:00:00.000UTC-05:30",
+		// time counters
+		"0000-00-00T01:02:03", "0000-00-05T01:02:03.004Z",
+		"", "Z",
+	};
+
+	std::vector<TimeStamp> timeStamps(texts.size());
+	std::vector<DateTimeParseError> errors(texts.size());
+	const size_t parsed = ParseTimeStamps(texts.data(), texts.size(), timeStamps.data(), errors.data());
+	size_t expectedParsed = 0;
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		TimeStamp expected;
+		const DateTimeParseError expectedError = ParseReference(texts[i], expected);
+		EXPECT_EQ(errors[i], expectedError) << texts[i];
+		EXPECT_EQ(timeStamps[i].GetRawValue(), expected.GetRawValue()) << texts[i];
+		expectedParsed += expectedError == DateTimeParseError::NONE;
+	}
+	EXPECT_EQ(parsed, expectedParsed);
+
+	// some explicit results
+	TimeStamp timeStamp;
+	DateTimeParseError parseError = DateTimeParseError::NONE;
+	const std::string leapSecond = "2016-12-31T23:59:60";
+	EXPECT_EQ(ParseTimeStamps(&leapSecond, 1, &timeStamp), 1u);
+	EXPECT_EQ(timeStamp.GetEpochMs(), 1483228800000LL);
+	const std::string nonLeapYear = "2021-02-29T12:00:00";
+	EXPECT_EQ(ParseTimeStamps(&nonLeapYear, 1, &timeStamp, &parseError), 0u);
+	EXPECT_EQ(parseError, DateTimeParseError::OUT_OF_RANGE);
+	EXPECT_EQ(timeStamp.GetRawValue(), TimeStamp().GetRawValue());
+	const std::string counter = "0000-00-00T01:02:03";
+	EXPECT_EQ(ParseTimeStamps(&counter, 1, &timeStamp, &parseError), 0u);
+	EXPECT_EQ(parseError, DateTimeParseError::OUT_OF_RANGE);
+	const std::string badSeparator = "2021/01/01T00:00:00";
+	EXPECT_EQ(ParseTimeStamps(&badSeparator, 1, &timeStamp, &parseError), 0u);
+	EXPECT_EQ(parseError, DateTimeParseError::BAD_DATE);
+}
+
+
+// Fixed-size fields, null terminated if shorter than the stride
+TEST(DateTimeBatchTest, ParseColumn)
+{
+	const size_t stride = 24;
+	const std::vector<std::string> texts = {
+		"2021-03-28T02:30:15.250Z", // exactly the stride, not null terminated
+		"2021-03-28T02:30:15",
+		"2021-03-28T02:30:15.250",
+		"2021-03-28",
+		"2021-02-29T00:00:00",
+		"not a date",
+		"",
+	};
+	std::vector<char> column(texts.size() * stride, 'x');
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		ASSERT_LE(texts[i].size(), stride);
+		std::memcpy(column.data() + i * stride, texts[i].c_str(), std::min(texts[i].size() + 1, stride));
+	}
+
+	std::vector<TimeStamp> timeStamps(texts.size());
+	std::vector<DateTimeParseError> errors(texts.size());
+	EXPECT_EQ(ParseTimeStamps(column.data(), stride, texts.size(), timeStamps.data(), errors.data()), 4u);
+	std::vector<TimeStamp> expected(texts.size());
+	std::vector<DateTimeParseError> expectedErrors(texts.size());
+	EXPECT_EQ(ParseTimeStamps(texts.data(), texts.size(), expected.data(), expectedErrors.data()), 4u);
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		EXPECT_EQ(errors[i], expectedErrors[i]) << texts[i];
+		EXPECT_EQ(timeStamps[i].GetRawValue(), expected[i].GetRawValue()) << texts[i];
+	}
+	EXPECT_EQ(errors[4], DateTimeParseError::OUT_OF_RANGE);
+	EXPECT_EQ(errors[6], DateTimeParseError::EMPTY);
+
+	// characters after the stride are not read
+	column[stride] = 'x';
+	EXPECT_EQ(ParseTimeStamps(column.data(), stride, 1, timeStamps.data(), errors.data()), 1u);
+	EXPECT_EQ(timeStamps[0].GetRawValue(), expected[0].GetRawValue());
+}
+
+
+// Formatting to strings and to fixed-size fields
+TEST(DateTimeBatchTest, Format)
+{
+	const std::vector<TimeStamp> timeStamps = {
+		TimeStamp(0),
+		TimeStamp(1616898615250LL),
+		TimeStamp(1616898615000LL, 60, true),
+		TimeStamp(-1),
+	};
+	std::vector<std::string> texts(timeStamps.size(), "previous content");
+	FormatTimeStamps(timeStamps.data(), timeStamps.size(), texts.data());
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		EXPECT_EQ(texts[i], DateTimeToString(timeStamps[i].ToDateTime()));
+	}
+	EXPECT_EQ(texts[0], "1970-01-01T00:00:00");
+	EXPECT_EQ(texts[1], "2021-03-28T02:30:15.250");
+	EXPECT_EQ(texts[2], "2021-03-28T03:30:15UTC+01:00");
+	EXPECT_EQ(texts[3], "1969-12-31T23:59:59.999");
+
+	// all the strings fit in DATETIME_STRING_MAX
+	std::vector<char> column(timeStamps.size() * DATETIME_STRING_MAX, 'x');
+	EXPECT_EQ(FormatTimeStamps(timeStamps.data(), timeStamps.size(), column.data(), DATETIME_STRING_MAX), timeStamps.size());
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		EXPECT_STREQ(column.data() + i * DATETIME_STRING_MAX, texts[i].c_str());
+	}
+
+	// only the strings without milliseconds and offset fit, the other fields are left empty
+	const size_t stride = 20;
+	column.assign(timeStamps.size() * stride, 'x');
+	EXPECT_EQ(FormatTimeStamps(timeStamps.data(), timeStamps.size(), column.data(), stride), 1u);
+	EXPECT_STREQ(column.data(), texts[0].c_str());
+	for (size_t i = 1; i < texts.size(); i++)
+	{
+		EXPECT_EQ(column[i * stride], '\0');
+	}
+	EXPECT_EQ(FormatTimeStamps(timeStamps.data(), timeStamps.size(), column.data(), 0), 0u);
+
+	// the formatted strings are parsed back
+	std::vector<TimeStamp> parsed(timeStamps.size());
+	EXPECT_EQ(ParseTimeStamps(texts.data(), texts.size(), parsed.data()), timeStamps.size());
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		EXPECT_EQ(parsed[i].GetEpochMs(), timeStamps[i].GetEpochMs()) << texts[i];
+	}
+}
+
+
+// Distances between pairs of time stamps and between adjacent elements
+TEST(DateTimeBatchTest, Distances)
+{
+	const std::vector<TimeStamp> timeStamps = { TimeStamp(1000), TimeStamp(-500, 60), TimeStamp(86400000LL), TimeStamp(86400000LL) };
+	std::vector<long long> distances(timeStamps.size(), -1);
+	TimeStampDistancesMs(timeStamps.data(), timeStamps.data() + 1, 3, distances.data());
+	EXPECT_EQ(distances, (std::vector<long long>{ -1500, 86400500LL, 0, -1 }));
+
+	distances.assign(timeStamps.size(), -1);
+	TimeStampAdjacentDistancesMs(timeStamps.data(), timeStamps.size(), distances.data());
+	EXPECT_EQ(distances, (std::vector<long long>{ -1500, 86400500LL, 0, -1 }));
+
+	std::vector<DateTime> dateTimes(timeStamps.size());
+	TimeStampsToDateTimes(timeStamps.data(), timeStamps.size(), dateTimes.data());
+	distances.assign(timeStamps.size(), -1);
+	DateTimeAdjacentDistancesMs(dateTimes.data(), dateTimes.size(), distances.data());
+	EXPECT_EQ(distances, (std::vector<long long>{ -1500, 86400500LL, 0, -1 }));
+
+	// nothing is written with less than two elements
+	distances.assign(timeStamps.size(), -1);
+	TimeStampAdjacentDistancesMs(timeStamps.data(), 0, distances.data());
+	TimeStampAdjacentDistancesMs(timeStamps.data(), 1, distances.data());
+	DateTimeAdjacentDistancesMs(dateTimes.data(), 0, distances.data());
+	DateTimeAdjacentDistancesMs(dateTimes.data(), 1, distances.data());
+	TimeStampDistancesMs(timeStamps.data(), timeStamps.data() + 1, 0, distances.data());
+	EXPECT_EQ(distances, (std::vector<long long>(timeStamps.size(), -1)));
+}
+
+
+// Large arrays split among threads give the same results as a single thread
+TEST(DateTimeBatchTest, Threads)
+{
+	const std::vector<std::string> texts = MakeLargeTextList();
+	std::vector<TimeStamp> expected(texts.size());
+	std::vector<DateTimeParseError> expectedErrors(texts.size());
+	const size_t expectedParsed = ParseTimeStamps(texts.data(), texts.size(), expected.data(), expectedErrors.data(), 1);
+	EXPECT_EQ(expectedParsed, texts.size() - (texts.size() / 1000 + 1));
+
+	for (unsigned numThreads : { 2u, 3u, 8u, 0u })
+	{
+		std::vector<TimeStamp> timeStamps(texts.size());
+		std::vector<DateTimeParseError> errors(texts.size());
+		EXPECT_EQ(ParseTimeStamps(texts.data(), texts.size(), timeStamps.data(), errors.data(), numThreads), expectedParsed);
+		for (size_t i = 0; i < texts.size(); i++)
+		{
+			ASSERT_EQ(timeStamps[i].GetRawValue(), expected[i].GetRawValue()) << texts[i] << " (" << numThreads << " threads)";
+			ASSERT_EQ(errors[i], expectedErrors[i]) << texts[i];
+		}
+
+		// fixed-size fields
+		std::vector<char> column(texts.size() * DATETIME_STRING_MAX);
+		EXPECT_EQ(FormatTimeStamps(expected.data(), expected.size(), column.data(), DATETIME_STRING_MAX, numThreads), expected.size());
+		std::vector<std::string> formatted(texts.size());
+		FormatTimeStamps(expected.data(), expected.size(), formatted.data(), numThreads);
+		std::vector<TimeStamp> columnTimeStamps(texts.size());
+		EXPECT_EQ(ParseTimeStamps(column.data(), DATETIME_STRING_MAX, texts.size(), columnTimeStamps.data(), nullptr, numThreads), texts.size());
+		for (size_t i = 0; i < texts.size(); i++)
+		{
+			ASSERT_STREQ(column.data() + i * DATETIME_STRING_MAX, formatted[i].c_str());
+			ASSERT_EQ(formatted[i], DateTimeToString(expected[i].ToDateTime()));
+			ASSERT_EQ(columnTimeStamps[i].GetRawValue(), expected[i].GetRawValue()) << formatted[i];
+		}
+
+		// distances
+		std::vector<long long> distances(texts.size(), -1);
+		TimeStampAdjacentDistancesMs(expected.data(), expected.size(), distances.data(), numThreads);
+		std::vector<DateTime> dateTimes(texts.size());
+		TimeStampsToDateTimes(expected.data(), expected.size(), dateTimes.data(), numThreads);
+		std::vector<long long> dateTimeDistances(texts.size(), -1);
+		DateTimeAdjacentDistancesMs(dateTimes.data(), dateTimes.size(), dateTimeDistances.data(), numThreads);
+		for (size_t i = 0; i + 1 < texts.size(); i++)
+		{
+			ASSERT_EQ(distances[i], expected[i + 1] - expected[i]);
+			ASSERT_EQ(dateTimeDistances[i], distances[i]);
+		}
+		EXPECT_EQ(distances.back(), -1);
+		EXPECT_EQ(dateTimeDistances.back(), -1);
+	}
+}
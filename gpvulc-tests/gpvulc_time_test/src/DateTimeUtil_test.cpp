@@ -0,0 +1,378 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// DateTimeUtil_test.cpp
+
+#include <cstring>
+#include <string>
+
+#include <gpvulc/time/DateTimeUtil.h>
+// internal calendar computations (not installed)
+#include "../../../gpvulc/src/time/civil_date.h"
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	DateTimeParseError Parse(const char* text, DateTime& dateTime, size_t* errorPos = nullptr)
+	{
+		return DateTimeParse(text, std::strlen(text), dateTime, errorPos);
+	}
+
+
+	void ExpectDateTime(const DateTime& dateTime, int year, int month, int day, int hour, int minute, int second, int millisecond)
+	{
+		EXPECT_EQ(dateTime.Year, year);
+		EXPECT_EQ(dateTime.Month, month);
+		EXPECT_EQ(dateTime.Day, day);
+		EXPECT_EQ(dateTime.Hour, hour);
+		EXPECT_EQ(dateTime.Minute, minute);
+		EXPECT_EQ(dateTime.Second, second);
+		EXPECT_EQ(dateTime.Millisecond, millisecond);
+	}
+}
+
+
+// Tests leap years and days in each month
+TEST(DateTimeUtilTest, LeapYears)
+{
+	EXPECT_TRUE(civil_date::IsLeapYear(2000));
+	EXPECT_TRUE(civil_date::IsLeapYear(2024));
+	EXPECT_TRUE(civil_date::IsLeapYear(1600));
+	EXPECT_FALSE(civil_date::IsLeapYear(1900));
+	EXPECT_FALSE(civil_date::IsLeapYear(2023));
+	EXPECT_EQ(civil_date::DaysInMonth(2000, 2), 29);
+	EXPECT_EQ(civil_date::DaysInMonth(1900, 2), 28);
+	EXPECT_EQ(civil_date::DaysInMonth(2023, 2), 28);
+	EXPECT_EQ(civil_date::DaysInMonth(2023, 1), 31);
+	EXPECT_EQ(civil_date::DaysInMonth(2023, 4), 30);
+	EXPECT_EQ(civil_date::DaysInMonth(2023, 12), 31);
+
+	DateTime dateTime;
+	EXPECT_EQ(Parse("2000-02-29", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(Parse("2024-02-29T12:00", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(Parse("1900-02-29", dateTime), DateTimeParseError::OUT_OF_RANGE);
+	EXPECT_EQ(Parse("2023-02-29", dateTime), DateTimeParseError::OUT_OF_RANGE);
+	EXPECT_EQ(Parse("2023-04-31", dateTime), DateTimeParseError::OUT_OF_RANGE);
+}
+
+
+// Tests conversions between dates and days since 1970-01-01
+TEST(DateTimeUtilTest, CivilDays)
+{
+	EXPECT_EQ(civil_date::DaysFromCivil(1970, 1, 1), 0);
+	EXPECT_EQ(civil_date::DaysFromCivil(1970, 1, 2), 1);
+	EXPECT_EQ(civil_date::DaysFromCivil(1969, 12, 31), -1);
+	EXPECT_EQ(civil_date::DaysFromCivil(2000, 1, 1), 10957);
+	EXPECT_EQ(civil_date::DaysFromCivil(2000, 3, 1), 11017);
+	EXPECT_EQ(civil_date::DaysFromCivil(1900, 1, 1), -25567);
+	EXPECT_EQ(civil_date::DaysFromCivil(1600, 3, 1), -135080);
+	EXPECT_EQ(civil_date::DaysFromCivil(0, 1, 1), -719528);
+
+	int year = 0;
+	int month = 0;
+	int day = 0;
+	civil_date::CivilFromDays(-1, year, month, day);
+	EXPECT_EQ(year, 1969);
+	EXPECT_EQ(month, 12);
+	EXPECT_EQ(day, 31);
+	civil_date::CivilFromDays(-25567 + 59, year, month, day);
+	EXPECT_EQ(year, 1900);
+	EXPECT_EQ(month, 3);
+	EXPECT_EQ(day, 1);
+
+	// consecutive days, across leap years and before 1970
+	int prevYear = 0;
+	int prevMonth = 0;
+	int prevDay = 0;
+	civil_date::CivilFromDays(-800000, prevYear, prevMonth, prevDay);
+	for (long long days = -799999; days <= 800000; days++)
+	{
+		civil_date::CivilFromDays(days, year, month, day);
+		if (day != prevDay + 1)
+		{
+			ASSERT_EQ(prevDay, civil_date::DaysInMonth(prevYear, prevMonth));
+			ASSERT_EQ(day, 1);
+			ASSERT_EQ(month, prevMonth == 12 ? 1 : prevMonth + 1);
+			ASSERT_EQ(year, prevMonth == 12 ? prevYear + 1 : prevYear);
+		}
+		ASSERT_EQ(civil_date::DaysFromCivil(year, month, day), days);
+		prevYear = year;
+		prevMonth = month;
+		prevDay = day;
+	}
+}
+
+
+// Tests week days (1-based, see WDay)
+TEST(DateTimeUtilTest, WeekDay)
+{
+	EXPECT_EQ(civil_date::WeekDayFromDays(0), THURSDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(3), SUNDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(9), SATURDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(-1), WEDNESDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(-4), SUNDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(-5), SATURDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(civil_date::DaysFromCivil(1900, 1, 1)), MONDAY);
+	EXPECT_EQ(civil_date::WeekDayFromDays(civil_date::DaysFromCivil(2000, 2, 29)), TUESDAY);
+	for (long long days = -1000; days < 1000; days++)
+	{
+		int weekDay = civil_date::WeekDayFromDays(days);
+		ASSERT_GE(weekDay, SUNDAY);
+		ASSERT_LE(weekDay, SATURDAY);
+		ASSERT_EQ(civil_date::WeekDayFromDays(days + 1), weekDay == SATURDAY ? SUNDAY : weekDay + 1);
+	}
+
+	DateTime dateTime;
+	EXPECT_EQ(Parse("2020-02-29", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(dateTime.WeekDay, SATURDAY);
+	EXPECT_EQ(Parse("1969-07-20", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(dateTime.WeekDay, SUNDAY);
+	EXPECT_EQ(EpochMsToDateTime(-1).WeekDay, WEDNESDAY);
+}
+
+
+// Tests formatting
+TEST(DateTimeUtilTest, Format)
+{
+	char buffer[DATETIME_STRING_MAX];
+	DateTime dateTime(2020, 2, 29, 13, 5, 9);
+	EXPECT_EQ(DateTimeFormat(dateTime, buffer, sizeof(buffer)), (size_t)19);
+	EXPECT_STREQ(buffer, "2020-02-29T13:05:09");
+	dateTime.Millisecond = 7;
+	EXPECT_EQ(DateTimeToString(dateTime), "2020-02-29T13:05:09.007");
+	dateTime.TimeOffsetHour = 5;
+	dateTime.TimeOffsetMinute = 30;
+	EXPECT_STREQ(DateTimeToCString(dateTime), "2020-02-29T13:05:09.007UTC+05:30");
+	dateTime.TimeOffsetHour = 0;
+	dateTime.TimeOffsetMinute = -30;
+	EXPECT_EQ(DateTimeToString(dateTime), "2020-02-29T13:05:09.007UTC-00:30");
+	dateTime.TimeOffsetHour = -12;
+	dateTime.TimeOffsetMinute = 0;
+	dateTime.Millisecond = 0;
+	EXPECT_EQ(DateTimeFormat(dateTime, buffer, sizeof(buffer)), (size_t)28);
+	EXPECT_STREQ(buffer, "2020-02-29T13:05:09UTC-12:00");
+	EXPECT_EQ(DateTimeToString(DateTime(1, 1, 1)), "0001-01-01T00:00:00");
+
+	// too small buffer or values that cannot be written
+	EXPECT_EQ(DateTimeFormat(dateTime, buffer, 28), (size_t)0);
+	EXPECT_STREQ(buffer, "");
+	EXPECT_EQ(DateTimeFormat(DateTime(10000, 1, 1), buffer, sizeof(buffer)), (size_t)0);
+	EXPECT_EQ(DateTimeFormat(DateTime(-1, 1, 1), buffer, sizeof(buffer)), (size_t)0);
+	EXPECT_EQ(DateTimeFormat(dateTime, buffer, 0), (size_t)0);
+
+	std::string str = "previous content";
+	DateTimeFormat(DateTime(1969, 12, 31, 23, 59, 59, 999), str);
+	EXPECT_EQ(str, "1969-12-31T23:59:59.999");
+}
+
+
+// Tests parsing
+TEST(DateTimeUtilTest, Parse)
+{
+	DateTime dateTime;
+	EXPECT_EQ(Parse("2020-02-29T13:05:09.123", dateTime), DateTimeParseError::NONE);
+	ExpectDateTime(dateTime, 2020, 2, 29, 13, 5, 9, 123);
+	EXPECT_EQ(Parse("1969-12-31 23:59", dateTime), DateTimeParseError::NONE);
+	ExpectDateTime(dateTime, 1969, 12, 31, 23, 59, 0, 0);
+	EXPECT_EQ(Parse("1815-06-18", dateTime), DateTimeParseError::NONE);
+	ExpectDateTime(dateTime, 1815, 6, 18, 0, 0, 0, 0);
+	EXPECT_EQ(dateTime.WeekDay, SUNDAY);
+
+	// fractions of second: only milliseconds are kept
+	EXPECT_EQ(Parse("2020-01-01T00:00:00,5", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(dateTime.Millisecond, 500);
+	EXPECT_EQ(Parse("2020-01-01T00:00:00.123456", dateTime), DateTimeParseError::NONE);
+	EXPECT_EQ(dateTime.Millisecond, 123);
+
+	// time counter (zero month), the date is not validated
+	EXPECT_EQ(Parse("0000-00-03T10:20:30", dateTime), DateTimeParseError::NONE);
+	ExpectDateTime(dateTime, 0, 0, 3, 10, 20, 30, 0);
+
+	// the length limits the parsed characters
+	EXPECT_EQ(DateTimeParse("2020-02-29T13:05:09", 10, dateTime), DateTimeParseError::NONE);
+	ExpectDateTime(dateTime, 2020, 2, 29, 0, 0, 0, 0);
+
+	std::string str = "2020-03-01T01:02:03";
+	EXPECT_EQ(DateTimeToString(StringToDateTime(str)), str);
+	EXPECT_FALSE(StringToDateTime("not a date").Valid());
+}
+
+
+// Tests every parse error, the error position and that the result is left unchanged
+TEST(DateTimeUtilTest, ParseErrors)
+{
+	struct ParseErrorSample
+	{
+		const char* Text;
+		DateTimeParseError Error;
+		size_t ErrorPos;
+	};
+	const ParseErrorSample samples[] = {
+		{ "", DateTimeParseError::EMPTY, 0 },
+		{ "2020", DateTimeParseError::BAD_DATE, 4 },
+		{ "2020-2-29", DateTimeParseError::BAD_DATE, 5 },
+		{ "20a0-02-29", DateTimeParseError::BAD_DATE, 0 },
+		{ "2020/02/29", DateTimeParseError::BAD_DATE, 4 },
+		{ "2020-02-29T1", DateTimeParseError::BAD_TIME, 11 },
+		{ "2020-02-29T10", DateTimeParseError::BAD_TIME, 13 },
+		{ "2020-02-29 10:", DateTimeParseError::BAD_TIME, 14 },
+		{ "2020-02-29T10:00:", DateTimeParseError::BAD_TIME, 17 },
+		{ "2020-02-29T10:00:00.", DateTimeParseError::BAD_FRACTION, 20 },
+		{ "2020-02-29T10:00:00.Z", DateTimeParseError::BAD_FRACTION, 20 },
+		{ "2020-02-29T10:00+", DateTimeParseError::BAD_OFFSET, 17 },
+		{ "2020-02-29T10:00UTC*01", DateTimeParseError::BAD_OFFSET, 19 },
+		{ "2020-02-29T10:00+01:", DateTimeParseError::BAD_OFFSET, 20 },
+		{ "2019-02-29", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-13-01", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-01-00", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-02-29T24:00", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-02-29T23:60", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-02-29T23:59:61", DateTimeParseError::OUT_OF_RANGE, 0 },
+		{ "2020-02-29T10:00+15:00", DateTimeParseError::OUT_OF_RANGE, 22 },
+		{ "2020-02-29T10:00+01:60", DateTimeParseError::OUT_OF_RANGE, 22 },
+		{ "2020-02-29x", DateTimeParseError::TRAILING_CHARS, 10 },
+		{ "2020-02-29T10:00:00 ", DateTimeParseError::TRAILING_CHARS, 19 },
+		{ "2020-02-29T10:00:00Zx", DateTimeParseError::TRAILING_CHARS, 20 },
+	};
+	for (const ParseErrorSample& sample : samples)
+	{
+		DateTime dateTime(1999, 9, 9, 9, 9, 9, 9);
+		size_t errorPos = 1000;
+		EXPECT_EQ(Parse(sample.Text, dateTime, &errorPos), sample.Error) << sample.Text;
+		EXPECT_EQ(errorPos, sample.ErrorPos) << sample.Text;
+		ExpectDateTime(dateTime, 1999, 9, 9, 9, 9, 9, 9);
+		EXPECT_STRNE(DateTimeParseErrorToString(sample.Error), "");
+	}
+	DateTime dateTime;
+	EXPECT_EQ(DateTimeParse(nullptr, 0, dateTime), DateTimeParseError::EMPTY);
+	size_t errorPos = 1000;
+	EXPECT_EQ(Parse("2020-02-29T10:00:00", dateTime, &errorPos), DateTimeParseError::NONE);
+	EXPECT_EQ(errorPos, (size_t)1000);
+	EXPECT_STREQ(DateTimeParseErrorToString(DateTimeParseError::NONE), "No error");
+}
+
+
+// Tests the accepted forms of UTC offset
+TEST(DateTimeUtilTest, ParseOffset)
+{
+	struct OffsetSample
+	{
+		const char* Text;
+		int Hour;
+		int Minute;
+	};
+	const OffsetSample samples[] = {
+		{ "2020-02-29T10:00:00Z", 0, 0 },
+		{ "2020-02-29T10:00:00UTC", 0, 0 },
+		{ "2020-02-29T10:00:00+05", 5, 0 },
+		{ "2020-02-29T10:00:00-11", -11, 0 },
+		{ "2020-02-29T10:00:00+0530", 5, 30 },
+		{ "2020-02-29T10:00:00-0345", -3, -45 },
+		{ "2020-02-29T10:00:00+05:30", 5, 30 },
+		{ "2020-02-29T10:00:00UTC+05:30", 5, 30 },
+		{ "2020-02-29T10:00:00UTC-09:30", -9, -30 },
+		{ "2020-02-29T10:00:00UTC+14:00", 14, 0 },
+		{ "2020-02-29T10:00UTC+1:+30", 1, 30 },
+		{ "2020-02-29T10:00:00.250Z", 0, 0 },
+		{ "2020-02-29T10:00:00.250+01", 1, 0 },
+		{ "2020-02-29+02:00", 2, 0 },
+	};
+	for (const OffsetSample& sample : samples)
+	{
+		DateTime dateTime;
+		EXPECT_EQ(Parse(sample.Text, dateTime), DateTimeParseError::NONE) << sample.Text;
+		EXPECT_EQ(dateTime.TimeOffsetHour, sample.Hour) << sample.Text;
+		EXPECT_EQ(dateTime.TimeOffsetMinute, sample.Minute) << sample.Text;
+	}
+
+	// the offset is applied converting to UTC
+	DateTime local;
+	DateTime utc;
+	EXPECT_EQ(Parse("2020-03-01T00:30:00UTC+05:30", local), DateTimeParseError::NONE);
+	EXPECT_EQ(Parse("2020-02-29T19:00:00Z", utc), DateTimeParseError::NONE);
+	EXPECT_EQ(DateTimeToEpochMs(local), DateTimeToEpochMs(utc));
+}
+
+
+// Tests conversions to and from milliseconds since 1970-01-01
+TEST(DateTimeUtilTest, EpochMs)
+{
+	EXPECT_EQ(DateTimeToEpochMs(DateTime(1970, 1, 1)), 0);
+	EXPECT_EQ(DateTimeToEpochMs(DateTime(1969, 12, 31, 23, 59, 59, 999)), -1);
+	EXPECT_EQ(DateTimeToEpochMs(DateTime(1970, 1, 1, 1, 0, 0, 0, 1, 0)), 0);
+	EXPECT_EQ(DateTimeToEpochMs(DateTime(2000, 1, 1)), 946684800000LL);
+	EXPECT_EQ(DateTimeToEpochMs(DateTime(1900, 1, 1)), -2208988800000LL);
+
+	DateTime dateTime = EpochMsToDateTime(-1);
+	ExpectDateTime(dateTime, 1969, 12, 31, 23, 59, 59, 999);
+	dateTime = EpochMsToDateTime(-2208988800000LL + 59 * 86400000LL);
+	ExpectDateTime(dateTime, 1900, 3, 1, 0, 0, 0, 0);
+	dateTime = EpochMsToDateTime(0, -90, true);
+	ExpectDateTime(dateTime, 1969, 12, 31, 22, 30, 0, 0);
+	EXPECT_EQ(dateTime.TimeOffsetHour, -1);
+	EXPECT_EQ(dateTime.TimeOffsetMinute, -30);
+	EXPECT_TRUE(dateTime.IsDST);
+	EXPECT_EQ(DateTimeToEpochMs(dateTime), 0);
+
+	for (long long epochMs = -5000000000000LL; epochMs < 5000000000000LL; epochMs += 12345678901LL)
+	{
+		ASSERT_EQ(DateTimeToEpochMs(EpochMsToDateTime(epochMs)), epochMs);
+		ASSERT_EQ(DateTimeToEpochMs(EpochMsToDateTime(epochMs, 330)), epochMs);
+	}
+}
+
+
+// Tests that formatted date/times are parsed back to the same values
+TEST(DateTimeUtilTest, RoundTrip)
+{
+	const DateTime samples[] = {
+		DateTime(2020, 2, 29, 13, 5, 9),
+		DateTime(2020, 2, 29, 13, 5, 9, 7),
+		DateTime(1969, 12, 31, 23, 59, 59, 999),
+		DateTime(1900, 2, 28, 0, 0, 0, 1, 5, 30),
+		DateTime(1600, 1, 1, 12, 0, 0, 0, -9, -30),
+		DateTime(9999, 12, 31, 23, 59, 59, 999, 14, 0),
+		DateTime(1, 1, 1, 0, 0, 0, 0, -12, 0),
+		DateTime(2021, 6, 15, 8, 45, 0, 500, 0, -45),
+	};
+	for (const DateTime& sample : samples)
+	{
+		const std::string str = DateTimeToString(sample);
+		DateTime parsed;
+		ASSERT_EQ(DateTimeParse(str.data(), str.size(), parsed), DateTimeParseError::NONE) << str;
+		ExpectDateTime(parsed, sample.Year, sample.Month, sample.Day, sample.Hour, sample.Minute, sample.Second, sample.Millisecond);
+		EXPECT_EQ(parsed.TimeOffsetHour, sample.TimeOffsetHour) << str;
+		EXPECT_EQ(parsed.TimeOffsetMinute, sample.TimeOffsetMinute) << str;
+		EXPECT_EQ(parsed.WeekDay, civil_date::WeekDayFromDays(civil_date::DaysFromCivil(sample.Year, sample.Month, sample.Day)));
+		EXPECT_EQ(DateTimeToString(parsed), str);
+	}
+
+	// every millisecond of a day, each minute of a century
+	for (long long epochMs = 0; epochMs < 86400000LL; epochMs += 997)
+	{
+		DateTime dateTime = EpochMsToDateTime(epochMs);
+		const std::string str = DateTimeToString(dateTime);
+		DateTime parsed;
+		ASSERT_EQ(DateTimeParse(str.data(), str.size(), parsed), DateTimeParseError::NONE) << str;
+		ASSERT_EQ(DateTimeToEpochMs(parsed), epochMs) << str;
+	}
+	for (long long epochMs = -2208988800000LL; epochMs < 946684800000LL; epochMs += 60000LL * 9973)
+	{
+		DateTime dateTime = EpochMsToDateTime(epochMs, -210);
+		const std::string str = DateTimeToString(dateTime);
+		DateTime parsed;
+		ASSERT_EQ(DateTimeParse(str.data(), str.size(), parsed), DateTimeParseError::NONE) << str;
+		ASSERT_EQ(DateTimeToEpochMs(parsed), epochMs) << str;
+	}
+}
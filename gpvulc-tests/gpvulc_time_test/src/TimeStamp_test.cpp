@@ -0,0 +1,167 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// TimeStamp_test.cpp
+
+#include <type_traits>
+
+#include <gpvulc/time/TimeStamp.h>
+#include <gpvulc/time/DateTimeUtil.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+// Tests the packed layout: 56 bit milliseconds, 7 bit quarters of hour (bias 64), DST flag
+TEST(TimeStampTest, Packing)
+{
+	EXPECT_EQ(sizeof(TimeStamp), sizeof(long long));
+	EXPECT_TRUE(std::is_trivially_copyable<TimeStamp>::value);
+
+	TimeStamp timeStamp;
+	EXPECT_EQ(timeStamp.GetEpochMs(), 0);
+	EXPECT_EQ(timeStamp.GetOffsetMinutes(), 0);
+	EXPECT_FALSE(timeStamp.IsDST());
+	EXPECT_EQ(timeStamp.GetRawValue(), 64);
+
+	timeStamp = TimeStamp(1, 60, true);
+	EXPECT_EQ(timeStamp.GetRawValue(), (1LL << 8) | 0x80 | (64 + 4));
+	EXPECT_EQ(TimeStamp::FromRawValue(timeStamp.GetRawValue()).GetOffsetMinutes(), 60);
+	EXPECT_EQ(TimeStamp(1, -60).GetRawValue(), (1LL << 8) | (64 - 4));
+
+	// the full range of 56 bits
+	const long long maxMs = (1LL << 55) - 1;
+	const long long minMs = -(1LL << 55);
+	EXPECT_EQ(TimeStamp(maxMs, 945, true).GetEpochMs(), maxMs);
+	EXPECT_EQ(TimeStamp(maxMs, 945, true).GetOffsetMinutes(), 945);
+	EXPECT_EQ(TimeStamp(minMs, -960, true).GetEpochMs(), minMs);
+	EXPECT_EQ(TimeStamp(minMs, -960, true).GetOffsetMinutes(), -960);
+	EXPECT_TRUE(TimeStamp(minMs, -960, true).IsDST());
+}
+
+
+// Tests time stamps before 1970
+TEST(TimeStampTest, NegativeEpoch)
+{
+	for (long long epochMs : { -1LL, -999LL, -1000LL, -86400000LL, -2208988800000LL, -62135596800000LL })
+	{
+		for (int offsetMinutes : { -960, -15, 0, 15, 945 })
+		{
+			for (bool isDST : { false, true })
+			{
+				TimeStamp timeStamp(epochMs, offsetMinutes, isDST);
+				ASSERT_EQ(timeStamp.GetEpochMs(), epochMs);
+				ASSERT_EQ(timeStamp.GetOffsetMinutes(), offsetMinutes);
+				ASSERT_EQ(timeStamp.IsDST(), isDST);
+				ASSERT_EQ(timeStamp.GetLocalEpochMs(), epochMs + offsetMinutes * 60000LL);
+			}
+		}
+	}
+
+	// ordering and arithmetic across 1970-01-01
+	TimeStamp before(-1, 945);
+	TimeStamp after(0, -960);
+	EXPECT_TRUE(before < after);
+	EXPECT_TRUE(before.GetRawValue() < after.GetRawValue());
+	EXPECT_EQ(after - before, 1);
+	EXPECT_TRUE(before + 1 == after);
+	EXPECT_TRUE(after - 1 == before);
+	before -= 86400000LL;
+	EXPECT_EQ(before.GetEpochMs(), -86400001LL);
+	EXPECT_EQ(before.GetOffsetMinutes(), 945);
+
+	DateTime dateTime = TimeStamp(-1).ToDateTime();
+	EXPECT_EQ(DateTimeToString(dateTime), "1969-12-31T23:59:59.999");
+	EXPECT_EQ(dateTime.WeekDay, WEDNESDAY);
+}
+
+
+// Tests the extreme offsets and the offsets that cannot be stored
+TEST(TimeStampTest, Offsets)
+{
+	EXPECT_TRUE(TimeStamp::IsValidOffset(0));
+	EXPECT_TRUE(TimeStamp::IsValidOffset(-960));
+	EXPECT_TRUE(TimeStamp::IsValidOffset(945));
+	EXPECT_TRUE(TimeStamp::IsValidOffset(330));
+	EXPECT_TRUE(TimeStamp::IsValidOffset(-570));
+	EXPECT_FALSE(TimeStamp::IsValidOffset(-975));
+	EXPECT_FALSE(TimeStamp::IsValidOffset(960));
+	EXPECT_FALSE(TimeStamp::IsValidOffset(20));
+	EXPECT_FALSE(TimeStamp::IsValidOffset(-10));
+	EXPECT_FALSE(TimeStamp::IsValidOffset(1));
+
+	// -16:00 and +15:45 use the lowest and the highest 7 bit values
+	EXPECT_EQ(TimeStamp(0, -960).GetRawValue() & 0x7F, 0);
+	EXPECT_EQ(TimeStamp(0, 945).GetRawValue() & 0x7F, 0x7F);
+	EXPECT_EQ(TimeStamp(0, -960, true).GetOffsetMinutes(), -960);
+	EXPECT_EQ(TimeStamp(0, 945, true).GetOffsetMinutes(), 945);
+
+	// rejected by SetOffset(), the time stamp is not changed
+	TimeStamp timeStamp(1234567, 60, true);
+	for (int offsetMinutes : { 20, -10, 1, 961, 960, -975, -2000 })
+	{
+		EXPECT_FALSE(timeStamp.SetOffset(offsetMinutes)) << offsetMinutes;
+		EXPECT_EQ(timeStamp.GetOffsetMinutes(), 60);
+		EXPECT_TRUE(timeStamp.IsDST());
+	}
+	EXPECT_TRUE(timeStamp.SetOffset(-960));
+	EXPECT_EQ(timeStamp.GetOffsetMinutes(), -960);
+	EXPECT_FALSE(timeStamp.IsDST());
+	EXPECT_EQ(timeStamp.GetEpochMs(), 1234567);
+	EXPECT_TRUE(timeStamp.SetOffset(945, true));
+	EXPECT_EQ(timeStamp.GetOffsetMinutes(), 945);
+	EXPECT_TRUE(timeStamp.IsDST());
+	EXPECT_EQ(timeStamp.GetEpochMs(), 1234567);
+
+	// the constructor rounds to quarters of hour and limits out of range offsets (no wrap around)
+	EXPECT_EQ(TimeStamp(0, 20).GetOffsetMinutes(), 15);
+	EXPECT_EQ(TimeStamp(0, 23).GetOffsetMinutes(), 30);
+	EXPECT_EQ(TimeStamp(0, -8).GetOffsetMinutes(), -15);
+	EXPECT_EQ(TimeStamp(0, 960).GetOffsetMinutes(), 945);
+	EXPECT_EQ(TimeStamp(0, 1500).GetOffsetMinutes(), 945);
+	EXPECT_EQ(TimeStamp(0, -2000, true).GetOffsetMinutes(), -960);
+	EXPECT_TRUE(TimeStamp(0, -2000, true).IsDST());
+	EXPECT_EQ(TimeStamp(-1, 1500).GetEpochMs(), -1);
+}
+
+
+// Tests conversions to and from DateTime
+TEST(TimeStampTest, DateTime)
+{
+	DateTime dateTime(2021, 3, 28, 2, 30, 15, 250, 2, 0);
+	dateTime.IsDST = true;
+	TimeStamp timeStamp = TimeStamp::FromDateTime(dateTime);
+	EXPECT_EQ(timeStamp.GetEpochMs(), DateTimeToEpochMs(dateTime));
+	EXPECT_EQ(timeStamp.GetOffsetMinutes(), 120);
+	EXPECT_TRUE(timeStamp.IsDST());
+	DateTime converted = timeStamp.ToDateTime();
+	EXPECT_EQ(DateTimeToString(converted), "2021-03-28T02:30:15.250UTC+02:00");
+	EXPECT_TRUE(converted.IsDST);
+	EXPECT_EQ(converted.WeekDay, SUNDAY);
+
+	// lossless round trip for every offset, before and after 1970
+	for (long long epochMs : { -62135596800000LL, -2208988800001LL, -1LL, 0LL, 1617000000123LL, 253402300799999LL })
+	{
+		for (int offsetMinutes = -960; offsetMinutes <= 945; offsetMinutes += 15)
+		{
+			for (bool isDST : { false, true })
+			{
+				TimeStamp original(epochMs, offsetMinutes, isDST);
+				DateTime local = original.ToDateTime();
+				ASSERT_EQ(local.TimeOffsetHour * 60 + local.TimeOffsetMinute, offsetMinutes);
+				ASSERT_EQ(local.IsDST, isDST);
+				TimeStamp restored = TimeStamp::FromDateTime(local);
+				ASSERT_EQ(restored.GetRawValue(), original.GetRawValue()) << DateTimeToString(local);
+			}
+		}
+	}
+}
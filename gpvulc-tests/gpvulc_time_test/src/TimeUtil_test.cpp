@@ -0,0 +1,221 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+// TimeUtil_test.cpp
+
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include <gpvulc/time/TimeUtil.h>
+#include <gpvulc/time/DateTimeUtil.h>
+
+using namespace gpvulc;
+
+#include <gtest/gtest.h>
+
+
+namespace
+{
+	// Central European time zone (POSIX rules, on Windows only the offsets are used)
+	const char* TEST_TIME_ZONE = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+
+	// Set the TZ environment variable (or remove it if tz is null) and reload the time zone
+	void SetTimeZone(const char* tz)
+	{
+#ifdef _WIN32
+		_putenv_s("TZ", tz ? tz : "");
+		_tzset();
+#else
+		if (tz)
+		{
+			setenv("TZ", tz, 1);
+		}
+		else
+		{
+			unsetenv("TZ");
+		}
+		tzset();
+#endif
+	}
+
+
+	// Time zone set for a test and restored at the end
+	class TimeZoneTest : public ::testing::Test
+	{
+	protected:
+
+		void SetUp() override
+		{
+			const char* tz = std::getenv("TZ");
+			mHadTimeZone = tz != nullptr;
+			mTimeZone = tz ? tz : "";
+			SetTimeZone(TEST_TIME_ZONE);
+			ResetUtcOffsetCache();
+		}
+
+		void TearDown() override
+		{
+			SetTimeZone(mHadTimeZone ? mTimeZone.c_str() : nullptr);
+			ResetUtcOffsetCache();
+		}
+
+		std::string mTimeZone;
+		bool mHadTimeZone = false;
+	};
+
+
+	// UTC offset read directly from the system, without cache
+	int SystemUtcOffsetMinutes(long long epochSec, bool& isDST)
+	{
+		std::time_t t = (std::time_t)epochSec;
+		struct tm timeinfo;
+#ifdef _MSC_VER
+		localtime_s(&timeinfo, &t);
+#else
+		localtime_r(&t, &timeinfo);
+#endif
+		isDST = timeinfo.tm_isdst > 0;
+		DateTime localTime(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+			timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+		return (int)((DateTimeToEpochMs(localTime) / 1000 - epochSec) / 60);
+	}
+
+
+	// Find the first second with a different UTC offset in [fromSec, toSec), return 0 if not found
+	long long FindTransition(long long fromSec, long long toSec)
+	{
+		bool isDST = false;
+		const int offset = SystemUtcOffsetMinutes(fromSec, isDST);
+		long long low = fromSec;
+		long long high = 0;
+		for (long long t = fromSec + 3600; t < toSec && high == 0; t += 3600)
+		{
+			if (SystemUtcOffsetMinutes(t, isDST) != offset)
+			{
+				high = t;
+			}
+			else
+			{
+				low = t;
+			}
+		}
+		if (high == 0)
+		{
+			return 0;
+		}
+		while (high - low > 1)
+		{
+			long long middle = low + (high - low) / 2;
+			(SystemUtcOffsetMinutes(middle, isDST) == offset ? low : high) = middle;
+		}
+		return high;
+	}
+
+
+	long long EpochSec(int year, int month, int day)
+	{
+		return DateTimeToEpochMs(DateTime(year, month, day)) / 1000;
+	}
+}
+
+
+// The cached UTC offset changes exactly at the daylight savings time transitions
+TEST_F(TimeZoneTest, UtcOffsetCacheDST)
+{
+	const long long springSec = FindTransition(EpochSec(2021, 3, 1), EpochSec(2021, 5, 1));
+	const long long autumnSec = FindTransition(EpochSec(2021, 10, 1), EpochSec(2021, 12, 1));
+	ASSERT_NE(springSec, 0);
+	ASSERT_NE(autumnSec, 0);
+#ifndef _WIN32
+	EXPECT_EQ(springSec, DateTimeToEpochMs(DateTime(2021, 3, 28, 1)) / 1000);
+	EXPECT_EQ(autumnSec, DateTimeToEpochMs(DateTime(2021, 10, 31, 1)) / 1000);
+#endif
+
+	bool isDST = true;
+	// cached some hours before the transition, valid until the transition
+	EXPECT_EQ(GetUtcOffsetMinutes((springSec - 6 * 3600) * 1000, &isDST), 60);
+	EXPECT_FALSE(isDST);
+	EXPECT_EQ(GetUtcOffsetMinutes(springSec * 1000 - 1, &isDST), 60);
+	EXPECT_FALSE(isDST);
+	EXPECT_EQ(GetUtcOffsetMinutes(springSec * 1000, &isDST), 120);
+	EXPECT_TRUE(isDST);
+	EXPECT_EQ(GetUtcOffsetMinutes(springSec * 1000 + 3600000, &isDST), 120);
+	EXPECT_TRUE(isDST);
+	// going back before the transition
+	EXPECT_EQ(GetUtcOffsetMinutes(springSec * 1000 - 1, &isDST), 60);
+	EXPECT_FALSE(isDST);
+
+	EXPECT_EQ(GetUtcOffsetMinutes((autumnSec - 3600) * 1000, &isDST), 120);
+	EXPECT_TRUE(isDST);
+	EXPECT_EQ(GetUtcOffsetMinutes(autumnSec * 1000 - 1, &isDST), 120);
+	EXPECT_TRUE(isDST);
+	EXPECT_EQ(GetUtcOffsetMinutes(autumnSec * 1000, &isDST), 60);
+	EXPECT_FALSE(isDST);
+	// more than a day later (outside the checked period)
+	EXPECT_EQ(GetUtcOffsetMinutes((autumnSec + 3 * 86400) * 1000, &isDST), 60);
+	EXPECT_FALSE(isDST);
+
+	// the same results as the system, second by second around the transition
+	for (long long t = springSec - 5; t < springSec + 5; t++)
+	{
+		bool systemDST = false;
+		const int systemOffset = SystemUtcOffsetMinutes(t, systemDST);
+		EXPECT_EQ(GetUtcOffsetMinutes(t * 1000 + 999, &isDST), systemOffset);
+		EXPECT_EQ(isDST, systemDST);
+	}
+}
+
+
+// A time zone change is seen only after ResetUtcOffsetCache()
+TEST_F(TimeZoneTest, ResetUtcOffsetCache)
+{
+	const long long epochMs = DateTimeToEpochMs(DateTime(2021, 7, 1, 12));
+	bool isDST = false;
+	EXPECT_EQ(GetUtcOffsetMinutes(epochMs, &isDST), 120);
+	EXPECT_TRUE(isDST);
+
+	SetTimeZone("UTC0");
+	EXPECT_EQ(GetUtcOffsetMinutes(epochMs + 1000, &isDST), 120);
+	EXPECT_TRUE(isDST);
+	ResetUtcOffsetCache();
+	EXPECT_EQ(GetUtcOffsetMinutes(epochMs + 1000, &isDST), 0);
+	EXPECT_FALSE(isDST);
+
+	SetTimeZone(TEST_TIME_ZONE);
+	ResetUtcOffsetCache();
+	EXPECT_EQ(GetUtcOffsetMinutes(epochMs, &isDST), 120);
+	EXPECT_TRUE(isDST);
+}
+
+
+// GetDateTimeNow() gives only the local time, GetDateTimeNowWithOffset() also the UTC offset
+TEST_F(TimeZoneTest, DateTimeNow)
+{
+	DateTime now = GetDateTimeNow();
+	EXPECT_EQ(now.TimeOffsetHour, 0);
+	EXPECT_EQ(now.TimeOffsetMinute, 0);
+	EXPECT_EQ(DateTimeToString(now).find("UTC"), std::string::npos);
+	EXPECT_EQ(DateTimeToString(GetDateTimeNowCoarse()).find("UTC"), std::string::npos);
+
+	DateTime nowWithOffset = GetDateTimeNowWithOffset();
+	const int offsetMinutes = nowWithOffset.TimeOffsetHour * 60 + nowWithOffset.TimeOffsetMinute;
+	EXPECT_TRUE(offsetMinutes == 60 || offsetMinutes == 120) << offsetMinutes;
+	EXPECT_EQ(nowWithOffset.IsDST, offsetMinutes == 120);
+	const std::string text = DateTimeToString(nowWithOffset);
+	EXPECT_NE(text.find(offsetMinutes == 60 ? "UTC+01:00" : "UTC+02:00"), std::string::npos) << text;
+
+	// the same local time (unless the clock changes second between the calls)
+	const long long localMs = DateTimeToEpochMs(now);
+	const long long localWithOffsetMs = DateTimeToEpochMs(nowWithOffset) + offsetMinutes * 60000LL;
+	EXPECT_LT(std::abs(localWithOffsetMs - localMs), 5000);
+}
@@ -40,6 +40,8 @@ namespace gpvulc
 	@param textConverterFunc User function that processes each file.
 	@param fileFilters Optional parameter to specify a list of filters to select the files to be processed (default: empty vector, process all files).
 	@param disableConsolePause Optional flag to disable the pause before exiting (default: enabled).
+	@param asUtf16 Optional flag to load files without byte order mark as UTF-16LE (default: UTF-8).
+	Changed files are saved with the encoding and the byte order mark of the original files.
 	@return EXIT_SUCCESS (in any case).
 	@note The user function accepts two strings as parameters,
 	the first one is the original text to be processed,
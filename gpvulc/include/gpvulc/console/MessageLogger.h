@@ -44,6 +44,9 @@ namespace gpvulc
 
 		/*!
 		Obtain a shared pointer to a global message logger.
+		The logger is created by the first call, also if it is called by several threads at the same time.
+		@note The logger can be used by many threads, but it should be configured (DisplayMessage,
+		SetDefaultOutput(), EnableOutput()) before other threads use it.
 		*/
 		static std::shared_ptr<MessageLogger> GetGlobalLogger();
 
@@ -99,8 +102,6 @@ namespace gpvulc
 		void EnableOutput(bool toConsole = true, bool toScreen = false);
 
 	private:
-		static std::shared_ptr<MessageLogger> GlobalLogger;
-
 		bool DefaultToConsole = true;
 		bool DefaultToScreen = false;
 		bool IsConsoleEnabled = true;
@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Allocator for rapidjson (see rapidjson Allocator concept) reusing its memory across documents.
+
+		Memory blocks are taken from a buffer and released all together calling Clear().
+		If the buffer is not large enough further blocks are allocated on the heap and,
+		when Clear() is called, the buffer is enlarged to fit all of them (up to the maximum retained size),
+		so that repeating the same work does not allocate memory any more.
+		@note Used for parsing stacks, that are always empty between documents.
+		*/
+		class ArenaAllocator
+		{
+		public:
+
+			//! Blocks are not freed one by one (rapidjson allocator concept).
+			static const bool kNeedFree = false;
+
+			//! Default maximum retained size (bytes).
+			static const size_t DEFAULT_MAX_RETAINED_SIZE = 1024 * 1024;
+
+			//! Constructor, optionally setting the maximum size of the memory kept between Clear() calls.
+			explicit ArenaAllocator(size_t maxRetainedSize = DEFAULT_MAX_RETAINED_SIZE);
+
+			//! Allocate a memory block.
+			void* Malloc(size_t size);
+
+			//! Resize a memory block (the last block is resized in place if possible).
+			void* Realloc(void* originalPtr, size_t originalSize, size_t newSize);
+
+			//! Memory blocks are released only by Clear().
+			static void Free(void*) {}
+
+			//! Release all memory blocks, the memory is kept for the next allocations.
+			void Clear();
+
+			//! Set the maximum size of the memory kept between Clear() calls (applied at the next Clear()).
+			void SetMaxRetainedSize(size_t maxRetainedSize) { MaxRetainedSize = maxRetainedSize; }
+
+			//! Get the size of the memory kept for the next allocations.
+			size_t GetRetainedSize() const { return Buffer.size(); }
+
+		private:
+
+			ArenaAllocator(const ArenaAllocator&) = delete;
+			ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+			std::vector<char> Buffer;
+			size_t Used = 0;
+			size_t LastBlockOffset = 0;
+			size_t MaxRetainedSize;
+
+			//! Blocks allocated when the buffer is full
+			std::vector<std::unique_ptr<char[]>> Overflow;
+			size_t OverflowSize = 0;
+		};
+	}
+}
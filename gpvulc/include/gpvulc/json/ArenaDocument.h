@@ -0,0 +1,24 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "RapidJsonInclude.h" // Macro definitions for rapidjson
+#include "ArenaAllocator.h"
+
+#include <rapidjson/document.h>     // rapidjson's DOM-style API
+
+namespace gpvulc
+{
+	namespace json
+	{
+		//! DOM document with the parsing stack allocated in an arena (values are still rapidjson::Value)
+		typedef rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, ArenaAllocator> ArenaDocument;
+	}
+}
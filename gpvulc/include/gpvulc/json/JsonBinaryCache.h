@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "MappedFile.h"
+#include "ArenaDocument.h"
+
+#include <cstdint>
+#include <string>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Binary cache of a parsed JSON file, to load it again without parsing the text.
+
+		The cache file stores the size and the modification time of the source file
+		(with the sub-second resolution of the file system, where available),
+		followed by the values in document order: numbers in binary form,
+		strings with their length and a null character, objects and arrays with their number of elements.
+		Loading a cache maps the file in memory and builds the DOM directly,
+		without copying the strings (DOM strings point to the mapped file).
+		@see RapidJsonParser::ParseFileCached()
+		*/
+		class JsonBinaryCache
+		{
+		public:
+
+			//! Extension appended to the source file name for the default cache file name.
+			static const char* const DEFAULT_EXTENSION;
+
+			/*!
+			Write a cache file for the given value, parsed from the given source file.
+			The file is written with a temporary name and then renamed,
+			so that a cache file is never read while it is being written.
+			@return false if the source file cannot be found or the cache cannot be written.
+			*/
+			static bool Write(const rapidjson::Value& value, const std::string& sourceFileName, const std::string& cacheFileName);
+
+			/*!
+			Open a cache file and check that it is up to date with its source file.
+			@return false if the cache is missing, invalid or older than the source file (the cache is closed).
+			*/
+			bool Open(const std::string& cacheFileName, const std::string& sourceFileName);
+
+			//! Close the cache file, values loaded from it are no longer valid.
+			void Close() { CacheFile.Close(); }
+
+			//! Check if a cache file was opened.
+			bool IsOpen() const { return CacheFile.IsOpen(); }
+
+			/*!
+			Load the content of the open cache into a document.
+			@note The strings of the document refer to the cache file, that must be kept open.
+			@return false if the cache is corrupted (the document is not changed).
+			*/
+			bool Load(ArenaDocument& document);
+
+		private:
+
+			MappedFile CacheFile;
+		};
+	}
+}
@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "RapidJsonParser.h"
+#include "MappedFile.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Reader for newline-delimited JSON (JSONL), parsing the records on a pool of threads.
+
+		The text is split at newlines and each line is parsed in place (see RapidJsonParser::ParseInsitu())
+		by a worker thread, with one RapidJsonParser per thread reused for all its lines.
+		Lines are processed in batches: while a batch is parsed the previous one is delivered
+		by the calling thread, so results and errors are always reported in the order of the lines.
+		Blank lines are skipped (but counted for line numbers).
+
+		Example:
+		@code
+		JsonLinesReader reader;
+		reader.ReadFile<Record>("records.jsonl",
+			[](RapidJsonParser& parser, Record& record) { ... }, // called by worker threads
+			[&](size_t lineNumber, Record& record) { ... },     // called in order by this thread
+			[&](size_t lineNumber, const char* error) { ... }); // called in order by this thread
+		@endcode
+		@note A reader must be used by one thread at a time.
+		*/
+		class JsonLinesReader
+		{
+		public:
+
+			//! Default number of lines for each batch.
+			static const size_t DEFAULT_BATCH_SIZE = 4096;
+
+			//! Handler called in order for lines that could not be read (line numbers start from 1).
+			typedef std::function<void(size_t lineNumber, const char* errorMessage)> ErrorHandler;
+
+			/*!
+			Constructor, starting the worker threads.
+			@param numThreads number of worker threads (0 means one thread per hardware core)
+			*/
+			explicit JsonLinesReader(unsigned numThreads = 0);
+
+			//! Destructor, stops the worker threads.
+			~JsonLinesReader();
+
+			//! Get the number of worker threads.
+			unsigned GetThreadCount() const { return (unsigned)Parsers.size(); }
+
+			//! Get the parser of the given worker thread (e.g. to call SetMaxErrors() before reading).
+			RapidJsonParser& GetParser(unsigned threadIndex) { return *Parsers[threadIndex]; }
+
+			//! Set the number of lines of each batch (the number of records kept in memory is twice this size).
+			void SetBatchSize(size_t lines) { BatchSize = lines > 0 ? lines : 1; }
+
+			//! Get the number of records successfully read by the last call to Read() or ReadFile().
+			size_t GetRecordCount() const { return RecordCount; }
+
+			//! Get the number of lines that could not be read by the last call to Read() or ReadFile().
+			size_t GetErrorCount() const { return ErrorCount; }
+
+			/*!
+			Read the records from a null terminated text, modified in place.
+			@param text JSONL text, newlines and strings are decoded inside this buffer
+			@param length length of the text (text[length] must be a null character)
+			@param convert called by the worker threads for each parsed line,
+			to fill the record from the parser DOM (errors are collected by the parser as usual)
+			@param onRecord called in order by the calling thread for each record without errors
+			@param onError called in order by the calling thread for each line with parsing or content errors
+			@note Record objects are reused across batches: @c convert must set all the values it needs.
+			*/
+			template <typename T>
+			void Read(
+				char* text,
+				size_t length,
+				std::function<void(RapidJsonParser&, T&)> convert,
+				std::function<void(size_t, T&)> onRecord,
+				ErrorHandler onError = nullptr)
+			{
+				std::vector<T> records[2];
+				records[0].resize(BatchSize);
+				records[1].resize(BatchSize);
+				ReadLines(text, length,
+					[&](unsigned batch, size_t slot, RapidJsonParser& parser) { convert(parser, records[batch][slot]); },
+					[&](unsigned batch, size_t slot, size_t lineNumber) { onRecord(lineNumber, records[batch][slot]); },
+					onError);
+			}
+
+			/*!
+			Read the records from a file mapped in memory (see Read()).
+			@return false if the file could not be opened.
+			*/
+			template <typename T>
+			bool ReadFile(
+				const std::string& fileName,
+				std::function<void(RapidJsonParser&, T&)> convert,
+				std::function<void(size_t, T&)> onRecord,
+				ErrorHandler onError = nullptr)
+			{
+				RecordCount = 0;
+				ErrorCount = 0;
+				if (!SourceFile.Open(fileName, true))
+				{
+					return false;
+				}
+				try
+				{
+					Read<T>(SourceFile.GetWritableData(), SourceFile.GetSize(), convert, onRecord, onError);
+				}
+				catch (...)
+				{
+					SourceFile.Close();
+					throw;
+				}
+				SourceFile.Close();
+				return true;
+			}
+
+		protected:
+
+			//! Called by a worker thread to convert the line stored in a slot of a batch.
+			typedef std::function<void(unsigned batch, size_t slot, RapidJsonParser& parser)> SlotConverter;
+
+			//! Called by the calling thread to deliver the record stored in a slot of a batch.
+			typedef std::function<void(unsigned batch, size_t slot, size_t lineNumber)> SlotDeliverer;
+
+			//! Split the text in batches of lines, parse them on the worker threads and deliver them in order.
+			void ReadLines(
+				char* text,
+				size_t length,
+				const SlotConverter& convert,
+				const SlotDeliverer& deliver,
+				const ErrorHandler& onError);
+
+		private:
+
+			JsonLinesReader(const JsonLinesReader&) = delete;
+			JsonLinesReader& operator=(const JsonLinesReader&) = delete;
+
+			struct LineBatch;
+			struct WorkerPool;
+
+			size_t BatchSize = DEFAULT_BATCH_SIZE;
+			size_t RecordCount = 0;
+			size_t ErrorCount = 0;
+
+			//! One parser for each worker thread
+			std::vector<std::unique_ptr<RapidJsonParser>> Parsers;
+
+			//! Double buffer of line batches: one is parsed while the other is delivered
+			std::unique_ptr<LineBatch[]> Batches;
+
+			std::unique_ptr<WorkerPool> Pool;
+
+			//! File mapped by ReadFile()
+			MappedFile SourceFile;
+
+			//! Split the next lines of the text (from position pos) into the given batch.
+			void FillBatch(LineBatch& batch, char* text, size_t length, size_t& pos, size_t& lineNumber);
+
+			//! Deliver the records and the errors of a parsed batch, in order.
+			void DeliverBatch(unsigned batchIndex, const SlotDeliverer& deliver, const ErrorHandler& onError);
+
+			//! Parse lines of the current batch until no line is left (worker threads).
+			void ParseLines(unsigned threadIndex);
+
+			//! Worker thread loop.
+			void WorkerLoop(unsigned threadIndex);
+
+			//! Start parsing a batch on the worker threads.
+			void StartBatch(unsigned batchIndex, const SlotConverter& convert);
+
+			//! Wait for the worker threads to complete the current batch.
+			void WaitBatch();
+		};
+	}
+}
@@ -0,0 +1,441 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "RapidJsonParser.h"
+#include "RapidJsonWriter.h"
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Description of a member of a mapped type (see JsonField()).
+		*/
+		template <typename Class, typename Member>
+		struct JsonFieldInfo
+		{
+			//! JSON member name
+			const char* Name;
+			//! Pointer to the data member
+			Member Class::* Pointer;
+			//! If true no error is registered when the member is missing
+			bool Optional;
+		};
+
+
+		/*!
+		Declare a field of a mapped type, binding a JSON member name to a data member.
+		@param name JSON member name (must be valid for the whole program, e.g. a string literal)
+		@param pointer pointer to the data member
+		@param optional if false (default) an error is registered when the member is missing
+		*/
+		template <typename Class, typename Member>
+		JsonFieldInfo<Class, Member> JsonField(const char* name, Member Class::* pointer, bool optional = false)
+		{
+			return { name, pointer, optional };
+		}
+
+
+		//! Build the list of fields of a mapped type (see JsonMapping).
+		template <typename... Fields>
+		std::tuple<Fields...> MakeJsonFields(Fields... fields)
+		{
+			return std::tuple<Fields...>(fields...);
+		}
+
+
+		/*!
+		Mapping between a type and a JSON object.
+
+		By default the fields are given by a static method of the type:
+		@code
+		struct Point
+		{
+			float X = 0;
+			float Y = 0;
+			std::string Label;
+
+			static auto JsonFields()
+			{
+				using namespace gpvulc::json;
+				return MakeJsonFields(
+					JsonField("x", &Point::X),
+					JsonField("y", &Point::Y),
+					JsonField("label", &Point::Label, true));
+			}
+		};
+		@endcode
+		Types that cannot be changed can be mapped specializing this template
+		with a static GetFields() method.
+
+		Fields can be bool, int, float, double, std::string, other mapped types
+		and std::vector of these types.
+		*/
+		template <typename T>
+		struct JsonMapping
+		{
+			static auto GetFields()
+			{
+				return T::JsonFields();
+			}
+		};
+
+
+		/*!
+		Index of the field names of a mapped type, based on a perfect hash:
+		each name is stored in a distinct slot, so a lookup requires
+		one hash computation and one string comparison, regardless of the number of fields.
+		*/
+		class JsonFieldIndex
+		{
+		public:
+
+			//! Value returned by Find() for unknown names.
+			static const size_t NOT_FOUND = (size_t)-1;
+
+			/*!
+			Build the index for the given names (a FormatException is thrown if a name is repeated).
+			@note Only the pointers are stored, the names must be valid as long as the index.
+			*/
+			JsonFieldIndex(const char* const* names, size_t count);
+
+			//! Get the position of the given name in the list passed to the constructor, or NOT_FOUND.
+			size_t Find(const char* name, size_t length) const
+			{
+				const size_t index = Slots[Hash(name, length, Seed) & Mask];
+				if (index < Lengths.size() && Lengths[index] == length
+					&& std::char_traits<char>::compare(Names[index], name, length) == 0)
+				{
+					return index;
+				}
+				return NOT_FOUND;
+			}
+
+		private:
+
+			//! FNV-1a hash, varied by a seed
+			static std::uint32_t Hash(const char* name, size_t length, std::uint32_t seed)
+			{
+				std::uint32_t hash = 2166136261u ^ seed;
+				for (size_t i = 0; i < length; i++)
+				{
+					hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+				}
+				return hash ^ (hash >> 15);
+			}
+
+			std::uint32_t Seed = 0;
+			size_t Mask = 0;
+			//! Field position for each slot (NOT_FOUND for empty slots)
+			std::vector<size_t> Slots;
+			std::vector<const char*> Names;
+			std::vector<size_t> Lengths;
+		};
+
+
+		/*!
+		Read single values into fields of mapped types, registering errors in the parser.
+		@param name member name used for error messages
+		*/
+		struct JsonValueReader
+		{
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, bool& value, const char* name);
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, int& value, const char* name);
+			//! Integer values are accepted too.
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, float& value, const char* name);
+			//! Integer values are accepted too.
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, double& value, const char* name);
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, std::string& value, const char* name);
+
+			/// Numeric arrays are read with a single pass (see RapidJsonParser::GetArray()).
+			/// @{
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<int>& values, const char* name) { parser.GetArray(val, values, name); }
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<float>& values, const char* name) { parser.GetArray(val, values, name); }
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<double>& values, const char* name) { parser.GetArray(val, values, name); }
+			/// @}
+
+			//! Read an array, each element is read in a numbered context.
+			template <typename T>
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<T>& values, const char* name);
+
+			//! Read a nested mapped type in a named context.
+			template <typename T>
+			static void Read(RapidJsonParser& parser, const rapidjson::Value& val, T& object, const char* name);
+
+		private:
+
+			//! Read the elements of an array in the current context.
+			template <typename T>
+			static void ReadArray(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<T>& values, const char* name);
+
+			/// Read an array element, nested arrays and objects are read in the context of the element.
+			/// @{
+			template <typename T>
+			static void ReadElement(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<T>& values, const char* name)
+			{
+				ReadArray(parser, val, values, name);
+			}
+
+			template <typename T>
+			static void ReadElement(RapidJsonParser& parser, const rapidjson::Value& val, T& value, const char* name)
+			{
+				ReadElement(parser, val, value, name, std::integral_constant<bool,
+					std::is_class<T>::value && !std::is_same<T, std::string>::value>());
+			}
+
+			template <typename T>
+			static void ReadElement(RapidJsonParser& parser, const rapidjson::Value& val, T& value, const char* name, std::false_type)
+			{
+				Read(parser, val, value, name);
+			}
+
+			template <typename T>
+			static void ReadElement(RapidJsonParser& parser, const rapidjson::Value& val, T& object, const char*, std::true_type)
+			{
+				JsonMapper<T>::Read(parser, val, object);
+			}
+			/// @}
+		};
+
+
+		//! Write single values from fields of mapped types.
+		struct JsonValueWriter
+		{
+			static void Write(RapidJsonWriter& writer, const char* name, bool value) { writer.WriteBool(name, value); }
+			static void Write(RapidJsonWriter& writer, const char* name, int value) { writer.WriteInt(name, value); }
+			static void Write(RapidJsonWriter& writer, const char* name, float value) { writer.WriteFloat(name, value); }
+			static void Write(RapidJsonWriter& writer, const char* name, double value) { writer.WriteDouble(name, value); }
+			static void Write(RapidJsonWriter& writer, const char* name, const std::string& value) { writer.WriteString(name, value); }
+			static void Write(RapidJsonWriter& writer, const char* name, const std::vector<int>& values) { writer.WriteArray(name, values); }
+			static void Write(RapidJsonWriter& writer, const char* name, const std::vector<float>& values) { writer.WriteArray(name, values); }
+			static void Write(RapidJsonWriter& writer, const char* name, const std::vector<double>& values) { writer.WriteArray(name, values); }
+
+			template <typename T>
+			static void Write(RapidJsonWriter& writer, const char* name, const std::vector<T>& values)
+			{
+				writer.StartArray(name);
+				for (const T& value : values)
+				{
+					Write(writer, nullptr, value);
+				}
+				writer.EndArray();
+			}
+
+			//! Write a nested mapped type.
+			template <typename T>
+			static void Write(RapidJsonWriter& writer, const char* name, const T& object);
+		};
+
+
+		/*!
+		Parser and writer for a mapped type (see JsonMapping),
+		instantiated at compile time from the list of fields.
+
+		Members of the JSON object are visited once and dispatched to the field readers
+		through a JsonFieldIndex, unknown members are ignored.
+		Errors are collected in the parser as for RapidJsonParser @c Get methods:
+		a wrong type is reported with the member name, nested objects and arrays
+		are read in their own context, missing members are reported unless optional.
+		*/
+		template <typename T>
+		class JsonMapper
+		{
+		public:
+
+			/*!
+			Read the given object into a mapped type.
+			@return false if errors were registered while reading this object.
+			*/
+			static bool Read(RapidJsonParser& parser, const rapidjson::Value& val, T& object)
+			{
+				if (!parser.CheckIsObject(val))
+				{
+					return false;
+				}
+				const FieldTable& table = GetFieldTable();
+				const size_t errorCount = parser.GetErrorCount();
+				const size_t contextDepth = parser.PathToMember.size();
+				bool found[FIELD_COUNT] = {};
+				try
+				{
+					for (auto member = val.MemberBegin(); member != val.MemberEnd(); ++member)
+					{
+						const size_t index = table.Index.Find(member->name.GetString(), member->name.GetStringLength());
+						if (index != JsonFieldIndex::NOT_FOUND)
+						{
+							found[index] = true;
+							table.Readers[index](parser, member->value, object);
+						}
+					}
+					for (size_t i = 0; i < FIELD_COUNT; i++)
+					{
+						if (!found[i] && !table.Optional[i])
+						{
+							parser.AddJsonError(ErrorType::MISSING_MEMBER, table.Names[i]);
+						}
+					}
+				}
+				catch (...)
+				{
+					// restore the context before propagating the error limit exception
+					parser.RestoreContext(contextDepth);
+					throw;
+				}
+				return parser.GetErrorCount() == errorCount;
+			}
+
+			//! Write the fields of a mapped type as members of the current object.
+			static void WriteMembers(RapidJsonWriter& writer, const T& object)
+			{
+				WriteFields(writer, object, FieldSequence());
+			}
+
+		private:
+
+			typedef decltype(JsonMapping<T>::GetFields()) FieldList;
+			static const size_t FIELD_COUNT = std::tuple_size<FieldList>::value;
+			typedef std::make_index_sequence<FIELD_COUNT> FieldSequence;
+			typedef void(*FieldReader)(RapidJsonParser&, const rapidjson::Value&, T&);
+
+			static_assert(FIELD_COUNT > 0, "A mapped type must have at least one field");
+
+			//! Dispatch table built once for each mapped type
+			struct FieldTable
+			{
+				const char* Names[FIELD_COUNT];
+				bool Optional[FIELD_COUNT];
+				FieldReader Readers[FIELD_COUNT];
+				JsonFieldIndex Index;
+
+				template <size_t... I>
+				FieldTable(std::index_sequence<I...>)
+					: Names{ std::get<I>(GetFields()).Name... }
+					, Optional{ std::get<I>(GetFields()).Optional... }
+					, Readers{ &ReadField<I>... }
+					, Index(Names, FIELD_COUNT)
+				{
+				}
+			};
+
+			static const FieldList& GetFields()
+			{
+				static const FieldList fields = JsonMapping<T>::GetFields();
+				return fields;
+			}
+
+			static const FieldTable& GetFieldTable()
+			{
+				static const FieldTable table(FieldSequence{});
+				return table;
+			}
+
+			template <size_t I>
+			static void ReadField(RapidJsonParser& parser, const rapidjson::Value& val, T& object)
+			{
+				const auto& field = std::get<I>(GetFields());
+				JsonValueReader::Read(parser, val, object.*field.Pointer, field.Name);
+			}
+
+			template <size_t... I>
+			static void WriteFields(RapidJsonWriter& writer, const T& object, std::index_sequence<I...>)
+			{
+				const FieldList& fields = GetFields();
+				int expand[] = { (JsonValueWriter::Write(writer, std::get<I>(fields).Name, object.*std::get<I>(fields).Pointer), 0)... };
+				(void)expand;
+			}
+		};
+
+
+		template <typename T>
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<T>& values, const char* name)
+		{
+			parser.StartContext(name);
+			ReadArray(parser, val, values, name);
+			parser.EndContext();
+		}
+
+
+		template <typename T>
+		void JsonValueReader::ReadArray(RapidJsonParser& parser, const rapidjson::Value& val, std::vector<T>& values, const char* name)
+		{
+			values.clear();
+			if (!parser.CheckIsArray(val))
+			{
+				return;
+			}
+			values.reserve(val.Size());
+			for (rapidjson::SizeType i = 0; i < val.Size(); i++)
+			{
+				// read into a local variable (std::vector<bool> has no references to elements)
+				T value{};
+				parser.StartContext((size_t)i);
+				ReadElement(parser, val[i], value, name);
+				parser.EndContext();
+				values.push_back(std::move(value));
+			}
+		}
+
+
+		template <typename T>
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, T& object, const char* name)
+		{
+			parser.StartContext(name);
+			JsonMapper<T>::Read(parser, val, object);
+			parser.EndContext();
+		}
+
+
+		template <typename T>
+		void JsonValueWriter::Write(RapidJsonWriter& writer, const char* name, const T& object)
+		{
+			writer.StartObject(name);
+			JsonMapper<T>::WriteMembers(writer, object);
+			writer.EndObject();
+		}
+
+
+		/*!
+		Read a JSON object into a mapped type (see JsonMapping), errors are collected in the parser.
+		@return false if errors were registered while reading this object.
+		*/
+		template <typename T>
+		bool ReadJsonObject(RapidJsonParser& parser, const rapidjson::Value& val, T& object)
+		{
+			return JsonMapper<T>::Read(parser, val, object);
+		}
+
+
+		/*!
+		Write a mapped type (see JsonMapping) as an object,
+		if a memberName is not null a key is previously created with that name.
+		*/
+		template <typename T>
+		void WriteJsonObject(RapidJsonWriter& writer, const char* memberName, const T& object)
+		{
+			JsonValueWriter::Write(writer, memberName, object);
+		}
+
+
+		//! Write the fields of a mapped type (see JsonMapping) as members of the current object (e.g. the document).
+		template <typename T>
+		void WriteJsonMembers(RapidJsonWriter& writer, const T& object)
+		{
+			JsonMapper<T>::WriteMembers(writer, object);
+		}
+	}
+}
@@ -0,0 +1,120 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "RapidJsonInclude.h" // Macro definitions for rapidjson
+
+#include <rapidjson/document.h>     // rapidjson's DOM-style API
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Hash index of the members of a parsed document, for repeated random access.
+
+		Member lookups in rapidjson are linear searches: the index builds a hash table
+		for an object the first time one of its members is searched
+		(only for objects with many members, smaller ones are searched directly),
+		then every lookup on that object requires one hash computation.
+		Values can also be found by JSON pointer (e.g. "/server/ports/0"),
+		the results are cached so that repeating a query costs a single hash lookup.
+
+		The index refers to the values of a document: it must be reset (see Reset())
+		when the document is changed, parsed again or released.
+		@note Lookups update the index: an index must be used by one thread at a time.
+		*/
+		class JsonPathIndex
+		{
+		public:
+
+			//! Default minimum number of members of an indexed object.
+			static const size_t DEFAULT_MIN_INDEXED_MEMBERS = 8;
+
+			/*!
+			Constructor.
+			@param minIndexedMembers objects with fewer members are searched without building a table
+			*/
+			explicit JsonPathIndex(size_t minIndexedMembers = DEFAULT_MIN_INDEXED_MEMBERS);
+
+			/*!
+			Clear the index and set the root value used by Find() (may be null),
+			the allocated memory is kept for the next document.
+			*/
+			void Reset(const rapidjson::Value* root = nullptr);
+
+			//! Set the minimum number of members of an indexed object (applied to objects not yet indexed).
+			void SetMinIndexedMembers(size_t minMembers) { MinIndexedMembers = minMembers; }
+
+			//! Find the named member of the given object, nullptr if missing or if the value is not an object.
+			const rapidjson::Value* FindMember(const rapidjson::Value& object, const char* name, size_t length);
+
+			//! Find the named member of the given object (see FindMember(const rapidjson::Value&, const char*, size_t)).
+			const rapidjson::Value* FindMember(const rapidjson::Value& object, const char* name);
+
+			/*!
+			Find a value by JSON pointer (RFC 6901) starting from the root value,
+			e.g. "/scene/objects/3/name" ("~0" stands for '~' and "~1" for '/' in names).
+			@return the value or nullptr if not found.
+			*/
+			const rapidjson::Value* Find(const std::string& pointer);
+
+			//! Find a value by JSON pointer (see Find(const std::string&)).
+			const rapidjson::Value* Find(const char* pointer);
+
+		private:
+
+			//! Hash table of the members of an object, stored in Slots
+			struct ObjectTable
+			{
+				size_t Offset;
+				std::uint32_t Mask;
+			};
+
+			const rapidjson::Value* Root = nullptr;
+			size_t MinIndexedMembers;
+
+			//! Table of each indexed object (objects searched directly have no entry)
+			std::unordered_map<const rapidjson::Value*, ObjectTable> Tables;
+
+			//! Slots of all the tables: member index + 1, 0 for empty slots
+			std::vector<std::uint32_t> Slots;
+
+			//! Values already found by JSON pointer (nullptr if not found)
+			std::unordered_map<std::string, const rapidjson::Value*> PathCache;
+
+			//! Buffers reused while resolving pointers
+			std::string Key;
+			std::string Token;
+
+			//! FNV-1a hash of a member name
+			static std::uint32_t Hash(const char* name, size_t length)
+			{
+				std::uint32_t hash = 2166136261u;
+				for (size_t i = 0; i < length; i++)
+				{
+					hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+				}
+				return hash ^ (hash >> 15);
+			}
+
+			//! Build the table of the given object.
+			ObjectTable BuildTable(const rapidjson::Value& object);
+
+			//! Resolve a JSON pointer from the root value, without the cache.
+			const rapidjson::Value* Resolve(const char* pointer, size_t length);
+		};
+	}
+}
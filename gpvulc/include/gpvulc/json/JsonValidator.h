@@ -0,0 +1,120 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include "RapidJsonParser.h"
+#include "JsonMapping.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		Validator for JSON documents, compiled once from a declarative specification
+		and applied to many documents, either to a DOM or while streaming the text.
+
+		The specification is a JSON text with a subset of JSON Schema keywords:
+		@code
+		{
+			"type": "object",
+			"required": [ "name", "size" ],
+			"properties": {
+				"name": { "type": "string", "minLength": 1 },
+				"size": { "type": "integer", "minimum": 0, "maximum": 1000 },
+				"weights": { "type": "array", "maxItems": 16, "items": { "type": "number" } }
+			}
+		}
+		@endcode
+		Supported keywords are: @c type ("object", "array", "string", "integer", "number",
+		"boolean", "null"; any type is accepted if missing), @c properties, @c required
+		(at most 64 required members for each object), @c items, @c minimum, @c maximum,
+		@c minItems, @c maxItems, @c minLength and @c maxLength (in bytes), other keywords are ignored.
+		Members not listed in @c properties are accepted without checks.
+
+		Errors are registered in the given RapidJsonParser as for its @c Get methods
+		(see CheckJsonErrors()): a missing required member is reported as ErrorType::MISSING_MEMBER,
+		a wrong type as ErrorType::WRONG_TYPE (or ErrorType::NOT_OBJECT, ErrorType::NOT_ARRAY),
+		a value out of range as ErrorType::INVALID_VALUE.
+		@note A compiled validator is never modified while validating:
+		it can be shared by threads, each using its own parser.
+		*/
+		class JsonValidator
+		{
+		public:
+
+			//! Constructor, the validator accepts any document until a specification is compiled.
+			JsonValidator();
+
+			//! Constructor compiling the given specification (see Compile()).
+			explicit JsonValidator(const std::string& specification);
+
+			//! Destructor
+			~JsonValidator();
+
+			/*!
+			Compile a specification, replacing the current one.
+			A FormatException is thrown if the specification is not valid.
+			*/
+			void Compile(const std::string& specification);
+
+			/*!
+			Validate a value (e.g. an element of the parsed document), registering errors in the parser
+			in the current context.
+			@return false if errors were registered.
+			*/
+			bool Validate(RapidJsonParser& parser, const rapidjson::Value& value) const;
+
+			//! Validate the document parsed by the given parser (see Validate(RapidJsonParser&, const rapidjson::Value&)).
+			bool Validate(RapidJsonParser& parser) const;
+
+			/*!
+			Validate a JSON text while reading it, without building the DOM,
+			registering errors in the parser (a ParseException is thrown if the text is not valid JSON).
+			@return false if errors were registered.
+			*/
+			bool ValidateStream(RapidJsonParser& parser, const char* jsonText, size_t length) const;
+
+		private:
+
+			JsonValidator(const JsonValidator&) = delete;
+			JsonValidator& operator=(const JsonValidator&) = delete;
+
+			struct Rule;
+			struct ValueName;
+			class StreamValidator;
+
+			//! Rules of the specification, the first one is the rule for the root value.
+			std::vector<std::unique_ptr<Rule>> Rules;
+
+			//! Compile the specification of a value into a rule, returning its index.
+			size_t CompileRule(const rapidjson::Value& spec, const std::string& path);
+
+			//! Throw a FormatException for an invalid specification.
+			static void SpecificationError(const std::string& path, const char* message);
+
+			//! Check a value against a rule, registering errors in the parser.
+			void CheckValue(RapidJsonParser& parser, const Rule& rule, const rapidjson::Value& value, const ValueName& name) const;
+
+			//! Register an error for the named value.
+			static void AddError(RapidJsonParser& parser, ErrorType errorType, const ValueName& name);
+
+			//! Register an error for a value of unexpected type.
+			static void TypeMismatch(RapidJsonParser& parser, const Rule& rule, const ValueName& name);
+
+			//! Register an error for a missing required member of an object.
+			static void MissingMembers(RapidJsonParser& parser, const Rule& rule, std::uint64_t seenMask, bool isRoot);
+		};
+	}
+}
@@ -0,0 +1,84 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace gpvulc
+{
+	namespace json
+	{
+		/*!
+		File mapped in memory, used to parse (large) files without copying them.
+
+		The content is always followed by a null character, so that it can be parsed
+		as a null terminated string (also in place, see RapidJsonParser::ParseInsitu()).
+		If the file cannot be mapped (e.g. on file systems not supporting it)
+		it is read in memory.
+		*/
+		class MappedFile
+		{
+		public:
+
+			//! Default constructor
+			MappedFile();
+
+			//! Destructor, calls Close()
+			~MappedFile();
+
+			/*!
+			Map the given file in memory, any previously mapped file is closed.
+			@param fileName path of the file
+			@param writable if true the content can be modified in memory
+			(copy-on-write, changes are never written to the file)
+			@return false if the file cannot be opened
+			*/
+			bool Open(const std::string& fileName, bool writable = false);
+
+			//! Unmap the file and release the memory.
+			void Close();
+
+			//! Check if a file was opened.
+			bool IsOpen() const { return Data != nullptr; }
+
+			//! Check if the file is mapped in memory (false if it was read in memory).
+			bool IsMapped() const { return Mapping != nullptr; }
+
+			//! Get the file content (null terminated), nullptr if no file was opened.
+			const char* GetData() const { return Data; }
+
+			//! Get the file content (null terminated), nullptr if not open or not writable.
+			char* GetWritableData() { return Writable ? Data : nullptr; }
+
+			//! Get the size of the file in bytes (excluding the final null character).
+			size_t GetSize() const { return Size; }
+
+		private:
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			char* Data = nullptr;
+			size_t Size = 0;
+			bool Writable = false;
+
+			//! Mapped memory region (nullptr if the file was read in memory)
+			void* Mapping = nullptr;
+			size_t MappingSize = 0;
+
+			//! Buffer used if the file cannot be mapped
+			std::vector<char> Buffer;
+
+			//! Read the whole file in Buffer.
+			bool ReadFile(const std::string& fileName);
+		};
+	}
+}
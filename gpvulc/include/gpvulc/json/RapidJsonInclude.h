@@ -60,6 +60,17 @@ namespace gpvulc
 				: std::runtime_error(description) {}
 		};
 
+		/*!
+		Exception thrown when the JSON document cannot be written to its destination.
+		*/
+		struct OutputException : std::runtime_error
+		{
+			OutputException()
+				: std::runtime_error("JSON output failed") {}
+			OutputException(const char* description)
+				: std::runtime_error(description) {}
+		};
+
 
 		inline std::string GetParseExceptionErrorMessage(const ParseException& parseException)
 		{
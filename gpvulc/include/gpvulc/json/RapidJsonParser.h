@@ -11,9 +11,17 @@
 
 
 #include "RapidJsonInclude.h" // Macro definitions for rapidjson
+#include "MappedFile.h"
+#include "ArenaAllocator.h"
+#include "ArenaDocument.h"
+#include "JsonBinaryCache.h"
+#include "JsonPathIndex.h"
 
 #include <rapidjson/document.h>     // rapidjson's DOM-style API
 
+#include <functional>
+#include <istream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -80,6 +88,10 @@ namespace gpvulc
 			return "";
 		}
 
+		struct JsonValueReader;
+		template <typename T> class JsonMapper;
+		class JsonValidator;
+
 		/*!
 		JSON parser based on rapidjson library (https://github.com/miloyip/rapidjson/).
 
@@ -90,6 +102,22 @@ namespace gpvulc
 		@c Get methods call AddJsonError() and return a value instead of throwing.
 		StartContext()/EndContext() methods must be used to get a meaningful
 		error summary if parsing errors occur.
+
+		Large documents can be parsed in streaming mode (see ParseStream()),
+		without building the DOM: handlers registered for member paths
+		are called while reading the document, errors are collected in the same way
+		(the context is tracked automatically).
+
+		The memory used for parsing (DOM, parsing stacks, error lists) is kept and reused
+		for the next documents, up to a maximum size (see SetMaxRetainedMemory()),
+		so that parsing many similar documents does not allocate memory.
+
+		Repeated lookups on large documents can be sped up enabling a hash index
+		of the members (see SetIndexing()), used by all the methods searching members.
+
+		A parser has no shared state: different threads can use different parsers at the same time
+		(the error summary, the index and the retained memory belong to each parser),
+		while a parser must be used by one thread at a time.
 		@note Any call to StartContext() must be matched by a a call to EndContext().
 		*/
 		class RapidJsonParser
@@ -99,6 +127,9 @@ namespace gpvulc
 			//! Default contructor
 			RapidJsonParser();
 
+			//! Destructor
+			~RapidJsonParser();
+
 			//! Check if the parsed document has the named root element.
 			bool HasRootElement(const char* name);
 
@@ -108,29 +139,48 @@ namespace gpvulc
 			//! Chech if at least one error occurred.
 			bool ErrorsOccurred();
 
-			//! Start a named parsing context, used to get a meaningful error summary.
+			/*!
+			Start a named parsing context, used to get a meaningful error summary.
+			@note Only the pointer is stored, the name must be valid until EndContext() is called
+			(e.g. a string literal or a member name of the parsed document).
+			*/
 			void StartContext(const char* name);
 
-			//! Start a named parsing context, used to get a meaningful error summary.
+			//! Start a named parsing context, used to get a meaningful error summary (the name is copied).
 			void StartContext(const std::string& name);
-			
+
+			//! Start a named parsing context, used to get a meaningful error summary (the name is copied).
+			void StartContext(const char* name, size_t length);
+
 			//! Start a numbered parsing context (e.g. for arrays), used to get a meaningful error summary.
-			void StartContext(size_t index)
-			{
-				StartContext(std::to_string(index));
-			}
+			void StartContext(size_t index);
 
 
 			//! End the last parsing context, used to get a meaningful error summary.
 			void EndContext();
 
 			/*!
-			Build and return a (static) string with an error summary.
-			@note The returned string is reallocated at each call,
-			so you should copy its value soon after calling this method.
+			Build and return a string with an error summary.
+			@note The returned string is stored in this parser and it is rebuilt at each call,
+			so you should copy its value before calling this method again on the same parser
+			(calls on different parsers do not interfere).
 			*/
 			const char* GetJsonErrorSummary(bool notNull = false);
 
+			/*!
+			Limit the number of recorded errors.
+			@param maxErrors maximum number of errors recorded (0 means no limit)
+			@param stopOnLimit if true, when the limit is reached a ContentException
+			with the error summary is thrown, stopping the parsing,
+			else further errors are only counted (see GetErrorCount()).
+			@note The contexts started by the parser methods (and by JsonValidator, JsonMapper)
+			are closed before the exception is propagated, the ones started by the caller are kept.
+			*/
+			void SetMaxErrors(size_t maxErrors, bool stopOnLimit = true);
+
+			//! Get the number of errors occurred, including the ones not recorded (see SetMaxErrors()).
+			size_t GetErrorCount() const { return ErrorList.size() + DiscardedErrors; }
+
 			/*!
 			Check if the given Value has the named member, if not optional an error is registered.
 			@param val input value
@@ -154,10 +204,31 @@ namespace gpvulc
 			@param name member name
 			@param optional if false (default) and the member is missing or it is not an array an error is registered.
 			*/
-			bool CheckHasArray(const rapidjson::Value& val, const char* name, bool optional = false)
-			{
-				return CheckHasMember(val, name, optional) &&CheckIsArray(val[name]);
-			}
+			bool CheckHasArray(const rapidjson::Value& val, const char* name, bool optional = false);
+
+			/*!
+			Enable or disable the index of the parsed document (see JsonPathIndex).
+			When enabled, member lookups build a hash table for each large object
+			the first time it is searched, so that further lookups do not depend on the number of members.
+			The index is cleared for each new document.
+			@param enable true to enable the index
+			@param minIndexedMembers objects with fewer members are searched directly
+			@note When the index is enabled the values passed to this parser must belong to the parsed document.
+			*/
+			void SetIndexing(bool enable, size_t minIndexedMembers = JsonPathIndex::DEFAULT_MIN_INDEXED_MEMBERS);
+
+			//! Check if the index of the parsed document is enabled.
+			bool IsIndexing() const { return Index != nullptr; }
+
+			//! Find the named member of the given Value, nullptr if missing or not an object (no error is registered).
+			const rapidjson::Value* FindMember(const rapidjson::Value& val, const char* name);
+
+			/*!
+			Find a value of the parsed document by JSON pointer, e.g. "/scene/objects/3/name"
+			(no error is registered), nullptr if not found.
+			If the index is enabled the results are cached.
+			*/
+			const rapidjson::Value* FindValue(const char* pointer);
 
 			/// @note An optional context can be provided for these methods,
 			/// used for error messages if available.
@@ -198,33 +269,280 @@ namespace gpvulc
 
 			/// @}
 
+			/// Read a whole array of numbers in a single pass, much faster than reading each element.
+			/// If the value is not an array or some elements have a different type
+			/// a single error is registered for the array (invalid elements are set to 0),
+			/// integer values are accepted for floating point arrays.
+			/// @name Array getters
+			/// @{
+
+			//! Get the given array as integer values, return false if an error occurred.
+			bool GetArray(const rapidjson::Value& val, std::vector<int>& values, const char* context = "");
+
+			//! Get the given array as floating point values, return false if an error occurred.
+			bool GetArray(const rapidjson::Value& val, std::vector<float>& values, const char* context = "");
+
+			//! Get the given array as double precision values, return false if an error occurred.
+			bool GetArray(const rapidjson::Value& val, std::vector<double>& values, const char* context = "");
+
+			/*!
+			Get the given array as integer values into a buffer of maxCount elements.
+			@return the number of elements of the array (only the first maxCount are stored).
+			*/
+			size_t GetArray(const rapidjson::Value& val, int* values, size_t maxCount, const char* context = "");
+
+			//! Get the given array as floating point values into a buffer (see GetArray(const rapidjson::Value&, int*, size_t, const char*)).
+			size_t GetArray(const rapidjson::Value& val, float* values, size_t maxCount, const char* context = "");
+
+			//! Get the given array as double precision values into a buffer (see GetArray(const rapidjson::Value&, int*, size_t, const char*)).
+			size_t GetArray(const rapidjson::Value& val, double* values, size_t maxCount, const char* context = "");
+
+			//! Get the named member of the given Value as an array of integer values.
+			bool GetAsArray(const rapidjson::Value& val, const char* name, std::vector<int>& values, bool optional = false);
+
+			//! Get the named member of the given Value as an array of floating point values.
+			bool GetAsArray(const rapidjson::Value& val, const char* name, std::vector<float>& values, bool optional = false);
+
+			//! Get the named member of the given Value as an array of double precision values.
+			bool GetAsArray(const rapidjson::Value& val, const char* name, std::vector<double>& values, bool optional = false);
+
+			/// @}
+
 			/*!
 			Reset the internal document and clear errors.
+			@note The allocated memory is kept for the next document (see SetMaxRetainedMemory()).
 			*/
 			void Reset();
 
+			/*!
+			Set the maximum amount of memory (bytes) kept after each document for the DOM
+			and for the parsing stacks (1 MB each by default), 0 to always release the memory.
+			*/
+			void SetMaxRetainedMemory(size_t maxBytes);
+
+			//! Get the amount of memory (bytes) currently kept for parsing the next documents.
+			size_t GetRetainedMemory() const;
+
 			//! Parse a JSON string into DOM data.
 			void Parse(const std::string& jsonText);
 
+			/*!
+			Parse a JSON text into DOM data in place (in situ):
+			strings are decoded inside the given buffer and DOM strings point to it, without copies.
+			@note The buffer is modified and it must be kept until the document is reset or parsed again.
+			*/
+			void ParseInsitu(char* jsonText);
+
+			/*!
+			Parse a JSON file into DOM data in place (see ParseInsitu()),
+			the file is mapped in memory (copy-on-write) until the document is reset or parsed again.
+			@return false if the file could not be opened.
+			*/
+			bool ParseFile(const std::string& fileName);
+
+			/*!
+			Load a JSON file from its binary cache (see JsonBinaryCache) if it is up to date,
+			else parse the file (see ParseFile()) and write the cache for the next loads
+			(the cache is optional: failures writing it are ignored).
+			Cached documents are mapped in memory, their strings are not copied.
+			@param fileName path of the JSON file
+			@param cacheFileName path of the cache file, if empty the extension JsonBinaryCache::DEFAULT_EXTENSION
+			is appended to the JSON file path
+			@return false if the file could not be opened.
+			*/
+			bool ParseFileCached(const std::string& fileName, const std::string& cacheFileName = "");
+
 			/*!
 			Check for errors and, if any, throw an exception with an error summary.
 			*/
 			void CheckJsonErrors();
 
+			/// Handlers called in streaming mode (see ParseStream()) for the values found at the given path.
+			/// A path is a list of member names separated by '/' (e.g. "scene/objects/*/name"),
+			/// starting from the root object, where '*' matches any member or array element.
+			/// If @c optional is false (default) and a named member along the path is missing
+			/// an error is registered (members below a '*' are checked in each matched element),
+			/// if a value has a different type an error is registered.
+			/// @name Streaming handlers
+			/// @{
+
+			//! Handler for integer values (an error is registered for integers out of the int range).
+			typedef std::function<void(int)> IntHandler;
+
+			//! Handler for single precision floating point values (integer values are accepted too).
+			typedef std::function<void(float)> FloatHandler;
+
+			//! Handler for double precision floating point values (integer values are accepted too).
+			typedef std::function<void(double)> DoubleHandler;
+
+			//! Handler for boolean values.
+			typedef std::function<void(bool)> BoolHandler;
+
+			//! Handler for string values (the string is valid only during the call).
+			typedef std::function<void(const char*, size_t)> StringHandler;
+
+			//! Handler for the beginning or the end of an object or an array.
+			typedef std::function<void()> ContainerHandler;
+
+			//! Add a handler for integer values found at the given path.
+			void AddIntHandler(const std::string& path, IntHandler handler, bool optional = false);
+
+			//! Add a handler for floating point values found at the given path.
+			void AddFloatHandler(const std::string& path, FloatHandler handler, bool optional = false);
+
+			//! Add a handler for double precision values found at the given path.
+			void AddDoubleHandler(const std::string& path, DoubleHandler handler, bool optional = false);
+
+			//! Add a handler for boolean values found at the given path.
+			void AddBoolHandler(const std::string& path, BoolHandler handler, bool optional = false);
+
+			//! Add a handler for string values found at the given path.
+			void AddStringHandler(const std::string& path, StringHandler handler, bool optional = false);
+
+			/*!
+			Add handlers called at the beginning and at the end of an object
+			(e.g. to start and store a record for each element of an array).
+			*/
+			void AddObjectHandler(
+				const std::string& path,
+				ContainerHandler startHandler,
+				ContainerHandler endHandler = nullptr,
+				bool optional = false);
+
+			//! Add handlers called at the beginning and at the end of an array.
+			void AddArrayHandler(
+				const std::string& path,
+				ContainerHandler startHandler,
+				ContainerHandler endHandler = nullptr,
+				bool optional = false);
+
+			//! Remove all the streaming handlers.
+			void ClearHandlers();
+
+			/// @}
+
+			/// Parse a document in streaming mode, calling the registered handlers,
+			/// without storing the document (memory usage does not depend on the document size).
+			/// Errors are collected as for the @c Get methods (see CheckJsonErrors()),
+			/// a ParseException is thrown if the document is not valid JSON.
+			/// @name Streaming parser
+			/// @{
+
+			//! Parse a JSON text in streaming mode.
+			void ParseStream(const char* jsonText, size_t length);
+
+			//! Parse a JSON text read from the given input stream in streaming mode.
+			void ParseStream(std::istream& jsonStream);
+
+			/*!
+			Parse a JSON file in streaming mode, reading it in blocks.
+			@return false if the file could not be opened.
+			*/
+			bool ParseFileStream(const std::string& fileName);
+
+			/// @}
+
 		protected:
 
+			//! Memory block reused by DocumentAllocator across documents
+			std::vector<char> DocumentArena;
+
+			//! Memory pool for the DOM, allocating from DocumentArena
+			std::unique_ptr<rapidjson::MemoryPoolAllocator<>> DocumentAllocator;
+
+			//! Memory for the parsing stacks, reused across documents
+			ArenaAllocator StackAllocator;
+
 			//! Internal document buffer
-			rapidjson::Document DocumentBuffer;
+			ArenaDocument DocumentBuffer;
+
+			//! File mapped in memory by ParseFile()
+			MappedFile DocumentFile;
+
+			//! Binary cache mapped in memory by ParseFileCached()
+			JsonBinaryCache DocumentCache;
+
+			//! Index of the parsed document (nullptr if disabled)
+			std::unique_ptr<JsonPathIndex> Index;
+
+			//! Release the DOM data, keeping the allocated memory for the next document.
+			void ClearDocument();
+
+			//! Resize DocumentArena and rebuild DocumentAllocator on it.
+			void ResizeDocumentArena(size_t size);
 
 			//! Add an error related to the last parsing context, called by @c Get methods.
 			void AddJsonError(ErrorType errorType, const std::string& elementName = "");
 
 		private:
 
-			std::vector<std::string> PathToMember;
+			// mapped types (see JsonMapping.h) register errors directly
+			friend struct JsonValueReader;
+			template <typename T> friend class JsonMapper;
+			friend class JsonValidator;
+
+			struct HandlerNode;
+			class StreamHandler;
+
+			/*!
+			Element of the path to the current member: a name or an array index.
+			The path is built only when an error is registered (see GetPathToMember()).
+			*/
+			struct ContextEntry
+			{
+				//! Name pointer (nullptr for copied names and indices)
+				const char* Name;
+				//! Array index or offset of the copied name in ContextNames
+				size_t Value;
+				bool IsIndex;
+			};
+
+			std::vector<ContextEntry> PathToMember;
+			//! Copied context names, null terminated
+			std::string ContextNames;
 			std::vector<ErrorInfo> ErrorList;
 
+			//! Error summary built by GetJsonErrorSummary()
+			std::string ErrorSummary;
+			size_t MaxErrors = 0;
+			bool StopOnMaxErrors = true;
+			//! Number of errors not recorded because of the limit
+			size_t DiscardedErrors = 0;
+
+			size_t MaxRetainedMemory = ArenaAllocator::DEFAULT_MAX_RETAINED_SIZE;
+
+			//! Tree of streaming handlers, indexed by member name
+			std::unique_ptr<HandlerNode> StreamHandlers;
+
+			//! SAX handler, kept to reuse its memory
+			std::unique_ptr<StreamHandler> Streamer;
+
+			//! Buffer for reading files in streaming mode
+			std::vector<char> StreamBuffer;
+
+			//! Get the node for the given path, creating the missing nodes.
+			HandlerNode& GetHandlerNode(const std::string& path, bool optional);
+
+			//! Parse the given stream with rapidjson SAX parser, calling the streaming handlers.
+			template <typename InputStream>
+			void ParseInputStream(InputStream& inputStream);
+
 			std::string GetPathToMember();
+
+			//! Read an array of numbers, registering a single error (see GetArray()).
+			template <typename T>
+			size_t ReadNumberArray(const rapidjson::Value& val, T* values, size_t maxCount, const char* context);
+
+			//! Read an array of numbers into a vector (see GetArray()).
+			template <typename T>
+			bool ReadNumberArray(const rapidjson::Value& val, std::vector<T>& values, const char* context);
+
+			//! Read the named member as an array of numbers (see GetAsArray()).
+			template <typename T>
+			bool ReadNumberArrayMember(const rapidjson::Value& val, const char* name, std::vector<T>& values, bool optional);
+
+			//! Remove the contexts started after the given number of contexts.
+			void RestoreContext(size_t depth);
 		};
 	}
 }
\ No newline at end of file
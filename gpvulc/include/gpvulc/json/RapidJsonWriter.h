@@ -10,25 +10,86 @@
 #pragma once
 
 #include "RapidJsonInclude.h" // Macro definitions for rapidjson
-#include "rapidjson/stringbuffer.h"
 #include "rapidjson/prettywriter.h"
 
 #include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
 
 namespace gpvulc
 {
 	namespace json
 	{
 
+		/*!
+		Output stream for rapidjson writers that stores the text in a std::string,
+		that can be moved out without copying its content (see RapidJsonWriter::EndDocument()).
+		*/
+		class StringOutputBuffer
+		{
+		public:
+
+			typedef char Ch;
+
+			//! Append a character (required by rapidjson writers).
+			void Put(char c) { Text.push_back(c); }
+
+			//! Nothing to do, the text is always stored in memory (required by rapidjson writers).
+			void Flush() {}
+
+			//! Make room for the given number of characters, growing the capacity geometrically.
+			void Reserve(size_t count)
+			{
+				if (Text.capacity() - Text.size() < count)
+				{
+					Text.reserve(std::max(Text.size() + count, Text.capacity() * 2));
+				}
+			}
+
+			//! Remove the content, keeping the allocated memory.
+			void Clear() { Text.clear(); }
+
+			//! Get the (null terminated) text.
+			const char* GetString() const { return Text.c_str(); }
+
+			//! Get the text length.
+			size_t GetSize() const { return Text.size(); }
+
+			//! Access the text (e.g. to swap it with another string).
+			std::string& GetText() { return Text; }
+
+		private:
+
+			std::string Text;
+		};
+
+
+		/// Overloads found by rapidjson writers (argument dependent lookup)
+		/// to write strings without checking the capacity for each character.
+		/// @{
+		inline void PutReserve(StringOutputBuffer& stream, size_t count) { stream.Reserve(count); }
+		inline void PutUnsafe(StringOutputBuffer& stream, char c) { stream.Put(c); }
+		/// @}
+
+
 		/*!
 		JSON document writer based on rapidjson library (https://github.com/miloyip/rapidjson/).
 
-		A StringBuffer and a PrettyWriter (provided by rapidjson library)
-		are used to build the document that can be copied to a string
-		with the CopyDocument() method.
+		A StringOutputBuffer and a PrettyWriter (provided by rapidjson library)
+		are used to build the document that can be moved to a string
+		with the EndDocument() method or copied with the CopyDocument() method.
+
+		A compact writer (no indentation and line breaks) can be selected with SetCompact().
+
+		The document can also be streamed to a std::ostream or a file descriptor (see StreamTo()):
+		the buffer is written out each time it exceeds the given chunk size,
+		so that large documents can be written using a bounded amount of memory.
 
 		@note This class is intended to be derived with a proper "Write" method
 		using the provided methods to build the JSON document.
+		@note In compact mode the CompactWriter member is used instead of Writer,
+		derived classes writing directly with rapidjson writers must use GetCompact() to choose.
 		@note Any call to StartDocument() must be matched by a call to EndDocument();
 		any call to StartObject() must be matched by a call to EndObject();
 		any call to StartArray() must be matched by a call to EndArray().
@@ -37,24 +98,72 @@ namespace gpvulc
 		{
 		public:
 
+			//! Default size of the chunks written to the output stream (see StreamTo()).
+			static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
 			//! Default constructor.
 			RapidJsonWriter();
 
 			//! Delete document content.
 			void ResetDocument();
 
-			//! Copy the JSON document to a string, called by EndDocument().
+			//! Copy the JSON document to a string.
 			void CopyDocument(std::string& jsonText);
 
+			/*!
+			Move the JSON document to a string without copying it, called by EndDocument().
+			The previous memory of jsonText is kept by the writer and reused for the next document.
+			*/
+			void MoveDocument(std::string& jsonText);
+
+			/*!
+			Select compact (true) or pretty (false, default) output.
+			@note Change this only before starting a document.
+			*/
+			void SetCompact(bool compact) { Compact = compact; }
+
+			//! Check if the compact output is selected (see SetCompact()).
+			bool GetCompact() const { return Compact; }
+
+			/*!
+			Stream the next documents to the given output stream,
+			writing the buffer out each time it exceeds the given size.
+			@note The stream must be valid until StopStreaming() is called.
+			*/
+			void StreamTo(std::ostream& outStream, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+			/*!
+			Stream the next documents to the given file descriptor (e.g. an open file or a socket),
+			writing the buffer out each time it exceeds the given size.
+			@note The file descriptor is not closed by this class.
+			@note An OutputException is thrown if writing fails.
+			*/
+			void StreamTo(int fileDescriptor, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+			//! Write out the buffered content and stop streaming, the next documents are kept in memory.
+			void StopStreaming();
+
+			//! Check if the output is streamed (see StreamTo()).
+			bool IsStreaming() const { return OutputStream != nullptr || OutputFile >= 0; }
+
+			//! Write the buffered content to the output stream or file (if streaming).
+			void FlushOutput();
+
 			//! Set the maximum number of decimal digits for the next floating point numbers.
 			void SetDecimalPrecision(int numDigits);
 
 			//! Start a new document, any previous content is removed.
 			void StartDocument();
 
-			//! Copy the JSON document to the given string and reset its content.
+			/*!
+			Move the JSON document to the given string and reset its content.
+			If the output is streamed the remaining content is written out and jsonText is cleared.
+			*/
 			void EndDocument(std::string& jsonText);
 
+			//! End the JSON document and write the remaining content to the output stream or file (see StreamTo()).
+			void EndDocument();
+
 			//! Start a new object, if a memberName is not null a key is previously created with that name.
 			void StartObject(const char* memberName = nullptr);
 
@@ -88,14 +197,84 @@ namespace gpvulc
 
 			/// @}
 
+			/// Write an array of numbers with a single call (much faster than writing each element),
+			/// if a memberName is not null a key is previously created with that name.
+			/// @name Writer methods for numeric arrays
+			/// @{
+
+			//! Write an array of integer values
+			void WriteArray(const char* memberName, const int* values, size_t count);
+
+			//! Write an array of floating point values (see SetDecimalPrecision())
+			void WriteArray(const char* memberName, const float* values, size_t count);
+
+			//! Write an array of double precision values (see SetDecimalPrecision())
+			void WriteArray(const char* memberName, const double* values, size_t count);
+
+			//! Write a vector of integer values
+			void WriteArray(const char* memberName, const std::vector<int>& values)
+			{
+				WriteArray(memberName, values.data(), values.size());
+			}
+
+			//! Write a vector of floating point values (see SetDecimalPrecision())
+			void WriteArray(const char* memberName, const std::vector<float>& values)
+			{
+				WriteArray(memberName, values.data(), values.size());
+			}
+
+			//! Write a vector of double precision values (see SetDecimalPrecision())
+			void WriteArray(const char* memberName, const std::vector<double>& values)
+			{
+				WriteArray(memberName, values.data(), values.size());
+			}
+
+			/// @}
+
 		protected:
 
 			//! Internal document buffer
-			rapidjson::StringBuffer Buffer;
+			StringOutputBuffer Buffer;
 
 			//! Internal document writer
-			rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer;
+			rapidjson::PrettyWriter<StringOutputBuffer> Writer;
+
+			//! Internal document writer for compact output
+			rapidjson::Writer<StringOutputBuffer> CompactWriter;
+
+			//! Write the buffer out if streaming and it exceeds the chunk size.
+			void CheckOutput()
+			{
+				if (Buffer.GetSize() >= ChunkSize)
+				{
+					FlushOutput();
+				}
+			}
+
+		private:
+
+			bool Compact = false;
+			std::ostream* OutputStream = nullptr;
+			int OutputFile = -1;
+			size_t ChunkSize = (size_t)-1;
+
+			//! Write an array of numbers (see WriteArray()).
+			template <typename T>
+			void WriteNumberArray(const char* memberName, const T* values, size_t count);
 
+			//! Call the given function with the selected writer.
+			template <typename Function>
+			void WithWriter(Function function)
+			{
+				if (Compact)
+				{
+					function(CompactWriter);
+				}
+				else
+				{
+					function(Writer);
+				}
+			}
 		};
 
 	}
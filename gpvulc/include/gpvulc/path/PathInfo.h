@@ -16,6 +16,7 @@
 #pragma once
 
 #include <stdio.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,8 @@ namespace gpvulc
 		Extension: txt
 		Full: C:/test/myfile.txt
 	  @endcode
+	   @note Some const methods update cached values (e.g. GetFullPath()):
+	   an instance can be used by only one thread at a time, copies can be given to other threads.
 	  */
 	class PathInfo
 	{
@@ -56,6 +59,8 @@ namespace gpvulc
 		Set the default directory separator to back slash (true) or slash (false)
 		@note The initial default is back slash on Windows, otherwise it is slash,
 		this setting affect only the new instances, not the existing paths.
+		It can be changed while other threads create paths, each new instance gets
+		either the previous or the new default.
 		*/
 		static void SetDefaultBackSlash(bool back);
 
@@ -226,7 +231,7 @@ namespace gpvulc
 		char mDirSep[2];
 
 		// Default directory separator for new paths
-		static char mDefaultDirSep;
+		static std::atomic<char> mDefaultDirSep;
 
 		// Initialization method called by constructors and Reset()
 		void Init();
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Keyword set
+/// @file KeywordSet.h
+/// @author Giovanni Paolo Vigano'
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gpvulc
+{
+
+	/// @addtogroup Text
+	/// @{
+
+	/*!
+	Set of keywords compiled once into a perfect hash table, optionally ignoring case (ASCII letters only).
+	Each keyword is identified by its index in the list given to Build(): a lookup computes one hash
+	of the searched string and compares it with one keyword only, regardless of the number of keywords.
+	Searches for a keyword at the beginning of a text check only the distinct lengths of the keywords.
+
+	Example:
+	@code
+	static const KeywordSet keywords({ "if", "else", "while", "for" });
+	int id = keywords.Find(token);
+	if (parser.CompareList(keywords)) ...
+	@endcode
+	*/
+	class KeywordSet
+	{
+
+	public:
+
+		//! Constructor, the set is empty until Build() is called.
+		KeywordSet() {}
+
+		//! Constructor building the set from the given keywords.
+		explicit KeywordSet(const std::vector<std::string>& keywords, bool caseInsensitive = false)
+		{
+			Build(keywords, caseInsensitive);
+		}
+
+		/*!
+		Build the set from the given keywords (empty and repeated keywords are ignored).
+		@param keywords list of keywords, their index is used as keyword identifier
+		@param caseInsensitive if true keywords are compared ignoring case
+		*/
+		void Build(const std::vector<std::string>& keywords, bool caseInsensitive = false);
+
+		//! Remove all the keywords.
+		void Clear();
+
+		//! Return true if keywords are compared ignoring case.
+		bool IsCaseInsensitive() const { return mCaseInsensitive; }
+
+		//! Return the number of keywords given to Build().
+		int GetSize() const { return (int)mKeywords.size(); }
+
+		//! Return true if the set has no keywords.
+		bool IsEmpty() const { return mKeywords.empty(); }
+
+		//! Return the keyword with the given identifier.
+		const std::string& GetKeyword(int id) const { return mKeywords[id]; }
+
+		/*!
+		Find the given string among the keywords.
+		@return the keyword identifier or -1 if not found.
+		*/
+		int Find(const char* str, size_t length) const;
+
+		/*!
+		Find the given string among the keywords.
+		@return the keyword identifier or -1 if not found.
+		*/
+		int Find(const std::string& str) const { return Find(str.data(), str.length()); }
+
+		//! Check if the given string is one of the keywords.
+		bool Contains(const std::string& str) const { return Find(str.data(), str.length()) >= 0; }
+
+		/*!
+		Find the longest keyword at the beginning of the given text.
+		@return the keyword identifier or -1 if the text does not start with a keyword.
+		*/
+		int FindPrefix(const char* text, size_t length) const;
+
+		//! Check if a keyword can start with the given character (to skip quickly the other characters).
+		bool IsFirstChar(char c) const { return mFirstChars[(unsigned char)c]; }
+
+	private:
+
+		//! Keywords in the order given to Build()
+		std::vector<std::string> mKeywords;
+
+		//! Table slots with keyword identifiers (-1 for empty slots), its size is a power of 2
+		std::vector<int> mSlots;
+
+		//! Hash seed (displacement) of each bucket of keywords, chosen to put them in empty slots
+		std::vector<std::uint32_t> mBucketSeeds;
+
+		//! Distinct keyword lengths, from the longest
+		std::vector<size_t> mLengths;
+
+		//! Characters that start at least one keyword
+		bool mFirstChars[256] = {};
+
+		bool mCaseInsensitive = false;
+
+		//! Compute the hash of a string (case folded if needed).
+		std::uint64_t Hash(const char* str, size_t length) const;
+
+		//! Compute the slot of a hash with the seed of its bucket.
+		size_t GetSlot(std::uint64_t hash, std::uint32_t seed) const;
+
+		//! Check if the given string is equal to the keyword with the given identifier.
+		bool Equal(int id, const char* str, size_t length) const;
+
+		//! Try to fill a table with the given number of slots, return false if it fails.
+		bool FillSlots(const std::vector<int>& ids, const std::vector<std::uint64_t>& hashes, size_t slotCount);
+	};
+
+	///@}
+
+}//namespace gpvulc
@@ -0,0 +1,107 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Line index
+/// @file LineIndex.h
+/// @author Giovanni Paolo Vigano'
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace gpvulc
+{
+
+	/// @addtogroup Text
+	/// @{
+
+	/*!
+	Index of the line starts of a text, mapping offsets to lines and vice versa.
+	The index is built scanning the text once, then the number of lines is returned in constant time
+	and lookups take logarithmic time. After an edit the index can be updated instead of built again
+	(see Update()).
+	Lines and offsets start from 0 and lines are counted as in TextBuffer::CountLines()
+	(a final newline does not start a new line).
+
+	Example:
+	@code
+	LineIndex index(text.StdString());
+	int line = index.GetLine(errorOffset);
+	int column = errorOffset - index.GetLineStart(line);
+	@endcode
+	*/
+	class LineIndex
+	{
+
+	public:
+
+		//! Constructor, the index is empty until Build() is called.
+		LineIndex() {}
+
+		//! Constructor building the index of the given text.
+		explicit LineIndex(const std::string& text) { Build(text); }
+
+		//! Build the index of the given text.
+		void Build(const std::string& text);
+
+		/*!
+		Update the index after an edit of the text.
+		@param text the edited text
+		@param offset position of the edit
+		@param removedLength number of characters removed at the given position
+		@param insertedLength number of characters inserted at the given position (in place of the removed ones)
+		*/
+		void Update(const std::string& text, int offset, int removedLength, int insertedLength);
+
+		//! Clear the index (IsBuilt() returns false).
+		void Clear();
+
+		//! Return true if the index was built.
+		bool IsBuilt() const { return mBuilt; }
+
+		//! Return the number of lines of the text.
+		int GetLineCount() const;
+
+		/*!
+		Return the line including the given offset (offsets after a final newline belong to the last line).
+		@return -1 if the offset is outside the text.
+		*/
+		int GetLine(int offset) const;
+
+		/*!
+		Return the offset of the first character of the given line.
+		@return -1 if the line does not exist.
+		*/
+		int GetLineStart(int line) const;
+
+		/*!
+		Get the line and the column of the given offset.
+		@return false if the offset is outside the text.
+		*/
+		bool GetLineAndColumn(int offset, int& line, int& column) const;
+
+	private:
+
+		//! Offset after each newline, the first line start (0) included
+		std::vector<int> mLineStarts;
+
+		int mTextLength = 0;
+
+		bool mBuilt = false;
+
+		//! Add the starts of the lines after the newlines found in the given range of the text.
+		static void FindLineStarts(const std::string& text, int begin, int end, std::vector<int>& lineStarts);
+	};
+
+	///@}
+
+}//namespace gpvulc
@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Buffered line reader
+/// @file LineReader.h
+/// @author Giovanni Paolo Vigano'
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace gpvulc
+{
+
+	/// @addtogroup Text
+	/// @{
+
+	/*!
+	Buffered line reader.
+	The input stream is read in large blocks and lines are returned as pointers
+	into the internal buffer, without copying them (newlines are searched with memchr(),
+	vectorized by most standard libraries). Lines split with a trailing backslash are joined
+	inside the buffer (see ReadSplitLine()).
+	Lines are returned without the newline character, as with std::getline()
+	(a carriage return before the newline is not removed).
+
+	Example:
+	@code
+	std::ifstream logFile("big.log", std::ios::binary);
+	LineReader reader(logFile);
+	const char* line;
+	size_t length;
+	while (reader.ReadLine(line, length))
+	{
+		...
+	}
+	@endcode
+	@note The stream is read ahead: it should not be read by others while the reader is used.
+	*/
+	class LineReader
+	{
+
+	public:
+
+		//! Default size of the blocks read from the stream.
+		static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+		/*!
+		Constructor.
+		@param inStream stream to read, it must be valid as long as the reader is used
+		@param blockSize size of the blocks read from the stream
+		(the buffer grows if a line is longer than a block)
+		*/
+		explicit LineReader(std::istream& inStream, size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+		/*!
+		Read the next line.
+		@param[out] line pointer to the first character of the line, valid until the next call
+		(the line is not null terminated)
+		@param[out] length length of the line
+		@return false if there are no more lines.
+		*/
+		bool ReadLine(const char*& line, size_t& length);
+
+		//! Read the next line and copy it into the given string (see ReadLine(const char*&, size_t&)).
+		bool ReadLine(std::string& line);
+
+		/*!
+		Read the next line, joining the following lines while it ends with a backslash
+		(the backslash is removed).
+		@param[out] line pointer to the first character of the joined line, valid until the next call
+		@param[out] length length of the joined line
+		@param skipSpaces if true spaces and tabs are removed at both ends of each line
+		@return false if there are no more lines.
+		*/
+		bool ReadSplitLine(const char*& line, size_t& length, bool skipSpaces = true);
+
+		//! Read the next split line and copy it into the given string (see ReadSplitLine(const char*&, size_t&, bool)).
+		bool ReadSplitLine(std::string& line, bool skipSpaces = true);
+
+		//! Return true if the last line read was terminated by a newline (false for the last line of a text without final newline).
+		bool NewlineFound() const { return mNewlineFound; }
+
+		//! Return the number of lines read so far (lines joined by ReadSplitLine() are counted separately).
+		size_t GetLineNumber() const { return mLineNumber; }
+
+		//! Return true if all the lines were read.
+		bool Eof() const { return mStreamEnded && mPos == mEnd; }
+
+	private:
+
+		LineReader(const LineReader&) = delete;
+		LineReader& operator=(const LineReader&) = delete;
+
+		std::istream& mInStream;
+
+		//! Buffer, not initialized
+		std::unique_ptr<char[]> mBuffer;
+
+		//! Size of the buffer
+		size_t mBufferSize = 0;
+
+		//! Size of the blocks read from the stream
+		size_t mBlockSize;
+
+		//! Start of the data not yet returned
+		size_t mPos = 0;
+
+		//! End of the data in the buffer
+		size_t mEnd = 0;
+
+		//! Start of the data that must be preserved when the buffer is refilled (the current line)
+		size_t mKeep = 0;
+
+		bool mStreamEnded = false;
+		bool mNewlineFound = false;
+		size_t mLineNumber = 0;
+
+		/*!
+		Find the next line in the buffer, reading from the stream if needed.
+		@param[out] begin position of the first character of the line in the buffer
+		@param[out] end position after the last character of the line in the buffer
+		@param[in,out] joinEnd end of the joined line, moved with the buffer content
+		@return false if there are no more lines.
+		*/
+		bool NextLine(size_t& begin, size_t& end, size_t& joinEnd);
+
+		/*!
+		Move the data from mKeep to the beginning of the buffer and read the next block from the stream.
+		@return the offset the data was moved by.
+		*/
+		size_t FillBuffer();
+
+		//! Remove spaces and tabs at both ends of the given range of the buffer.
+		void SkipSpaces(size_t& begin, size_t& end) const;
+	};
+
+	///@}
+
+}//namespace gpvulc
@@ -20,6 +20,7 @@
 
 namespace gpvulc
 {
+	class LineReader;
 
 	/// @addtogroup Text
 	/// @{
@@ -197,7 +198,7 @@ namespace gpvulc
 
 		/// Compare this string with another string (both TextBuffer and char* versions).
 		/// @note Null char pointers and empty strings are considered the same.
-		/// Compare functions return 0 if strings are equal, >0 if @c this>@c str and <0 if @c this<@c str.
+		/// Compare functions return 0 if strings are equal, 1 if @c this>@c str and -1 if @c this<@c str.
 		/// @name Comparison
 		//@{
 
@@ -367,6 +368,15 @@ namespace gpvulc
 		*/
 		std::string GetSubString(int beg, int end = -1) const;
 
+		/*!
+		 Get a substring beginning and ending at given positions into the given string
+		 (its memory is reused, no allocation is needed if its capacity is enough).
+		 @param beg beginning position
+		 @param end ending position, -1 means: "till the end"
+		 @param result string replaced with the substring
+		*/
+		void GetSubString(int beg, int end, std::string& result) const;
+
 		/*!
 		 Cutoff the beginning and/or the end of the string.
 		 @param beg beginning position
@@ -534,7 +544,7 @@ namespace gpvulc
 		//! Ckeck if the sting is empty.
 		bool IsEmpty() const { return mStdString.empty(); }
 
-		//! Count the lines in the text buffer.
+		//! Count the lines in the text buffer (the whole text is scanned, see LineIndex for repeated queries).
 		int CountLines() const;
 
 		/*!
@@ -694,6 +704,22 @@ namespace gpvulc
 		//! Read from a stream a line split into multiple lines with backslash and store it in this string.
 		bool ReadSplitLine(std::istream& inStream, bool skipSpaces = true, bool appendNewline = false, bool appendEofNewline = false);
 
+		/*!
+		Read a line with a buffered reader and store it in this string.
+		Unlike ReadLine(std::istream&, bool, bool) false is returned after the last line,
+		even if the text ends with a newline.
+		@param reader line reader, see LineReader
+		@param appendNewline if true a newline is appended if the line was terminated by a newline
+		@param appendEofNewline if true a newline is appended also to the last line of a text without final newline
+		*/
+		bool ReadLine(LineReader& reader, bool appendNewline = false, bool appendEofNewline = false);
+
+		//! Read a line with a buffered reader and append it to this string (see ReadLine(LineReader&, bool, bool)).
+		bool AppendLine(LineReader& reader, bool appendNewline = false, bool appendEofNewline = false);
+
+		//! Read with a buffered reader a line split into multiple lines with backslash and store it in this string (see ReadLine(LineReader&, bool, bool)).
+		bool ReadSplitLine(LineReader& reader, bool skipSpaces = true, bool appendNewline = false, bool appendEofNewline = false);
+
 		//! Write the text to an output stream.
 		bool Write(std::ostream& ostrm) const;
 
@@ -16,6 +16,8 @@
 #pragma once
 
 #include <gpvulc/text/TextBuffer.h>
+#include <gpvulc/text/LineIndex.h>
+#include <gpvulc/text/KeywordSet.h>
 
 #include <map>
 
@@ -97,6 +99,19 @@ namespace gpvulc
 		*/
 		bool CompareList(const std::vector<std::string>& referenceStrings) const;
 
+		/*!
+		Compare the remainder with the given keywords (the case sensitivity of the keyword set is used).
+		@return true if the remainder <B>starts</B> with one of the keywords.
+		*/
+		bool CompareList(const KeywordSet& keywords) const;
+
+		/*!
+		Compare the remainder with the given keywords (the case sensitivity of the keyword set is used).
+		@param keywordId set to the identifier of the longest keyword found
+		@return true if the remainder <B>starts</B> with one of the keywords.
+		*/
+		bool CompareList(const KeywordSet& keywords, int& keywordId) const;
+
 		/*!
 		Compare the remainder with the given string + one of the given characters.
 		@return true if the remainder <B>starts</B> with the given (sub)string followed by one of the characters from the given string.
@@ -167,6 +182,14 @@ namespace gpvulc
 		*/
 		bool ReachFirstAmong(const std::vector<std::string>& search_str);
 
+		/*!
+		Reach the first occurrence of one of the given keywords (the case sensitivity of the keyword set is used).
+		The text is scanned once, whatever the number of keywords.
+		@param keywords Set of keywords to search for
+		@return Store the skipped text, return false if no keyword is found
+		*/
+		bool ReachFirstAmong(const KeywordSet& keywords);
+
 		//! Skip characters from the given string (returns true if there are skipped characters).
 		bool Skip(const std::string& skipstr);
 
@@ -204,6 +227,22 @@ namespace gpvulc
 		//! Return the offset from the beginning of the parsed text.
 		int GetOffset();
 
+		/*!
+		Get line and column (both starting from 1) of the given offset, e.g. for error messages.
+		The line index is built at the first call and kept until the text is changed (see LineIndex).
+		@return false if the offset is outside the text.
+		*/
+		bool GetLineAndColumn(int offset, int& line, int& column) const;
+
+		//! Get line and column (both starting from 1) of the current position (see GetLineAndColumn()).
+		bool GetPosition(int& line, int& column) const { return GetLineAndColumn(mCurrPos, line, column); }
+
+		//! Return the number of lines of the text (using the line index, see GetLineAndColumn()).
+		int GetLineCount() const { return GetLineIndex().GetLineCount(); }
+
+		//! Return the line index of the text, built if needed.
+		const LineIndex& GetLineIndex() const;
+
 		//! Compare the last result with the given string.
 		bool ResultIs(const std::string& tag) const;
 
@@ -229,6 +268,9 @@ namespace gpvulc
 		//! Read the line from file.
 		bool ReadLine(std::istream& strm, bool appendNewline = false, bool appendEofNewline = false);
 
+		//! Read the line with a buffered reader (see TextBuffer::ReadLine(LineReader&, bool, bool)).
+		bool ReadLine(LineReader& reader, bool appendNewline = false, bool appendEofNewline = false);
+
 		//! Load the whole text from a file.
 		bool LoadFile(const std::string& filename);
 
@@ -274,6 +316,9 @@ namespace gpvulc
 		// Internal buffer for the whole text
 		TextBuffer mInputText;
 
+		// Line index of mInputText, built when needed and cleared when the text changes
+		mutable LineIndex mLineIndex;
+
 		// Internal buffer for parsing operations
 		TextBuffer mBuffer;
 
@@ -30,23 +30,93 @@ namespace gpvulc
 	/// @{
 
 
-	//! Convert the given string to lower case
+	/// @name ASCII case folding
+	/// Case conversion and comparison independent from the current locale:
+	/// only ASCII letters are converted, other bytes (e.g. UTF-8 sequences) are left unchanged.
+	/// Strings are processed 8 bytes at a time, using plain 64 bit integer operations.
+	//@{
+
+	//! Convert an ASCII character to lower case
+	inline char AsciiToLower(char c)
+	{
+		return (unsigned char)(c - 'A') < 26 ? (char)(c + ('a' - 'A')) : c;
+	}
+
+
+	//! Convert an ASCII character to upper case
+	inline char AsciiToUpper(char c)
+	{
+		return (unsigned char)(c - 'a') < 26 ? (char)(c - ('a' - 'A')) : c;
+	}
+
+
+	//! Check if a character is an ASCII letter
+	inline bool IsAsciiAlpha(char c)
+	{
+		return (unsigned char)((c | 0x20) - 'a') < 26;
+	}
+
+
+	//! Convert the given characters to lower case, in place
+	void AsciiLower(char* text, size_t length);
+
+
+	//! Convert the given characters to upper case, in place
+	void AsciiUpper(char* text, size_t length);
+
+
+	//! Copy the given characters converted to lower case to the destination (at least length characters)
+	void AsciiLowerCopy(const char* source, size_t length, char* dest);
+
+
+	//! Copy the given characters converted to upper case to the destination (at least length characters)
+	void AsciiUpperCopy(const char* source, size_t length, char* dest);
+
+
+	/*!
+	Compare the given characters ignoring case, without copying them.
+	@return 0 if equal, a negative value if text1 comes before text2, a positive value otherwise
+	(as with memcmp(), for lower case characters).
+	*/
+	int AsciiCaseCompare(const char* text1, const char* text2, size_t length);
+
+
+	//! Check if the given characters are equal ignoring case, without copying them
+	inline bool AsciiCaseEqual(const char* text1, const char* text2, size_t length)
+	{
+		return AsciiCaseCompare(text1, text2, length) == 0;
+	}
+
+
+	/*!
+	Find the first occurrence of a string ignoring case, starting at the given position
+	(see std::string::find()).
+	@return the position of the string or std::string::npos if not found.
+	*/
+	size_t AsciiCaseFind(const std::string& text, const std::string& str, size_t pos = 0);
+
+
+	/*!
+	Find the last occurrence of a string ignoring case, starting at or before the given position
+	(see std::string::rfind()).
+	@return the position of the string or std::string::npos if not found.
+	*/
+	size_t AsciiCaseRFind(const std::string& text, const std::string& str, size_t pos = std::string::npos);
+
+	//@}
+
+
+	//! Convert the given string to lower case (ASCII letters only)
 	inline void StrLower(std::string& str)
 	{
-		std::for_each(str.begin(), str.end(), [](char& c)
-		{
-			c = tolower(c);
-		});
+		AsciiLower(&str[0], str.size());
 	}
 
 
-	//! Convert the given string to upper case
+	//! Convert the given string to upper case (ASCII letters only)
 	inline void StrUpper(std::string& str)
 	{
-		std::for_each(str.begin(), str.end(), [](char& c)
-		{
-			c = toupper(c);
-		});
+		AsciiUpper(&str[0], str.size());
 	}
 
 
@@ -61,8 +131,8 @@ namespace gpvulc
 	//! Get the given string converted to lower case
 	inline std::string GetLowerStr(const std::string& str)
 	{
-		std::string lwrstr = str;
-		StrLower(lwrstr);
+		std::string lwrstr(str.size(), '\0');
+		AsciiLowerCopy(str.data(), str.size(), &lwrstr[0]);
 		return lwrstr;
 	}
 
@@ -70,8 +140,8 @@ namespace gpvulc
 	//! Get the given string converted to upper case
 	inline std::string GetUpperStr(const std::string& str)
 	{
-		std::string uprstr = str;
-		StrUpper(uprstr);
+		std::string uprstr(str.size(), '\0');
+		AsciiUpperCopy(str.data(), str.size(), &uprstr[0]);
 		return uprstr;
 	}
 
@@ -99,7 +169,7 @@ namespace gpvulc
 	{
 		if (caseInsensitive)
 		{
-			return GetLowerStr(str1) == GetLowerStr(str2);
+			return str1.size() == str2.size() && AsciiCaseEqual(str1.data(), str2.data(), str1.size());
 		}
 		return str1 == str2;
 	}
@@ -110,8 +180,7 @@ namespace gpvulc
 	{
 		for (const std::string& str : otherStr)
 		{
-			if ((caseInsensitive && GetLowerStr(str1) == GetLowerStr(str))
-				|| (!caseInsensitive && str1 == str))
+			if (StrEqual(str1, str, caseInsensitive))
 			{
 				return true;
 			}
@@ -165,25 +234,103 @@ namespace gpvulc
 	int StrDiffCount(const std::string& inputText1, const std::string& inputText2, int length = 0);
 
 
+	//! Encoding of a text file.
+	enum class TextEncoding
+	{
+		//! UTF-8 (or ASCII).
+		UTF8,
+		//! UTF-16 little endian (used by Windows).
+		UTF16LE,
+		//! UTF-16 big endian.
+		UTF16BE,
+	};
+
+
+	/*!
+	Detect the encoding of a text from its byte order mark (BOM).
+	@param data first bytes of the text (at least 3 bytes are needed to detect a UTF-8 BOM)
+	@param size number of bytes
+	@param[out] bomSize size of the byte order mark found (0 if not found)
+	@param defaultEncoding encoding returned if no byte order mark is found
+	@return the detected encoding
+	*/
+	TextEncoding DetectTextEncoding(const char* data, size_t size, size_t& bomSize, TextEncoding defaultEncoding = TextEncoding::UTF8);
+
+
+	/*!
+	Convert UTF-16 text to UTF-8, appending it to the given string.
+	Unpaired surrogates are replaced with U+FFFD. ASCII characters are converted 4 at a time.
+	@param data UTF-16 text (without byte order mark)
+	@param size size in bytes of the UTF-16 text
+	@param bigEndian true for UTF-16BE, false for UTF-16LE
+	@param[out] text the string where the converted text is appended
+	@param endOfText if false an incomplete character at the end of data is not converted,
+		to convert a text in blocks; if true it is replaced with U+FFFD
+	@return the number of converted bytes of data
+	*/
+	size_t Utf16ToUtf8(const char* data, size_t size, bool bigEndian, std::string& text, bool endOfText = true);
+
+
+	/*!
+	Convert UTF-8 text to UTF-16, appending it to the given string (as bytes).
+	Invalid UTF-8 bytes are replaced with U+FFFD. ASCII characters are converted 8 at a time.
+	@param text UTF-8 text
+	@param length length in bytes of the UTF-8 text
+	@param bigEndian true for UTF-16BE, false for UTF-16LE
+	@param[out] data the string where the converted text is appended
+	*/
+	void Utf8ToUtf16(const char* text, size_t length, bool bigEndian, std::string& data);
+
+
 	/*!
 	Load a text file from the given path to the given string.
+	The encoding is detected from the byte order mark, if any (UTF-8, UTF-16LE or UTF-16BE):
+	UTF-16 files are converted to UTF-8, the byte order mark is not included in the text.
 	@param path path name of the file
 	@param text the string to be read
 	@param append append the file content to the string
-	@param asUtf16 load the file as UTF-16 encoded
+	@param asUtf16 load the file as UTF-16 encoded if it has no byte order mark
 	@return false on error
 	*/
 	bool LoadText(const std::string& path, std::string& text, bool append = false, bool asUtf16 = false);
 
 
+	/*!
+	Load a text file from the given path to the given string, returning its encoding.
+	The text is loaded as by LoadText(path, text, append, asUtf16), the detected encoding
+	can be given to SaveText(path, text, encoding, writeBom) to save the file in the same encoding.
+	@param path path name of the file
+	@param text the string to be read
+	@param[out] encoding encoding of the file
+	@param[out] hasBom true if the file starts with a byte order mark
+	@param append append the file content to the string
+	@param asUtf16 load the file as UTF-16 encoded if it has no byte order mark
+	@return false on error
+	*/
+	bool LoadText(const std::string& path, std::string& text, TextEncoding& encoding, bool& hasBom, bool append = false, bool asUtf16 = false);
+
+
 	/*!
 	Save a string to a text file at the given path.
 	@param path Path name of the file
 	@param text the string to be written
 	@param append append the string to the file content
+	@param asUtf16 save the file as UTF-16LE with a byte order mark (UTF-8 text is converted)
 	@return false on error
 	*/
-	bool SaveText(const std::string& path, const std::string& text, bool append = false);
+	bool SaveText(const std::string& path, const std::string& text, bool append = false, bool asUtf16 = false);
+
+
+	/*!
+	Save a UTF-8 string to a text file at the given path with the given encoding.
+	@param path Path name of the file
+	@param text the string to be written
+	@param encoding encoding of the file (UTF-8 text is converted to UTF-16 if needed)
+	@param writeBom write the byte order mark (only at the beginning of the file)
+	@param append append the string to the file content
+	@return false on error
+	*/
+	bool SaveText(const std::string& path, const std::string& text, TextEncoding encoding, bool writeBom, bool append = false);
 
 
 	/*!
@@ -197,8 +344,12 @@ namespace gpvulc
 
 
 	/*!
-	Load a UTF-16 text file from the given stream to the given string.
-	@param textStream text input stream
+	Load a UTF-16 text file from the given stream to the given string, converting it to UTF-8.
+	The byte order is detected from the byte order mark, if missing it is little endian,
+	unless the text starts with an ASCII character in big endian order.
+	If a UTF-8 byte order mark is found the text is read as UTF-8.
+	The stream is read in blocks, converted directly into the string.
+	@param textStream text input stream (opened in binary mode)
 	@param[out] text the string to be read
 	@param append append the read text to the string
 	@return false on error
@@ -214,6 +365,17 @@ namespace gpvulc
 	*/
 	bool WriteText(std::ostream& textStream, const std::string& text);
 
+
+	/*!
+	Save a UTF-8 string to a stream as UTF-16.
+	@param textStream text output stream (opened in binary mode)
+	@param[in] text the string to be written
+	@param bigEndian true for UTF-16BE, false for UTF-16LE
+	@param writeBom write the byte order mark before the text
+	@return false on error
+	*/
+	bool WriteText16(std::ostream& textStream, const std::string& text, bool bigEndian = false, bool writeBom = true);
+
 	///@}
 
 }//namespace gpvulc
@@ -0,0 +1,134 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Bulk date/time conversion
+/// @file DateTimeBatch.h
+/// @author Giovanni Paolo Vigano'
+
+#pragma once
+
+#include "gpvulc/time/DateTimeUtil.h"
+#include "gpvulc/time/TimeStamp.h"
+
+#include <string>
+
+namespace gpvulc
+{
+
+	/// @addtogroup Time
+	/// @{
+
+	/// Functions processing arrays of date/time values (e.g. columns of log records).
+	/// Input and output arrays are given as pointer and number of elements,
+	/// output arrays must be allocated by the caller.
+	/// The work can be split among the given number of threads
+	/// (0 means one thread per hardware core), small arrays are always processed by the calling thread.
+	/// @name Bulk conversion
+	//@{
+
+	/*!
+	Parse an array of ISO-8601 strings (see DateTimeParse()) into time stamps.
+	Canonical strings (YYYY-MM-DDTHH:MM:SS[.mmm][Z]) are parsed with a fixed-width fast path.
+	@param texts input strings
+	@param count number of elements
+	@param[out] timeStamps output time stamps (invalid strings produce a zero time stamp)
+	@param[out] errors if not null the parsing result of each string is stored here
+	@param numThreads number of threads used for the conversion
+	@return the number of strings successfully parsed
+	*/
+	size_t ParseTimeStamps(
+		const std::string* texts,
+		size_t count,
+		TimeStamp* timeStamps,
+		DateTimeParseError* errors = nullptr,
+		unsigned numThreads = 1);
+
+	/*!
+	Parse a column of fixed-size text fields into time stamps.
+	Each field is stored at @c stride bytes from the previous one
+	and ends at the first null character (or after @c stride characters).
+	@see ParseTimeStamps(const std::string*, size_t, TimeStamp*, DateTimeParseError*, unsigned)
+	*/
+	size_t ParseTimeStamps(
+		const char* column,
+		size_t stride,
+		size_t count,
+		TimeStamp* timeStamps,
+		DateTimeParseError* errors = nullptr,
+		unsigned numThreads = 1);
+
+	/*!
+	Format an array of time stamps as ISO-8601 strings (see DateTimeFormat()),
+	reusing the capacity of the output strings.
+	*/
+	void FormatTimeStamps(
+		const TimeStamp* timeStamps,
+		size_t count,
+		std::string* texts,
+		unsigned numThreads = 1);
+
+	/*!
+	Format an array of time stamps as ISO-8601 strings into a column of fixed-size fields
+	(see DateTimeFormat()), each field is null terminated and stored at @c stride bytes from the previous one.
+	@note A stride of DATETIME_STRING_MAX bytes is always enough.
+	@return the number of time stamps successfully formatted (fields that do not fit are left empty).
+	*/
+	size_t FormatTimeStamps(
+		const TimeStamp* timeStamps,
+		size_t count,
+		char* column,
+		size_t stride,
+		unsigned numThreads = 1);
+
+	//! Convert an array of date/time to time stamps.
+	void DateTimesToTimeStamps(const DateTime* dateTimes, size_t count, TimeStamp* timeStamps, unsigned numThreads = 1);
+
+	//! Convert an array of time stamps to date/time.
+	void TimeStampsToDateTimes(const TimeStamp* timeStamps, size_t count, DateTime* dateTimes, unsigned numThreads = 1);
+
+	/*!
+	Calculate the distances in milliseconds between pairs of time stamps:
+	distancesMs[i] = timeStamps2[i] - timeStamps1[i].
+	*/
+	void TimeStampDistancesMs(
+		const TimeStamp* timeStamps1,
+		const TimeStamp* timeStamps2,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads = 1);
+
+	/*!
+	Calculate the distances in milliseconds between adjacent time stamps:
+	distancesMs[i] = timeStamps[i+1] - timeStamps[i], for i in [0, count-1).
+	@note The output array must contain at least count-1 elements.
+	*/
+	void TimeStampAdjacentDistancesMs(
+		const TimeStamp* timeStamps,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads = 1);
+
+	/*!
+	Calculate the distances in milliseconds between adjacent date/time (see DateTimeDistanceMs()):
+	distancesMs[i] = DateTimeDistanceMs(dateTimes[i], dateTimes[i+1]), for i in [0, count-1).
+	@note The output array must contain at least count-1 elements.
+	*/
+	void DateTimeAdjacentDistancesMs(
+		const DateTime* dateTimes,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads = 1);
+
+	//@}
+
+	///@}
+
+}//namespace gpvulc
@@ -25,12 +25,98 @@ namespace gpvulc
 	/// @addtogroup Time
 	/// @{
 
+	//! Size of a buffer large enough for any string written by DateTimeFormat() (null terminator included).
+	const size_t DATETIME_STRING_MAX = 33;
+
+	//! Error detected while parsing a date/time string.
+	enum class DateTimeParseError
+	{
+		//! No error.
+		NONE,
+		//! The given text is empty.
+		EMPTY,
+		//! Malformed date (YYYY-MM-DD expected).
+		BAD_DATE,
+		//! Malformed time (HH:MM[:SS] expected).
+		BAD_TIME,
+		//! Malformed fraction of second.
+		BAD_FRACTION,
+		//! Malformed UTC offset.
+		BAD_OFFSET,
+		//! A field is out of its valid range.
+		OUT_OF_RANGE,
+		//! Unexpected characters after the date/time.
+		TRAILING_CHARS,
+	};
+
+	//! Convert a DateTimeParseError to a string.
+	const char* DateTimeParseErrorToString(DateTimeParseError parseError);
+
+	/*!
+	Write a date/time to the given buffer in ISO-8601 format (YYYY-MM-DDTHH:MM:SS[.mmm][UTC+hh:mm]).
+	Milliseconds and UTC offset are written only if not zero.
+	@note This function does not allocate memory and can be safely called from different threads.
+	@param dateTime date/time to be written
+	@param buffer destination buffer (null terminated, empty on error)
+	@param bufferSize size of the destination buffer (DATETIME_STRING_MAX is always enough)
+	@return the number of characters written (null terminator excluded),
+	0 if the buffer is too small or the date/time cannot be represented.
+	*/
+	size_t DateTimeFormat(const DateTime& dateTime, char* buffer, size_t bufferSize);
+
+	/*!
+	Write a date/time to the given string in ISO-8601 format, reusing the string capacity.
+	@see DateTimeFormat(const DateTime&, char*, size_t)
+	*/
+	void DateTimeFormat(const DateTime& dateTime, std::string& str);
+
+	/*!
+	Parse an ISO-8601 date/time from the given characters.
+	The accepted format is YYYY-MM-DD[(T| )HH:MM[:SS[.fff]]][offset],
+	where offset can be "Z" or a signed hours and minutes value (+hh:mm, +hhmm, +hh),
+	optionally prefixed by "UTC" (as written by DateTimeFormat()).
+	If the month is zero the date/time is considered as a time counter (no date validation).
+	@note This function does not allocate memory and can be safely called from different threads.
+	@param text characters to be parsed (a null terminator is not required)
+	@param length number of characters to be parsed
+	@param[out] dateTime parsed date/time (week day included), left unchanged on error
+	@param[out] errorPos if not null it is set to the position of the first invalid character
+	@return DateTimeParseError::NONE on success, otherwise the type of error
+	*/
+	DateTimeParseError DateTimeParse(const char* text, size_t length, DateTime& dateTime, size_t* errorPos = nullptr);
+
+	/*!
+	Parse an ISO-8601 date/time from the given string (see DateTimeParse()).
+	@return the parsed date/time or an invalid date/time on error.
+	*/
 	DateTime StringToDateTime(const std::string& timeString);
 
+	/*!
+	Convert a date/time to an ISO-8601 string (see DateTimeFormat()).
+	@note The returned string is stored per thread and overwritten by the next call in the same thread.
+	*/
 	const std::string& DateTimeToString(const DateTime& dateTime);
 
+	/*!
+	Convert a date/time to an ISO-8601 C string (see DateTimeFormat()).
+	@note The returned string is stored per thread and overwritten by the next call in the same thread.
+	*/
 	const char* DateTimeToCString(const DateTime& dateTime);
 
+	/*!
+	Convert a date/time to milliseconds since 1970-01-01T00:00:00 UTC (the UTC offset is taken into account).
+	@note The date must be valid (time counters with zero month are not supported).
+	*/
+	long long DateTimeToEpochMs(const DateTime& dateTime);
+
+	/*!
+	Convert milliseconds since 1970-01-01T00:00:00 UTC to a date/time.
+	@param epochMs milliseconds since 1970-01-01T00:00:00 UTC
+	@param offsetMinutes UTC offset (in minutes) of the resulting date/time
+	@param isDST daylight savings time flag of the resulting date/time
+	*/
+	DateTime EpochMsToDateTime(long long epochMs, int offsetMinutes = 0, bool isDST = false);
+
 	//! Calculate the time in milliseconds between two date/time
 	long long DateTimeDistanceMs(const DateTime& dateTime1, const DateTime& dateTime2);
 
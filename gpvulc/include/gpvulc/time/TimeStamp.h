@@ -0,0 +1,148 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Compact time stamp
+/// @file TimeStamp.h
+/// @author Giovanni Paolo Vigano'
+
+#pragma once
+
+#include "gpvulc/time/DateTime.h"
+
+namespace gpvulc
+{
+
+	/// @addtogroup Time
+	/// @{
+
+	/*!
+	Compact date/time: milliseconds since 1970-01-01T00:00:00 UTC,
+	UTC offset and daylight savings time flag packed into a single 64 bit integer.
+
+	The higher 56 bits store the milliseconds (covering more than a million years),
+	the lower 8 bits store the UTC offset in quarters of hour and the DST flag.
+	This is a trivially copyable type with the size of a 64 bit integer,
+	conversions to and from DateTime (see ToDateTime(), FromDateTime())
+	are lossless for offsets multiple of 15 minutes (as all the time zones in use).
+
+	Comparison operators compare the instants (UTC), regardless of the offset.
+	*/
+	class TimeStamp
+	{
+	public:
+
+		//! Default constructor: 1970-01-01T00:00:00 UTC.
+		TimeStamp() {}
+
+		/*!
+		Construct a time stamp from milliseconds since 1970-01-01T00:00:00 UTC, UTC offset (minutes) and DST flag.
+		The offset is rounded to the nearest quarter of hour and limited to [-16:00, +15:45] (see IsValidOffset()).
+		*/
+		explicit TimeStamp(long long epochMs, int offsetMinutes = 0, bool isDST = false)
+			: Value(epochMs * MS_SCALE + PackInfo(offsetMinutes, isDST))
+		{
+		}
+
+		//! Build a time stamp from a date/time (a valid date is required, see DateTimeToEpochMs()).
+		static TimeStamp FromDateTime(const DateTime& dateTime);
+
+		//! Build a time stamp from a value returned by GetRawValue().
+		static TimeStamp FromRawValue(long long rawValue) { TimeStamp t; t.Value = rawValue; return t; }
+
+		//! Convert this time stamp to a date/time.
+		DateTime ToDateTime() const;
+
+		//! Get the milliseconds since 1970-01-01T00:00:00 UTC.
+		long long GetEpochMs() const { return Value >> INFO_BITS; }
+
+		//! Get the UTC offset in minutes.
+		int GetOffsetMinutes() const { return ((int)(Value & OFFSET_MASK) - OFFSET_BIAS) * 15; }
+
+		//! Check the daylight savings time flag.
+		bool IsDST() const { return (Value & DST_FLAG) != 0; }
+
+		//! Get the milliseconds since 1970-01-01T00:00 in local time (the UTC offset is applied).
+		long long GetLocalEpochMs() const { return GetEpochMs() + GetOffsetMinutes() * 60000LL; }
+
+		//! Get the packed value (sorting raw values orders by instant, then by offset).
+		long long GetRawValue() const { return Value; }
+
+		/*!
+		Change the UTC offset (in minutes) and DST flag, keeping the same instant.
+		@return false if the offset cannot be stored exactly (see IsValidOffset()), the time stamp is left unchanged.
+		*/
+		bool SetOffset(int offsetMinutes, bool isDST = false)
+		{
+			if (!IsValidOffset(offsetMinutes))
+			{
+				return false;
+			}
+			Value = (Value & ~INFO_MASK) | PackInfo(offsetMinutes, isDST);
+			return true;
+		}
+
+		//! Check if a UTC offset (in minutes) can be stored exactly: a multiple of 15 minutes in [-16:00, +15:45].
+		static bool IsValidOffset(int offsetMinutes)
+		{
+			return offsetMinutes % 15 == 0 && offsetMinutes >= -OFFSET_BIAS * 15 && offsetMinutes < OFFSET_BIAS * 15;
+		}
+
+		/// Arithmetic operators (milliseconds).
+		/// @name Arithmetic
+		//@{
+
+		TimeStamp& operator +=(long long ms) { Value += ms * MS_SCALE; return *this; }
+		TimeStamp& operator -=(long long ms) { Value -= ms * MS_SCALE; return *this; }
+		TimeStamp operator +(long long ms) const { TimeStamp t(*this); t += ms; return t; }
+		TimeStamp operator -(long long ms) const { TimeStamp t(*this); t -= ms; return t; }
+
+		//! Get the distance in milliseconds between two time stamps.
+		long long operator -(const TimeStamp& t) const { return GetEpochMs() - t.GetEpochMs(); }
+
+		//@}
+
+		/// Compare the instants of two time stamps (the UTC offset is ignored).
+		/// @name Comparison operators
+		//@{
+
+		bool operator ==(const TimeStamp& t) const { return GetEpochMs() == t.GetEpochMs(); }
+		bool operator !=(const TimeStamp& t) const { return GetEpochMs() != t.GetEpochMs(); }
+		bool operator <(const TimeStamp& t) const { return GetEpochMs() < t.GetEpochMs(); }
+		bool operator >(const TimeStamp& t) const { return GetEpochMs() > t.GetEpochMs(); }
+		bool operator <=(const TimeStamp& t) const { return GetEpochMs() <= t.GetEpochMs(); }
+		bool operator >=(const TimeStamp& t) const { return GetEpochMs() >= t.GetEpochMs(); }
+
+		//@}
+
+	private:
+
+		static const int INFO_BITS = 8;
+		static const long long MS_SCALE = 1LL << INFO_BITS;
+		static const long long INFO_MASK = MS_SCALE - 1;
+		static const long long OFFSET_MASK = 0x7F;
+		static const long long DST_FLAG = 0x80;
+		static const int OFFSET_BIAS = 64;
+
+		//! Pack UTC offset (rounded to quarters of hour, out of range values are limited) and DST flag into the lower bits.
+		static long long PackInfo(int offsetMinutes, bool isDST)
+		{
+			int quarters = (offsetMinutes + (offsetMinutes < 0 ? -7 : 7)) / 15;
+			quarters = quarters < -OFFSET_BIAS ? -OFFSET_BIAS : (quarters >= OFFSET_BIAS ? OFFSET_BIAS - 1 : quarters);
+			return (long long)((quarters + OFFSET_BIAS) & OFFSET_MASK) | (isDST ? (long long)DST_FLAG : 0LL);
+		}
+
+		// the default value has a zero UTC offset
+		long long Value = OFFSET_BIAS;
+	};
+
+	///@}
+
+}//namespace gpvulc
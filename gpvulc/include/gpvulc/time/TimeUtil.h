@@ -21,6 +21,7 @@
 /// @author Giovanni Paolo Vigano'
 
 #include "gpvulc/time/DateTime.h"
+#include "gpvulc/time/TimeStamp.h"
 
 #include <string>
 
@@ -41,7 +42,7 @@ namespace gpvulc
 	};
 
 
-	//! Get the current time in microseconds (since the first call).
+	//! Get the current time in microseconds (since the first call in any thread).
 	long long GetRunTimeMicroseconds();
 
 	//! Get the current time in milliseconds (since the first call).
@@ -50,9 +51,53 @@ namespace gpvulc
 	//! Get the current time in seconds (since the first call).
 	double GetRunTimeSeconds();
 
-	//! Get current time and date
+	//! Get the current system time in milliseconds since 1970-01-01T00:00:00 UTC.
+	long long GetEpochMilliseconds();
+
+	/*!
+	Get the current system time in milliseconds since 1970-01-01T00:00:00 UTC,
+	reading a low-cost clock with a coarser resolution (the system tick, usually 1-4 ms),
+	where available (otherwise this is the same as GetEpochMilliseconds()).
+	*/
+	long long GetEpochMillisecondsCoarse();
+
+	/*!
+	Get the local UTC offset (minutes) at the given time (milliseconds since 1970-01-01T00:00:00 UTC).
+	The offset and daylight savings time state are cached for each thread and refreshed only
+	when the given time falls outside the period in which they were found constant
+	(up to one day, ending at the next time zone transition).
+	@param epochMs time in milliseconds since 1970-01-01T00:00:00 UTC
+	@param[out] isDST if not null it is set to true if daylight savings time is in effect
+	@return the UTC offset in minutes
+	*/
+	int GetUtcOffsetMinutes(long long epochMs, bool* isDST = nullptr);
+
+	/*!
+	Discard the cached UTC offset (see GetUtcOffsetMinutes()) in all threads,
+	call this function after changing the system time zone.
+	*/
+	void ResetUtcOffsetCache();
+
+	/*!
+	Get current time and date (local time and daylight savings time flag).
+	The UTC offset is not set, thus DateTimeToString() writes only the local time
+	(use GetDateTimeNowWithOffset() to get also the UTC offset).
+	*/
 	DateTime GetDateTimeNow();
 
+	//! Get current time and date reading a low-cost clock (see GetEpochMillisecondsCoarse()), without UTC offset.
+	DateTime GetDateTimeNowCoarse();
+
+	/*!
+	Get current time and date (local time, with UTC offset and daylight savings time flag),
+	optionally reading a low-cost clock (see GetEpochMillisecondsCoarse()).
+	DateTimeToString() writes the UTC offset after the local time (e.g. 2021-03-28T03:00:00UTC+02:00).
+	*/
+	DateTime GetDateTimeNowWithOffset(bool coarse = false);
+
+	//! Get a time stamp with the current time and the local UTC offset, optionally using the low-cost clock.
+	TimeStamp GetTimeStampNow(bool coarse = false);
+
 	//! Get a long identifier based on system time and date
 	long GetSystemTimeStamp();
 
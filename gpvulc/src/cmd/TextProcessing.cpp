@@ -32,9 +32,11 @@ namespace gpvulc
 		)
 	{
 		std::string srcText;
+		TextEncoding encoding = TextEncoding::UTF8;
+		bool hasBom = false;
 
 		std::cout << exePath.GetName() << ": Loading " << srcFilePath.GetFullPath() << std::endl;
-		if (!LoadText(srcFilePath.GetFullPath(), srcText, false, asUtf16))
+		if (!LoadText(srcFilePath.GetFullPath(), srcText, encoding, hasBom, false, asUtf16))
 		{
 			std::cerr << exePath.GetName() << ": error reading " << srcFilePath.GetFullPath() << std::endl;
 			return false;
@@ -46,7 +48,8 @@ namespace gpvulc
 		bool changed = changesCount > 0U && outSrcText != srcText;
 
 
-		if (changed && !SaveText(srcOutFilePath.GetFullPath(), outSrcText))
+		// files are saved with the same encoding and byte order mark
+		if (changed && !SaveText(srcOutFilePath.GetFullPath(), outSrcText, encoding, hasBom))
 		{
 			std::cerr << exePath.GetName() << ": error writing " << srcOutFilePath.GetFullPath() << std::endl;
 			return false;
@@ -15,15 +15,11 @@
 
 namespace gpvulc
 {
-	std::shared_ptr<MessageLogger> MessageLogger::GlobalLogger;
-
 	std::shared_ptr<MessageLogger> MessageLogger::GetGlobalLogger()
 	{
-		if (!GlobalLogger)
-		{
-			GlobalLogger = std::shared_ptr<MessageLogger>(new MessageLogger());
-		}
-		return GlobalLogger;
+		// thread-safe initialization, no lock after the first call
+		static const std::shared_ptr<MessageLogger> globalLogger(new MessageLogger());
+		return globalLogger;
 	}
 
 	void MessageLogger::LogMessage(
@@ -60,11 +56,12 @@ namespace gpvulc
 				// TODO: replace standard streams with a shared string buffer?
 				//ErrorList += prefix + " [" + category + "] " + message + "\n";
 
-				std::cerr << prefix << " [" << category << "] " << message << std::endl;
+				// each message is written at once, not mixed with messages of other threads
+				std::cerr << (prefix + " [" + category + "] " + message + "\n") << std::flush;
 			}
 			else
 			{
-				std::cout << "[" << category << "] " << message << std::endl;
+				std::cout << ("[" + category + "] " + message + "\n") << std::flush;
 			}
 		}
 	}
@@ -60,10 +60,21 @@
 #define stat64_struct stat
 #define stat64_func stat
 
+#define _S_IFDIR S_IFDIR
+#define _utimbuf utimbuf
+#define _utime utime
+#define _access access
+
 #endif
 
+#ifdef _WIN32
 #include <sys/utime.h>
+#else
+#include <sys/stat.h>
+#include <utime.h>
+#endif
 
+#include <ctime>
 #include <iostream>
 
 #include <boost/filesystem.hpp>
@@ -106,6 +117,7 @@ namespace gpvulc
 		}
 
 
+#ifdef _WIN32
 		std::string GetOpErrorString(int code)
 		{
 			switch (code)
@@ -181,6 +193,7 @@ namespace gpvulc
 			src_path_list += '\0';
 			return src_path_list;
 		}
+#endif
 
 	}
 
@@ -200,6 +213,7 @@ namespace gpvulc
 		Buffer = nullptr;
 		BufferSize = 0;
 		BufferOwned = false;
+		ResetInfo();
 	}
 
 
@@ -342,20 +356,28 @@ namespace gpvulc
 			dt.IsDST = tmDt.tm_isdst != 0;
 		};
 
+		// std::localtime() returns a shared buffer, the reentrant versions are used instead
+		auto LocalTime = [](std::time_t t, std::tm& tmDt)
+		{
 #ifdef _MSC_VER
-		// disable the unsafe warning
-#pragma warning( push )
-#pragma warning( disable : 4996 )
-#endif
-		std::tm* localCreationTime = std::localtime(&stbuf.st_ctime);
-		std::tm* localAccessTime = std::localtime(&stbuf.st_atime);
-		std::tm* localModificationTime = std::localtime(&stbuf.st_mtime);
-#ifdef _MSC_VER
-#pragma warning( pop )
+			return localtime_s(&tmDt, &t) == 0;
+#else
+			return localtime_r(&t, &tmDt) != nullptr;
 #endif
-		DateTimeToTm(*localCreationTime, CreationTime);
-		DateTimeToTm(*localModificationTime, WriteTime);
-		DateTimeToTm(*localAccessTime, AccessTime);
+		};
+
+		std::tm localCreationTime;
+		std::tm localAccessTime;
+		std::tm localModificationTime;
+		if (!LocalTime(stbuf.st_ctime, localCreationTime)
+			|| !LocalTime(stbuf.st_atime, localAccessTime)
+			|| !LocalTime(stbuf.st_mtime, localModificationTime))
+		{
+			return false;
+		}
+		DateTimeToTm(localCreationTime, CreationTime);
+		DateTimeToTm(localModificationTime, WriteTime);
+		DateTimeToTm(localAccessTime, AccessTime);
 
 		return true;
 	}
@@ -1620,10 +1642,14 @@ namespace gpvulc
 	std::string GetCurrDir()
 	{
 		const int maxPath = 1024;
-		static char pathName[maxPath + 1];
+		char pathName[maxPath + 1];
 		*pathName = 0;
 
-		return getcwd(pathName, maxPath);
+		if (!getcwd(pathName, maxPath))
+		{
+			return std::string();
+		}
+		return pathName;
 	}
 
 
@@ -0,0 +1,100 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/ArenaAllocator.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Alignment of the allocated blocks
+	const size_t BLOCK_ALIGNMENT = 8;
+
+	inline size_t AlignSize(size_t size)
+	{
+		return (size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+	}
+}
+
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		ArenaAllocator::ArenaAllocator(size_t maxRetainedSize)
+			: MaxRetainedSize(maxRetainedSize)
+		{
+		}
+
+
+		void* ArenaAllocator::Malloc(size_t size)
+		{
+			if (size == 0)
+			{
+				return nullptr;
+			}
+			size = AlignSize(size);
+			if (Used + size <= Buffer.size())
+			{
+				LastBlockOffset = Used;
+				Used += size;
+				return Buffer.data() + LastBlockOffset;
+			}
+			Overflow.emplace_back(new char[size]);
+			OverflowSize += size;
+			return Overflow.back().get();
+		}
+
+
+		void* ArenaAllocator::Realloc(void* originalPtr, size_t originalSize, size_t newSize)
+		{
+			if (originalPtr == nullptr)
+			{
+				return Malloc(newSize);
+			}
+			if (newSize == 0)
+			{
+				return nullptr;
+			}
+			if (newSize <= originalSize)
+			{
+				return originalPtr;
+			}
+			// the last block in the buffer can grow in place
+			if (originalPtr == Buffer.data() + LastBlockOffset && LastBlockOffset + AlignSize(newSize) <= Buffer.size())
+			{
+				Used = LastBlockOffset + AlignSize(newSize);
+				return originalPtr;
+			}
+			void* newPtr = Malloc(newSize);
+			std::memcpy(newPtr, originalPtr, originalSize);
+			return newPtr;
+		}
+
+
+		void ArenaAllocator::Clear()
+		{
+			size_t requiredSize = Used + OverflowSize;
+			if (OverflowSize > 0 && Buffer.size() < MaxRetainedSize)
+			{
+				std::vector<char>(std::min(requiredSize + requiredSize / 4, MaxRetainedSize)).swap(Buffer);
+			}
+			else if (Buffer.size() > MaxRetainedSize)
+			{
+				std::vector<char>(MaxRetainedSize).swap(Buffer);
+			}
+			Overflow.clear();
+			OverflowSize = 0;
+			Used = 0;
+			LastBlockOffset = 0;
+		}
+	}
+}
@@ -0,0 +1,404 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/JsonBinaryCache.h>
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	// Identifier and version of the cache format
+	const char CACHE_MAGIC[4] = { 'G', 'J', 'B', 'C' };
+	const std::uint32_t CACHE_VERSION = 2;
+
+	// Maximum nesting level accepted when loading a cache
+	const unsigned MAX_DEPTH = 1024;
+
+
+	struct CacheHeader
+	{
+		char Magic[4];
+		std::uint32_t Version;
+		std::uint64_t SourceSize;
+		//! Modification time of the source file (nanoseconds since 1970, with the resolution of the file system)
+		std::int64_t SourceTime;
+		std::uint64_t PayloadSize;
+	};
+
+
+	//! Value tags
+	enum Tag : unsigned char
+	{
+		TAG_NULL, TAG_FALSE, TAG_TRUE,
+		TAG_INT, TAG_UINT, TAG_INT64, TAG_UINT64, TAG_DOUBLE,
+		TAG_STRING, TAG_OBJECT, TAG_ARRAY
+	};
+
+
+	/*
+	Get the size and the modification time of a file, in nanoseconds since 1970:
+	a file rewritten with the same size within the same second must change the stamp.
+	*/
+	bool GetFileStamp(const std::string& fileName, std::uint64_t& size, std::int64_t& time)
+	{
+#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExA(fileName.c_str(), GetFileExInfoStandard, &attributes))
+		{
+			return false;
+		}
+		size = ((std::uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+		// 100 ns intervals since 1601-01-01
+		const std::int64_t ticks = (std::int64_t)(((std::uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32)
+			| attributes.ftLastWriteTime.dwLowDateTime);
+		time = (ticks - 116444736000000000LL) * 100;
+#else
+		struct stat fileStat;
+		if (stat(fileName.c_str(), &fileStat) != 0)
+		{
+			return false;
+		}
+		size = (std::uint64_t)fileStat.st_size;
+#if defined(__APPLE__)
+		const struct timespec& modificationTime = fileStat.st_mtimespec;
+#else
+		const struct timespec& modificationTime = fileStat.st_mtim;
+#endif
+		time = (std::int64_t)modificationTime.tv_sec * 1000000000LL + modificationTime.tv_nsec;
+#endif
+		return true;
+	}
+
+
+	template <typename T>
+	void Append(std::string& buffer, T value)
+	{
+		buffer.append((const char*)&value, sizeof(T));
+	}
+
+
+	void AppendString(std::string& buffer, const char* str, rapidjson::SizeType length)
+	{
+		Append<std::uint32_t>(buffer, length);
+		buffer.append(str, length);
+		buffer.push_back('\0');
+	}
+
+
+	void WriteValue(std::string& buffer, const rapidjson::Value& value)
+	{
+		switch (value.GetType())
+		{
+		case rapidjson::kNullType:
+			buffer.push_back((char)TAG_NULL);
+			break;
+		case rapidjson::kFalseType:
+			buffer.push_back((char)TAG_FALSE);
+			break;
+		case rapidjson::kTrueType:
+			buffer.push_back((char)TAG_TRUE);
+			break;
+		case rapidjson::kNumberType:
+			// same choice as the rapidjson reader, to get the same value flags
+			if (value.IsDouble())
+			{
+				buffer.push_back((char)TAG_DOUBLE);
+				Append(buffer, value.GetDouble());
+			}
+			else if (value.IsUint())
+			{
+				buffer.push_back((char)TAG_UINT);
+				Append(buffer, value.GetUint());
+			}
+			else if (value.IsInt())
+			{
+				buffer.push_back((char)TAG_INT);
+				Append(buffer, value.GetInt());
+			}
+			else if (value.IsUint64())
+			{
+				buffer.push_back((char)TAG_UINT64);
+				Append(buffer, value.GetUint64());
+			}
+			else
+			{
+				buffer.push_back((char)TAG_INT64);
+				Append(buffer, value.GetInt64());
+			}
+			break;
+		case rapidjson::kStringType:
+			buffer.push_back((char)TAG_STRING);
+			AppendString(buffer, value.GetString(), value.GetStringLength());
+			break;
+		case rapidjson::kObjectType:
+			buffer.push_back((char)TAG_OBJECT);
+			Append<std::uint32_t>(buffer, value.MemberCount());
+			for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member)
+			{
+				AppendString(buffer, member->name.GetString(), member->name.GetStringLength());
+				WriteValue(buffer, member->value);
+			}
+			break;
+		case rapidjson::kArrayType:
+			buffer.push_back((char)TAG_ARRAY);
+			Append<std::uint32_t>(buffer, value.Size());
+			for (auto element = value.Begin(); element != value.End(); ++element)
+			{
+				WriteValue(buffer, *element);
+			}
+			break;
+		}
+	}
+
+
+	/*
+	Generator for GenericDocument::Populate(), sending the cached values to the document handler.
+	Every read is checked against the end of the payload, a corrupted cache stops the loading.
+	*/
+	class CacheGenerator
+	{
+	public:
+
+		CacheGenerator(const char* payload, size_t size)
+			: Pos(payload), End(payload + size)
+		{
+		}
+
+		template <typename Handler>
+		bool operator()(Handler& handler)
+		{
+			Succeeded = ReadValue(handler, 0) && Pos == End;
+			return Succeeded;
+		}
+
+		//! Check if the whole cache was read (the document is populated only in this case).
+		bool HasSucceeded() const { return Succeeded; }
+
+	private:
+
+		const char* Pos;
+		const char* End;
+		bool Succeeded = false;
+
+		template <typename T>
+		bool Read(T& value)
+		{
+			if ((size_t)(End - Pos) < sizeof(T))
+			{
+				return false;
+			}
+			std::memcpy(&value, Pos, sizeof(T));
+			Pos += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(const char*& str, std::uint32_t& length)
+		{
+			if (!Read(length) || (size_t)(End - Pos) <= length || Pos[length] != '\0')
+			{
+				return false;
+			}
+			str = Pos;
+			Pos += length + 1;
+			return true;
+		}
+
+		template <typename Handler>
+		bool ReadValue(Handler& handler, unsigned depth)
+		{
+			unsigned char tag = 0;
+			if (depth > MAX_DEPTH || !Read(tag))
+			{
+				return false;
+			}
+			switch (tag)
+			{
+			case TAG_NULL:
+				return handler.Null();
+			case TAG_FALSE:
+				return handler.Bool(false);
+			case TAG_TRUE:
+				return handler.Bool(true);
+			case TAG_INT:
+			{
+				int value;
+				return Read(value) && handler.Int(value);
+			}
+			case TAG_UINT:
+			{
+				unsigned value;
+				return Read(value) && handler.Uint(value);
+			}
+			case TAG_INT64:
+			{
+				std::int64_t value;
+				return Read(value) && handler.Int64(value);
+			}
+			case TAG_UINT64:
+			{
+				std::uint64_t value;
+				return Read(value) && handler.Uint64(value);
+			}
+			case TAG_DOUBLE:
+			{
+				double value;
+				return Read(value) && handler.Double(value);
+			}
+			case TAG_STRING:
+			{
+				// strings are not copied: the document refers to the mapped cache
+				const char* str;
+				std::uint32_t length;
+				return ReadString(str, length) && handler.String(str, length, false);
+			}
+			case TAG_OBJECT:
+			{
+				std::uint32_t count;
+				if (!Read(count) || !handler.StartObject())
+				{
+					return false;
+				}
+				for (std::uint32_t i = 0; i < count; i++)
+				{
+					const char* name;
+					std::uint32_t length;
+					if (!ReadString(name, length) || !handler.Key(name, length, false) || !ReadValue(handler, depth + 1))
+					{
+						return false;
+					}
+				}
+				return handler.EndObject(count);
+			}
+			case TAG_ARRAY:
+			{
+				std::uint32_t count;
+				if (!Read(count) || !handler.StartArray())
+				{
+					return false;
+				}
+				for (std::uint32_t i = 0; i < count; i++)
+				{
+					if (!ReadValue(handler, depth + 1))
+					{
+						return false;
+					}
+				}
+				return handler.EndArray(count);
+			}
+			}
+			return false;
+		}
+	};
+}
+
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		const char* const JsonBinaryCache::DEFAULT_EXTENSION = ".jbc";
+
+
+		bool JsonBinaryCache::Write(const rapidjson::Value& value, const std::string& sourceFileName, const std::string& cacheFileName)
+		{
+			CacheHeader header;
+			std::memcpy(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			header.Version = CACHE_VERSION;
+			if (!GetFileStamp(sourceFileName, header.SourceSize, header.SourceTime))
+			{
+				return false;
+			}
+
+			std::string buffer;
+			buffer.reserve(sizeof(CacheHeader) + (size_t)header.SourceSize);
+			buffer.append(sizeof(CacheHeader), '\0');
+			WriteValue(buffer, value);
+			header.PayloadSize = buffer.size() - sizeof(CacheHeader);
+			std::memcpy(&buffer[0], &header, sizeof(CacheHeader));
+
+			const std::string tempFileName = cacheFileName + ".tmp";
+#ifdef _MSC_VER
+			// disable the unsafe warning
+#pragma warning( push )
+#pragma warning( disable : 4996 )
+#endif
+			std::FILE* file = std::fopen(tempFileName.c_str(), "wb");
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+			if (!file)
+			{
+				return false;
+			}
+			bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+			written = std::fclose(file) == 0 && written;
+#ifdef _WIN32
+			// rename() does not replace existing files on Windows
+			std::remove(cacheFileName.c_str());
+#endif
+			if (!written || std::rename(tempFileName.c_str(), cacheFileName.c_str()) != 0)
+			{
+				std::remove(tempFileName.c_str());
+				return false;
+			}
+			return true;
+		}
+
+
+		bool JsonBinaryCache::Open(const std::string& cacheFileName, const std::string& sourceFileName)
+		{
+			std::uint64_t sourceSize = 0;
+			std::int64_t sourceTime = 0;
+			if (!GetFileStamp(sourceFileName, sourceSize, sourceTime) || !CacheFile.Open(cacheFileName))
+			{
+				Close();
+				return false;
+			}
+			CacheHeader header;
+			bool valid = CacheFile.GetSize() >= sizeof(CacheHeader);
+			if (valid)
+			{
+				std::memcpy(&header, CacheFile.GetData(), sizeof(CacheHeader));
+				valid = std::memcmp(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+					&& header.Version == CACHE_VERSION
+					&& header.SourceSize == sourceSize
+					&& header.SourceTime == sourceTime
+					&& header.PayloadSize == CacheFile.GetSize() - sizeof(CacheHeader);
+			}
+			if (!valid)
+			{
+				Close();
+			}
+			return valid;
+		}
+
+
+		bool JsonBinaryCache::Load(ArenaDocument& document)
+		{
+			if (!IsOpen())
+			{
+				return false;
+			}
+			CacheGenerator generator(CacheFile.GetData() + sizeof(CacheHeader), CacheFile.GetSize() - sizeof(CacheHeader));
+			document.Populate(generator);
+			return generator.HasSucceeded();
+		}
+	}
+}
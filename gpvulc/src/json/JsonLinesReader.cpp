@@ -0,0 +1,323 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/JsonLinesReader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	// Number of lines taken by a worker thread at a time
+	const size_t LINES_PER_CHUNK = 16;
+
+
+	inline bool IsBlankLine(const char* line)
+	{
+		for (; *line; line++)
+		{
+			if (*line != ' ' && *line != '\t')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		//! Lines split from the text, with the parsing results (memory reused for each batch)
+		struct JsonLinesReader::LineBatch
+		{
+			size_t Count = 0;
+			std::vector<char*> Lines;
+			std::vector<size_t> LineNumbers;
+			std::vector<char> Failed;
+			std::vector<std::string> Errors;
+
+			void Resize(size_t size)
+			{
+				Lines.resize(size);
+				LineNumbers.resize(size);
+				Failed.resize(size);
+				Errors.resize(size);
+			}
+		};
+
+
+		//! Worker threads and their synchronization
+		struct JsonLinesReader::WorkerPool
+		{
+			std::vector<std::thread> Threads;
+			std::mutex Mutex;
+			std::condition_variable WorkReady;
+			std::condition_variable WorkDone;
+
+			//! Incremented for each batch, to wake up the workers
+			unsigned Generation = 0;
+			unsigned ActiveWorkers = 0;
+			bool Stopping = false;
+
+			//! Batch being parsed
+			unsigned BatchIndex = 0;
+			const SlotConverter* Convert = nullptr;
+			std::atomic<size_t> NextLine;
+		};
+
+
+		JsonLinesReader::JsonLinesReader(unsigned numThreads)
+			: Batches(new LineBatch[2])
+			, Pool(new WorkerPool)
+		{
+			if (numThreads == 0)
+			{
+				numThreads = std::max(1u, std::thread::hardware_concurrency());
+			}
+			for (unsigned i = 0; i < numThreads; i++)
+			{
+				Parsers.emplace_back(new RapidJsonParser);
+			}
+			Pool->Threads.reserve(numThreads);
+			for (unsigned i = 0; i < numThreads; i++)
+			{
+				Pool->Threads.emplace_back(&JsonLinesReader::WorkerLoop, this, i);
+			}
+		}
+
+
+		JsonLinesReader::~JsonLinesReader()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Pool->Mutex);
+				Pool->Stopping = true;
+			}
+			Pool->WorkReady.notify_all();
+			for (std::thread& thread : Pool->Threads)
+			{
+				thread.join();
+			}
+		}
+
+
+		void JsonLinesReader::ReadLines(
+			char* text,
+			size_t length,
+			const SlotConverter& convert,
+			const SlotDeliverer& deliver,
+			const ErrorHandler& onError)
+		{
+			RecordCount = 0;
+			ErrorCount = 0;
+			size_t pos = 0;
+			size_t lineNumber = 0;
+			unsigned current = 0;
+			bool pending = false;
+			for (;;)
+			{
+				// split the next batch while the previous one is parsed
+				LineBatch& batch = Batches[current];
+				FillBatch(batch, text, length, pos, lineNumber);
+				if (pending)
+				{
+					WaitBatch();
+				}
+				if (batch.Count > 0)
+				{
+					StartBatch(current, convert);
+				}
+				if (pending)
+				{
+					try
+					{
+						DeliverBatch(current ^ 1, deliver, onError);
+					}
+					catch (...)
+					{
+						// the workers use the batch and the handlers: stop them before leaving
+						if (batch.Count > 0)
+						{
+							WaitBatch();
+						}
+						throw;
+					}
+				}
+				if (batch.Count == 0)
+				{
+					break;
+				}
+				pending = true;
+				current ^= 1;
+			}
+		}
+
+
+		void JsonLinesReader::FillBatch(LineBatch& batch, char* text, size_t length, size_t& pos, size_t& lineNumber)
+		{
+			if (batch.Lines.size() != BatchSize)
+			{
+				batch.Resize(BatchSize);
+			}
+			batch.Count = 0;
+			while (pos < length && batch.Count < BatchSize)
+			{
+				char* line = text + pos;
+				char* lineEnd = (char*)std::memchr(line, '\n', length - pos);
+				if (lineEnd)
+				{
+					pos = lineEnd - text + 1;
+				}
+				else
+				{
+					// the text is null terminated
+					lineEnd = text + length;
+					pos = length;
+				}
+				if (lineEnd > line && lineEnd[-1] == '\r')
+				{
+					lineEnd--;
+				}
+				*lineEnd = '\0';
+				lineNumber++;
+				if (IsBlankLine(line))
+				{
+					continue;
+				}
+				batch.Lines[batch.Count] = line;
+				batch.LineNumbers[batch.Count] = lineNumber;
+				batch.Count++;
+			}
+		}
+
+
+		void JsonLinesReader::DeliverBatch(unsigned batchIndex, const SlotDeliverer& deliver, const ErrorHandler& onError)
+		{
+			const LineBatch& batch = Batches[batchIndex];
+			for (size_t i = 0; i < batch.Count; i++)
+			{
+				if (batch.Failed[i])
+				{
+					ErrorCount++;
+					if (onError)
+					{
+						onError(batch.LineNumbers[i], batch.Errors[i].c_str());
+					}
+				}
+				else
+				{
+					RecordCount++;
+					deliver(batchIndex, i, batch.LineNumbers[i]);
+				}
+			}
+		}
+
+
+		void JsonLinesReader::ParseLines(unsigned threadIndex)
+		{
+			RapidJsonParser& parser = *Parsers[threadIndex];
+			const unsigned batchIndex = Pool->BatchIndex;
+			const SlotConverter& convert = *Pool->Convert;
+			LineBatch& batch = Batches[batchIndex];
+			for (;;)
+			{
+				size_t begin = Pool->NextLine.fetch_add(LINES_PER_CHUNK);
+				if (begin >= batch.Count)
+				{
+					break;
+				}
+				size_t end = std::min(begin + LINES_PER_CHUNK, batch.Count);
+				for (size_t i = begin; i < end; i++)
+				{
+					std::string& error = batch.Errors[i];
+					bool failed = true;
+					error.clear();
+					parser.Reset();
+					try
+					{
+						parser.ParseInsitu(batch.Lines[i]);
+						convert(batchIndex, i, parser);
+						failed = parser.ErrorsOccurred();
+						if (failed)
+						{
+							error = parser.GetJsonErrorSummary(true);
+						}
+					}
+					catch (const ParseException& parseException)
+					{
+						error = GetParseExceptionErrorMessage(parseException);
+					}
+					catch (const std::exception& exception)
+					{
+						error = exception.what();
+					}
+					catch (...)
+					{
+						error = ErrorTypeToString(ErrorType::UNHANDLED_EXCEPTION);
+					}
+					batch.Failed[i] = failed;
+				}
+			}
+		}
+
+
+		void JsonLinesReader::WorkerLoop(unsigned threadIndex)
+		{
+			unsigned generation = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(Pool->Mutex);
+					Pool->WorkReady.wait(lock, [&]() { return Pool->Stopping || Pool->Generation != generation; });
+					if (Pool->Stopping)
+					{
+						return;
+					}
+					generation = Pool->Generation;
+				}
+				ParseLines(threadIndex);
+				{
+					std::lock_guard<std::mutex> lock(Pool->Mutex);
+					if (--Pool->ActiveWorkers == 0)
+					{
+						Pool->WorkDone.notify_all();
+					}
+				}
+			}
+		}
+
+
+		void JsonLinesReader::StartBatch(unsigned batchIndex, const SlotConverter& convert)
+		{
+			{
+				std::lock_guard<std::mutex> lock(Pool->Mutex);
+				Pool->BatchIndex = batchIndex;
+				Pool->Convert = &convert;
+				Pool->NextLine = 0;
+				Pool->ActiveWorkers = (unsigned)Pool->Threads.size();
+				Pool->Generation++;
+			}
+			Pool->WorkReady.notify_all();
+		}
+
+
+		void JsonLinesReader::WaitBatch()
+		{
+			std::unique_lock<std::mutex> lock(Pool->Mutex);
+			Pool->WorkDone.wait(lock, [&]() { return Pool->ActiveWorkers == 0; });
+		}
+	}
+}
@@ -0,0 +1,130 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/JsonMapping.h>
+
+#include <cstring>
+
+namespace
+{
+	// Number of seeds tried for each table size before doubling it
+	const std::uint32_t MAX_SEED_ATTEMPTS = 256;
+}
+
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		// definition required when the constant is bound to a reference (e.g. by std::vector::assign())
+		const size_t JsonFieldIndex::NOT_FOUND;
+
+
+		JsonFieldIndex::JsonFieldIndex(const char* const* names, size_t count)
+			: Names(names, names + count)
+		{
+			Lengths.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				Lengths.push_back(std::strlen(names[i]));
+				for (size_t j = 0; j < i; j++)
+				{
+					if (Lengths[j] == Lengths[i] && std::memcmp(names[j], names[i], Lengths[i]) == 0)
+					{
+						throw FormatException("Repeated field name in JSON mapping");
+					}
+				}
+			}
+
+			// start with at least twice the number of names, so that a seed is found quickly
+			size_t tableSize = 1;
+			while (tableSize < count * 2)
+			{
+				tableSize *= 2;
+			}
+			for (;;)
+			{
+				Mask = tableSize - 1;
+				for (Seed = 0; Seed < MAX_SEED_ATTEMPTS; Seed++)
+				{
+					Slots.assign(tableSize, NOT_FOUND);
+					bool collision = false;
+					for (size_t i = 0; i < count && !collision; i++)
+					{
+						size_t& slot = Slots[Hash(Names[i], Lengths[i], Seed) & Mask];
+						collision = slot != NOT_FOUND;
+						slot = i;
+					}
+					if (!collision)
+					{
+						return;
+					}
+				}
+				tableSize *= 2;
+			}
+		}
+
+
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, bool& value, const char* name)
+		{
+			if (!val.IsBool())
+			{
+				parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				return;
+			}
+			value = val.GetBool();
+		}
+
+
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, int& value, const char* name)
+		{
+			if (!val.IsInt())
+			{
+				parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				return;
+			}
+			value = val.GetInt();
+		}
+
+
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, float& value, const char* name)
+		{
+			if (!val.IsNumber())
+			{
+				parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				return;
+			}
+			value = (float)val.GetDouble();
+		}
+
+
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, double& value, const char* name)
+		{
+			if (!val.IsNumber())
+			{
+				parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				return;
+			}
+			value = val.GetDouble();
+		}
+
+
+		void JsonValueReader::Read(RapidJsonParser& parser, const rapidjson::Value& val, std::string& value, const char* name)
+		{
+			if (!val.IsString())
+			{
+				parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				return;
+			}
+			value.assign(val.GetString(), val.GetStringLength());
+		}
+
+	}
+}
@@ -0,0 +1,178 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/JsonPathIndex.h>
+
+#include <cstring>
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		JsonPathIndex::JsonPathIndex(size_t minIndexedMembers)
+			: MinIndexedMembers(minIndexedMembers)
+		{
+		}
+
+
+		void JsonPathIndex::Reset(const rapidjson::Value* root)
+		{
+			Root = root;
+			Tables.clear();
+			Slots.clear();
+			PathCache.clear();
+		}
+
+
+		JsonPathIndex::ObjectTable JsonPathIndex::BuildTable(const rapidjson::Value& object)
+		{
+			const std::uint32_t count = (std::uint32_t)object.MemberCount();
+			std::uint32_t tableSize = 1;
+			while (tableSize < count * 2)
+			{
+				tableSize *= 2;
+			}
+			ObjectTable table = { Slots.size(), tableSize - 1 };
+			Slots.resize(Slots.size() + tableSize, 0);
+			std::uint32_t* slots = Slots.data() + table.Offset;
+
+			// linear probing, a repeated name is not stored (the first member is found as in rapidjson)
+			const rapidjson::Value::Member* members = &*object.MemberBegin();
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				const rapidjson::Value& name = members[i].name;
+				const size_t length = name.GetStringLength();
+				std::uint32_t pos = Hash(name.GetString(), length) & table.Mask;
+				bool repeated = false;
+				while (slots[pos] != 0 && !repeated)
+				{
+					const rapidjson::Value& slotName = members[slots[pos] - 1].name;
+					repeated = slotName.GetStringLength() == length
+						&& std::memcmp(slotName.GetString(), name.GetString(), length) == 0;
+					pos = (pos + 1) & table.Mask;
+				}
+				if (!repeated)
+				{
+					slots[pos] = i + 1;
+				}
+			}
+			Tables[&object] = table;
+			return table;
+		}
+
+
+		const rapidjson::Value* JsonPathIndex::FindMember(const rapidjson::Value& object, const char* name, size_t length)
+		{
+			if (!object.IsObject() || object.MemberCount() == 0)
+			{
+				return nullptr;
+			}
+			if (object.MemberCount() < MinIndexedMembers)
+			{
+				rapidjson::Value::ConstMemberIterator member
+					= object.FindMember(rapidjson::Value(rapidjson::StringRef(name, (rapidjson::SizeType)length)));
+				return member != object.MemberEnd() ? &member->value : nullptr;
+			}
+
+			auto tableIter = Tables.find(&object);
+			const ObjectTable table = tableIter != Tables.end() ? tableIter->second : BuildTable(object);
+			const std::uint32_t* slots = Slots.data() + table.Offset;
+			const rapidjson::Value::Member* members = &*object.MemberBegin();
+			for (std::uint32_t pos = Hash(name, length) & table.Mask; slots[pos] != 0; pos = (pos + 1) & table.Mask)
+			{
+				const rapidjson::Value::Member& member = members[slots[pos] - 1];
+				if (member.name.GetStringLength() == length
+					&& std::memcmp(member.name.GetString(), name, length) == 0)
+				{
+					return &member.value;
+				}
+			}
+			return nullptr;
+		}
+
+
+		const rapidjson::Value* JsonPathIndex::FindMember(const rapidjson::Value& object, const char* name)
+		{
+			return FindMember(object, name, std::strlen(name));
+		}
+
+
+		const rapidjson::Value* JsonPathIndex::Find(const std::string& pointer)
+		{
+			auto cached = PathCache.find(pointer);
+			if (cached != PathCache.end())
+			{
+				return cached->second;
+			}
+			const rapidjson::Value* value = Resolve(pointer.data(), pointer.size());
+			PathCache.emplace(pointer, value);
+			return value;
+		}
+
+
+		const rapidjson::Value* JsonPathIndex::Find(const char* pointer)
+		{
+			// the key buffer is reused to avoid allocating a string for each query
+			Key.assign(pointer);
+			return Find(Key);
+		}
+
+
+		const rapidjson::Value* JsonPathIndex::Resolve(const char* pointer, size_t length)
+		{
+			const rapidjson::Value* value = Root;
+			if (!value || (length > 0 && pointer[0] != '/'))
+			{
+				return nullptr;
+			}
+			size_t pos = 1;
+			while (pos <= length && length > 0)
+			{
+				// decode the next reference token
+				Token.clear();
+				for (; pos < length && pointer[pos] != '/'; pos++)
+				{
+					char c = pointer[pos];
+					if (c == '~' && pos + 1 < length && (pointer[pos + 1] == '0' || pointer[pos + 1] == '1'))
+					{
+						c = pointer[++pos] == '0' ? '~' : '/';
+					}
+					Token.push_back(c);
+				}
+				pos++;
+
+				if (value->IsObject())
+				{
+					value = FindMember(*value, Token.data(), Token.size());
+				}
+				else if (value->IsArray())
+				{
+					// array index: digits only, without leading zeros
+					if (Token.empty() || Token.size() > 9 || (Token[0] == '0' && Token.size() > 1)
+						|| Token.find_first_not_of("0123456789") != std::string::npos)
+					{
+						return nullptr;
+					}
+					size_t index = (size_t)std::stoul(Token);
+					value = index < value->Size() ? &(*value)[(rapidjson::SizeType)index] : nullptr;
+				}
+				else
+				{
+					return nullptr;
+				}
+				if (!value)
+				{
+					return nullptr;
+				}
+			}
+			return value;
+		}
+	}
+}
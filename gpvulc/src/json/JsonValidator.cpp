@@ -0,0 +1,726 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/JsonValidator.h>
+
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Rule index for missing rules
+	const size_t NO_RULE = (size_t)-1;
+
+	// Maximum number of required members of an object (one bit each)
+	const size_t MAX_REQUIRED_MEMBERS = 64;
+}
+
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		//! Compiled specification of a value
+		struct JsonValidator::Rule
+		{
+			//! Expected value type
+			enum class Kind { ANY, OBJECT, ARRAY, STRING, INTEGER, NUMBER, BOOLEAN, NULL_VALUE };
+
+			Kind Type = Kind::ANY;
+			bool HasMinimum = false;
+			bool HasMaximum = false;
+			double Minimum = 0;
+			double Maximum = 0;
+			size_t MinItems = 0;
+			size_t MaxItems = (size_t)-1;
+			//! String length limits (bytes)
+			size_t MinLength = 0;
+			size_t MaxLength = (size_t)-1;
+			//! Rule for the array elements
+			size_t Items = NO_RULE;
+
+			//! Members with a rule, the required ones first
+			std::vector<std::string> MemberNames;
+			std::vector<size_t> MemberRules;
+			size_t RequiredCount = 0;
+			std::unique_ptr<JsonFieldIndex> Members;
+
+			//! Mask with a bit for each required member.
+			std::uint64_t RequiredMask() const
+			{
+				return RequiredCount == MAX_REQUIRED_MEMBERS ? ~(std::uint64_t)0 : ((std::uint64_t)1 << RequiredCount) - 1;
+			}
+
+			//! Get the position of the named member in MemberNames, or JsonFieldIndex::NOT_FOUND.
+			size_t FindMember(const char* name, size_t length) const
+			{
+				return Members ? Members->Find(name, length) : JsonFieldIndex::NOT_FOUND;
+			}
+
+			//! Check if a value of the given kind is accepted (integers are numbers too).
+			bool Accepts(Kind kind) const
+			{
+				return Type == Kind::ANY || Type == kind || (Type == Kind::NUMBER && kind == Kind::INTEGER);
+			}
+
+			bool IsInRange(double number) const
+			{
+				return (!HasMinimum || number >= Minimum) && (!HasMaximum || number <= Maximum);
+			}
+		};
+
+
+		/*!
+		Name or array index of a validated value, used for error messages:
+		the name is built only when an error is registered.
+		*/
+		struct JsonValidator::ValueName
+		{
+			const char* Name;
+			size_t Length;
+			size_t Index;
+			bool IsElement;
+			//! The root value has no context
+			bool IsRoot;
+
+			static ValueName Root() { return{ "", 0, 0, false, true }; }
+			static ValueName Member(const char* name, size_t length) { return{ name, length, 0, false, false }; }
+			static ValueName Element(size_t index) { return{ "", 0, index, true, false }; }
+
+			std::string ToString() const
+			{
+				return IsElement ? std::to_string(Index) : std::string(Name, Length);
+			}
+
+			//! Start the context of the value (for its members or elements).
+			void StartContext(RapidJsonParser& parser) const
+			{
+				if (IsElement)
+				{
+					parser.StartContext(Index);
+				}
+				else if (!IsRoot)
+				{
+					parser.StartContext(Name, Length);
+				}
+			}
+
+			void EndContext(RapidJsonParser& parser) const
+			{
+				if (!IsRoot)
+				{
+					parser.EndContext();
+				}
+			}
+		};
+
+
+		/*!
+		SAX handler for rapidjson Reader, checking the values against the rules while reading.
+		Values without a rule (e.g. members not listed in the specification) are skipped only counting their depth.
+		*/
+		class JsonValidator::StreamValidator
+			: public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonValidator::StreamValidator>
+		{
+		public:
+
+			typedef Rule::Kind Kind;
+
+			StreamValidator(const JsonValidator& validator, RapidJsonParser& parser)
+				: Validator(validator)
+				, Parser(parser)
+			{
+			}
+
+			bool Null() { return Scalar(Kind::NULL_VALUE); }
+			bool Bool(bool) { return Scalar(Kind::BOOLEAN); }
+			bool Int(int intValue) { return Scalar(Kind::INTEGER, (double)intValue); }
+			bool Uint(unsigned uintValue) { return Scalar(Kind::INTEGER, (double)uintValue); }
+			bool Int64(int64_t int64Value) { return Scalar(Kind::INTEGER, (double)int64Value); }
+			bool Uint64(uint64_t uint64Value) { return Scalar(Kind::INTEGER, (double)uint64Value); }
+			bool Double(double doubleValue) { return Scalar(Kind::NUMBER, doubleValue); }
+			bool String(const char*, rapidjson::SizeType length, bool) { return Scalar(Kind::STRING, 0, length); }
+
+			bool Key(const char* str, rapidjson::SizeType length, bool)
+			{
+				if (SkipDepth > 0)
+				{
+					return true;
+				}
+				Frame& frame = Frames.back();
+				const size_t index = frame.ContainerRule->FindMember(str, length);
+				if (index == JsonFieldIndex::NOT_FOUND)
+				{
+					PendingRule = nullptr;
+					return true;
+				}
+				if (index < frame.ContainerRule->RequiredCount)
+				{
+					frame.Seen |= (std::uint64_t)1 << index;
+				}
+				PendingRule = Validator.Rules[frame.ContainerRule->MemberRules[index]].get();
+				PendingKey.assign(str, length);
+				return true;
+			}
+
+			bool StartObject() { return StartContainer(Kind::OBJECT); }
+
+			bool EndObject(rapidjson::SizeType)
+			{
+				if (SkipDepth > 0)
+				{
+					SkipDepth--;
+					return true;
+				}
+				const Frame& frame = Frames.back();
+				const std::uint64_t requiredMask = frame.ContainerRule->RequiredMask();
+				if ((frame.Seen & requiredMask) != requiredMask)
+				{
+					MissingMembers(Parser, *frame.ContainerRule, frame.Seen, frame.IsRoot);
+				}
+				PopFrame();
+				return true;
+			}
+
+			bool StartArray() { return StartContainer(Kind::ARRAY); }
+
+			bool EndArray(rapidjson::SizeType elementCount)
+			{
+				if (SkipDepth > 0)
+				{
+					SkipDepth--;
+					return true;
+				}
+				const Frame frame = Frames.back();
+				GetName(frame).EndContext(Parser);
+				Frames.pop_back();
+				// the error is registered in the parent context, as for the other values
+				if (elementCount < frame.ContainerRule->MinItems || elementCount > frame.ContainerRule->MaxItems)
+				{
+					AddError(Parser, ErrorType::INVALID_VALUE, GetName(frame));
+				}
+				FrameNames.resize(frame.NameOffset);
+				return true;
+			}
+
+		private:
+
+			//! Rule and name of the next value
+			struct Current
+			{
+				const Rule* ValueRule;
+				ValueName Name;
+			};
+
+			//! Object or array being validated
+			struct Frame
+			{
+				const Rule* ContainerRule;
+				bool IsArray;
+				size_t Count;
+				//! Required members found (see Rule::RequiredMask())
+				std::uint64_t Seen;
+				//! Name stored in FrameNames (for member values)
+				size_t NameOffset;
+				size_t NameLength;
+				size_t Index;
+				bool IsElement;
+				bool IsRoot;
+			};
+
+			const JsonValidator& Validator;
+			RapidJsonParser& Parser;
+			std::vector<Frame> Frames;
+			//! Names of the members in Frames
+			std::string FrameNames;
+			size_t SkipDepth = 0;
+			const Rule* PendingRule = nullptr;
+			std::string PendingKey;
+
+			ValueName GetName(const Frame& frame) const
+			{
+				return{ FrameNames.data() + frame.NameOffset, frame.NameLength, frame.Index, frame.IsElement, frame.IsRoot };
+			}
+
+			//! Get the rule for the next value (nullptr if the value must be skipped).
+			Current NextValue()
+			{
+				Current value = { nullptr, ValueName::Root() };
+				if (SkipDepth > 0)
+				{
+					return value;
+				}
+				if (Frames.empty())
+				{
+					value.ValueRule = Validator.Rules.empty() ? nullptr : Validator.Rules[0].get();
+					return value;
+				}
+				Frame& frame = Frames.back();
+				if (frame.IsArray)
+				{
+					value.Name = ValueName::Element(frame.Count++);
+					value.ValueRule = frame.ContainerRule->Items != NO_RULE ? Validator.Rules[frame.ContainerRule->Items].get() : nullptr;
+				}
+				else
+				{
+					value.Name = ValueName::Member(PendingKey.data(), PendingKey.size());
+					value.ValueRule = PendingRule;
+					PendingRule = nullptr;
+				}
+				return value;
+			}
+
+			bool Scalar(Kind kind, double number = 0, size_t length = 0)
+			{
+				Current value = NextValue();
+				if (!value.ValueRule)
+				{
+					return true;
+				}
+				const Rule& rule = *value.ValueRule;
+				if (!rule.Accepts(kind))
+				{
+					TypeMismatch(Parser, rule, value.Name);
+				}
+				else if (((kind == Kind::INTEGER || kind == Kind::NUMBER) && !rule.IsInRange(number))
+					|| (kind == Kind::STRING && (length < rule.MinLength || length > rule.MaxLength)))
+				{
+					AddError(Parser, ErrorType::INVALID_VALUE, value.Name);
+				}
+				return true;
+			}
+
+			bool StartContainer(Kind kind)
+			{
+				Current value = NextValue();
+				if (!value.ValueRule)
+				{
+					SkipDepth++;
+					return true;
+				}
+				if (!value.ValueRule->Accepts(kind))
+				{
+					TypeMismatch(Parser, *value.ValueRule, value.Name);
+					SkipDepth++;
+					return true;
+				}
+				Frame frame = { value.ValueRule, kind == Kind::ARRAY, 0, 0, FrameNames.size(), 0,
+					value.Name.Index, value.Name.IsElement, value.Name.IsRoot };
+				if (!value.Name.IsElement && !value.Name.IsRoot)
+				{
+					FrameNames.append(value.Name.Name, value.Name.Length);
+					frame.NameLength = value.Name.Length;
+				}
+				value.Name.StartContext(Parser);
+				Frames.push_back(frame);
+				return true;
+			}
+
+			void PopFrame()
+			{
+				const Frame& frame = Frames.back();
+				GetName(frame).EndContext(Parser);
+				FrameNames.resize(frame.NameOffset);
+				Frames.pop_back();
+			}
+		};
+
+
+		JsonValidator::JsonValidator()
+		{
+		}
+
+
+		JsonValidator::JsonValidator(const std::string& specification)
+		{
+			Compile(specification);
+		}
+
+
+		JsonValidator::~JsonValidator()
+		{
+		}
+
+
+		void JsonValidator::Compile(const std::string& specification)
+		{
+			rapidjson::Document spec;
+			spec.Parse(specification);
+
+			// keep the current rules if the specification is not valid
+			std::vector<std::unique_ptr<Rule>> previousRules;
+			previousRules.swap(Rules);
+			try
+			{
+				CompileRule(spec, "");
+			}
+			catch (...)
+			{
+				Rules.swap(previousRules);
+				throw;
+			}
+		}
+
+
+		size_t JsonValidator::CompileRule(const rapidjson::Value& spec, const std::string& path)
+		{
+			if (!spec.IsObject())
+			{
+				SpecificationError(path, "specification is not an object");
+			}
+			const size_t ruleIndex = Rules.size();
+			Rules.emplace_back(new Rule);
+			Rule& rule = *Rules.back();
+
+			for (auto keyword = spec.MemberBegin(); keyword != spec.MemberEnd(); ++keyword)
+			{
+				const std::string name(keyword->name.GetString(), keyword->name.GetStringLength());
+				const rapidjson::Value& value = keyword->value;
+				if (name == "type")
+				{
+					static const struct { const char* Name; Rule::Kind Kind; } types[] = {
+						{ "object", Rule::Kind::OBJECT },
+						{ "array", Rule::Kind::ARRAY },
+						{ "string", Rule::Kind::STRING },
+						{ "integer", Rule::Kind::INTEGER },
+						{ "number", Rule::Kind::NUMBER },
+						{ "boolean", Rule::Kind::BOOLEAN },
+						{ "null", Rule::Kind::NULL_VALUE },
+					};
+					bool found = false;
+					for (const auto& type : types)
+					{
+						if (value.IsString() && std::strcmp(value.GetString(), type.Name) == 0)
+						{
+							rule.Type = type.Kind;
+							found = true;
+						}
+					}
+					if (!found)
+					{
+						SpecificationError(path, "unknown type");
+					}
+				}
+				else if (name == "minimum" || name == "maximum")
+				{
+					if (!value.IsNumber())
+					{
+						SpecificationError(path, "minimum and maximum must be numbers");
+					}
+					bool isMinimum = name == "minimum";
+					(isMinimum ? rule.HasMinimum : rule.HasMaximum) = true;
+					(isMinimum ? rule.Minimum : rule.Maximum) = value.GetDouble();
+				}
+				else if (name == "minItems" || name == "maxItems" || name == "minLength" || name == "maxLength")
+				{
+					if (!value.IsUint64())
+					{
+						SpecificationError(path, "size limits must be non negative integers");
+					}
+					size_t count = (size_t)value.GetUint64();
+					if (name == "minItems")
+					{
+						rule.MinItems = count;
+					}
+					else if (name == "maxItems")
+					{
+						rule.MaxItems = count;
+					}
+					else if (name == "minLength")
+					{
+						rule.MinLength = count;
+					}
+					else
+					{
+						rule.MaxLength = count;
+					}
+				}
+				else if (name == "items")
+				{
+					rule.Items = CompileRule(value, path + "/items");
+				}
+			}
+
+			// members: the required ones first, so that they can be tracked with a bit mask
+			std::vector<std::string> memberNames;
+			std::vector<size_t> memberRules;
+			size_t requiredCount = 0;
+			if (spec.HasMember("required"))
+			{
+				const rapidjson::Value& required = spec["required"];
+				if (!required.IsArray())
+				{
+					SpecificationError(path, "required must be an array");
+				}
+				for (auto element = required.Begin(); element != required.End(); ++element)
+				{
+					if (!element->IsString())
+					{
+						SpecificationError(path, "required member names must be strings");
+					}
+					const std::string memberName(element->GetString(), element->GetStringLength());
+					if (std::find(memberNames.begin(), memberNames.end(), memberName) == memberNames.end())
+					{
+						memberNames.push_back(memberName);
+						memberRules.push_back(NO_RULE);
+					}
+				}
+				requiredCount = memberNames.size();
+				if (requiredCount > MAX_REQUIRED_MEMBERS)
+				{
+					SpecificationError(path, "too many required members");
+				}
+			}
+			if (spec.HasMember("properties"))
+			{
+				const rapidjson::Value& properties = spec["properties"];
+				if (!properties.IsObject())
+				{
+					SpecificationError(path, "properties must be an object");
+				}
+				for (auto property = properties.MemberBegin(); property != properties.MemberEnd(); ++property)
+				{
+					const std::string memberName(property->name.GetString(), property->name.GetStringLength());
+					const size_t memberRule = CompileRule(property->value, path + "/" + memberName);
+					auto position = std::find(memberNames.begin(), memberNames.end(), memberName);
+					if (position == memberNames.end())
+					{
+						memberNames.push_back(memberName);
+						memberRules.push_back(memberRule);
+					}
+					else if (memberRules[position - memberNames.begin()] == NO_RULE)
+					{
+						memberRules[position - memberNames.begin()] = memberRule;
+					}
+					else
+					{
+						SpecificationError(path, "repeated property");
+					}
+				}
+			}
+			// required members without a property specification accept any value
+			for (size_t i = 0; i < memberNames.size(); i++)
+			{
+				if (memberRules[i] == NO_RULE)
+				{
+					memberRules[i] = Rules.size();
+					Rules.emplace_back(new Rule);
+				}
+			}
+
+			rule.MemberNames.swap(memberNames);
+			rule.MemberRules.swap(memberRules);
+			rule.RequiredCount = requiredCount;
+			if (!rule.MemberNames.empty())
+			{
+				// the index refers to the names stored in the rule
+				std::vector<const char*> names;
+				for (const std::string& memberName : rule.MemberNames)
+				{
+					names.push_back(memberName.c_str());
+				}
+				rule.Members.reset(new JsonFieldIndex(names.data(), names.size()));
+			}
+			return ruleIndex;
+		}
+
+
+		void JsonValidator::SpecificationError(const std::string& path, const char* message)
+		{
+			const std::string description = "JSON validation specification"
+				+ (path.empty() ? std::string() : " (" + path + ")") + ": " + message;
+			throw FormatException(description.c_str());
+		}
+
+
+		bool JsonValidator::Validate(RapidJsonParser& parser, const rapidjson::Value& value) const
+		{
+			if (Rules.empty())
+			{
+				return true;
+			}
+			const size_t errorCount = parser.GetErrorCount();
+			const size_t contextDepth = parser.PathToMember.size();
+			try
+			{
+				CheckValue(parser, *Rules[0], value, ValueName::Root());
+			}
+			catch (...)
+			{
+				// restore the context before propagating the error limit exception
+				parser.RestoreContext(contextDepth);
+				throw;
+			}
+			return parser.GetErrorCount() == errorCount;
+		}
+
+
+		bool JsonValidator::Validate(RapidJsonParser& parser) const
+		{
+			return Validate(parser, parser.DocumentBuffer);
+		}
+
+
+		bool JsonValidator::ValidateStream(RapidJsonParser& parser, const char* jsonText, size_t length) const
+		{
+			const size_t errorCount = parser.GetErrorCount();
+			const size_t contextDepth = parser.PathToMember.size();
+			StreamValidator handler(*this, parser);
+			parser.StackAllocator.Clear();
+			rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, ArenaAllocator> reader(&parser.StackAllocator);
+			rapidjson::MemoryStream stream(jsonText, length);
+			try
+			{
+				reader.Parse(stream, handler);
+			}
+			catch (...)
+			{
+				// restore the context before propagating parsing errors
+				parser.RestoreContext(contextDepth);
+				throw;
+			}
+			return parser.GetErrorCount() == errorCount;
+		}
+
+
+		void JsonValidator::CheckValue(RapidJsonParser& parser, const Rule& rule, const rapidjson::Value& value, const ValueName& name) const
+		{
+			Rule::Kind kind = Rule::Kind::NULL_VALUE;
+			switch (value.GetType())
+			{
+			case rapidjson::kNullType:
+				kind = Rule::Kind::NULL_VALUE;
+				break;
+			case rapidjson::kFalseType:
+			case rapidjson::kTrueType:
+				kind = Rule::Kind::BOOLEAN;
+				break;
+			case rapidjson::kNumberType:
+				kind = value.IsInt64() || value.IsUint64() ? Rule::Kind::INTEGER : Rule::Kind::NUMBER;
+				break;
+			case rapidjson::kStringType:
+				kind = Rule::Kind::STRING;
+				break;
+			case rapidjson::kObjectType:
+				kind = Rule::Kind::OBJECT;
+				break;
+			case rapidjson::kArrayType:
+				kind = Rule::Kind::ARRAY;
+				break;
+			}
+			if (!rule.Accepts(kind))
+			{
+				TypeMismatch(parser, rule, name);
+				return;
+			}
+
+			switch (kind)
+			{
+			case Rule::Kind::INTEGER:
+			case Rule::Kind::NUMBER:
+				if (!rule.IsInRange(value.GetDouble()))
+				{
+					AddError(parser, ErrorType::INVALID_VALUE, name);
+				}
+				break;
+			case Rule::Kind::STRING:
+				if (value.GetStringLength() < rule.MinLength || value.GetStringLength() > rule.MaxLength)
+				{
+					AddError(parser, ErrorType::INVALID_VALUE, name);
+				}
+				break;
+			case Rule::Kind::ARRAY:
+				if (rule.Items != NO_RULE)
+				{
+					const Rule& itemsRule = *Rules[rule.Items];
+					name.StartContext(parser);
+					const rapidjson::Value* elements = value.Begin();
+					for (rapidjson::SizeType i = 0; i < value.Size(); i++)
+					{
+						CheckValue(parser, itemsRule, elements[i], ValueName::Element(i));
+					}
+					name.EndContext(parser);
+				}
+				// checked after the elements, as in streaming mode where the size is known at the end
+				if (value.Size() < rule.MinItems || value.Size() > rule.MaxItems)
+				{
+					AddError(parser, ErrorType::INVALID_VALUE, name);
+				}
+				break;
+			case Rule::Kind::OBJECT:
+				if (rule.Members)
+				{
+					name.StartContext(parser);
+					std::uint64_t seen = 0;
+					for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member)
+					{
+						const char* memberName = member->name.GetString();
+						const size_t length = member->name.GetStringLength();
+						const size_t index = rule.FindMember(memberName, length);
+						if (index == JsonFieldIndex::NOT_FOUND)
+						{
+							continue;
+						}
+						if (index < rule.RequiredCount)
+						{
+							seen |= (std::uint64_t)1 << index;
+						}
+						CheckValue(parser, *Rules[rule.MemberRules[index]], member->value, ValueName::Member(memberName, length));
+					}
+					const std::uint64_t requiredMask = rule.RequiredMask();
+					if ((seen & requiredMask) != requiredMask)
+					{
+						MissingMembers(parser, rule, seen, name.IsRoot);
+					}
+					name.EndContext(parser);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+
+		void JsonValidator::AddError(RapidJsonParser& parser, ErrorType errorType, const ValueName& name)
+		{
+			parser.AddJsonError(errorType, name.ToString());
+		}
+
+
+		void JsonValidator::TypeMismatch(RapidJsonParser& parser, const Rule& rule, const ValueName& name)
+		{
+			if (rule.Type == Rule::Kind::OBJECT || rule.Type == Rule::Kind::ARRAY)
+			{
+				name.StartContext(parser);
+				parser.AddJsonError(rule.Type == Rule::Kind::OBJECT ? ErrorType::NOT_OBJECT : ErrorType::NOT_ARRAY);
+				name.EndContext(parser);
+			}
+			else
+			{
+				AddError(parser, ErrorType::WRONG_TYPE, name);
+			}
+		}
+
+
+		void JsonValidator::MissingMembers(RapidJsonParser& parser, const Rule& rule, std::uint64_t seenMask, bool isRoot)
+		{
+			for (size_t i = 0; i < rule.RequiredCount; i++)
+			{
+				if (!(seenMask & ((std::uint64_t)1 << i)))
+				{
+					parser.AddJsonError(isRoot ? ErrorType::MISSING_ROOT : ErrorType::MISSING_MEMBER, rule.MemberNames[i]);
+				}
+			}
+		}
+	}
+}
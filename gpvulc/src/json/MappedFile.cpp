@@ -0,0 +1,202 @@
+//--------------------------------------------------------------------//
+// Digital Scenario Framework                                         //
+//  by Giovanni Paolo Vigano', 2019-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+#include <gpvulc/json/MappedFile.h>
+
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gpvulc
+{
+	namespace json
+	{
+
+		MappedFile::MappedFile()
+		{
+		}
+
+
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+
+#ifdef _WIN32
+
+		bool MappedFile::Open(const std::string& fileName, bool writable)
+		{
+			Close();
+			Writable = writable;
+			HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return false;
+			}
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize))
+			{
+				CloseHandle(file);
+				return false;
+			}
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			size_t size = (size_t)fileSize.QuadPart;
+
+			// a mapping cannot exceed the file size: the null character is available
+			// only if the file does not end at a page boundary (the rest of the page is zero filled)
+			if (size > 0 && size % systemInfo.dwPageSize != 0)
+			{
+				HANDLE mapping = CreateFileMappingA(file, NULL, writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+				if (mapping)
+				{
+					void* view = MapViewOfFile(mapping, writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+					CloseHandle(mapping);
+					if (view)
+					{
+						Mapping = view;
+						MappingSize = size;
+						Data = (char*)view;
+						Size = size;
+					}
+				}
+			}
+			CloseHandle(file);
+			return IsOpen() || ReadFile(fileName);
+		}
+
+
+		void MappedFile::Close()
+		{
+			if (Mapping)
+			{
+				UnmapViewOfFile(Mapping);
+			}
+			Mapping = nullptr;
+			MappingSize = 0;
+			Data = nullptr;
+			Size = 0;
+			std::vector<char>().swap(Buffer);
+		}
+
+#else
+
+		bool MappedFile::Open(const std::string& fileName, bool writable)
+		{
+			Close();
+			Writable = writable;
+			int fd = open(fileName.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				return false;
+			}
+			struct stat fileStat;
+			if (fstat(fd, &fileStat) != 0)
+			{
+				close(fd);
+				return false;
+			}
+			size_t size = (size_t)fileStat.st_size;
+			int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+
+			if (size > 0)
+			{
+				// reserve a zero filled region with room for the null character,
+				// then map the file over it (the following bytes are always zero)
+				size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+				size_t mappingSize = (size / pageSize + 1) * pageSize;
+				void* region = mmap(nullptr, mappingSize, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (region != MAP_FAILED)
+				{
+					void* view = mmap(region, size, protection, MAP_PRIVATE | MAP_FIXED, fd, 0);
+					if (view != MAP_FAILED)
+					{
+#ifdef MADV_SEQUENTIAL
+						madvise(view, size, MADV_SEQUENTIAL);
+#endif
+						Mapping = region;
+						MappingSize = mappingSize;
+						Data = (char*)region;
+						Size = size;
+					}
+					else
+					{
+						munmap(region, mappingSize);
+					}
+				}
+			}
+			close(fd);
+			return IsOpen() || ReadFile(fileName);
+		}
+
+
+		void MappedFile::Close()
+		{
+			if (Mapping)
+			{
+				munmap(Mapping, MappingSize);
+			}
+			Mapping = nullptr;
+			MappingSize = 0;
+			Data = nullptr;
+			Size = 0;
+			std::vector<char>().swap(Buffer);
+		}
+
+#endif
+
+
+		bool MappedFile::ReadFile(const std::string& fileName)
+		{
+#ifdef _MSC_VER
+			// disable the unsafe warning
+#pragma warning( push )
+#pragma warning( disable : 4996 )
+#endif
+			std::FILE* file = std::fopen(fileName.c_str(), "rb");
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+			if (!file)
+			{
+				return false;
+			}
+			Buffer.clear();
+			const size_t blockSize = 64 * 1024;
+			size_t size = 0;
+			for (;;)
+			{
+				Buffer.resize(size + blockSize);
+				size_t readSize = std::fread(Buffer.data() + size, 1, blockSize, file);
+				size += readSize;
+				if (readSize < blockSize)
+				{
+					break;
+				}
+			}
+			std::fclose(file);
+			Buffer.resize(size + 1);
+			Buffer[size] = '\0';
+			Data = Buffer.data();
+			Size = size;
+			return true;
+		}
+	}
+}
@@ -10,35 +10,520 @@
 #include <string>
 #include <vector>
 #include <iostream>
-#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <climits>
 
 #include <gpvulc/json/RapidJsonParser.h>
 
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/filereadstream.h>
+#include <rapidjson/pointer.h>
+
+namespace
+{
+	// Initial capacity of the DOM parsing stack
+	const size_t PARSE_STACK_CAPACITY = 1024;
+
+	// Room reserved for the header of the DOM memory pool chunk in its arena
+	const size_t ARENA_CHUNK_HEADER_SIZE = 64;
+
+	// Size of the blocks read from files in streaming mode
+	const size_t STREAM_BUFFER_SIZE = 64 * 1024;
+
+
+	// Element type checks and conversions for array getters
+	inline bool IsNumberOf(const rapidjson::Value& val, int*) { return val.IsInt(); }
+	inline bool IsNumberOf(const rapidjson::Value& val, float*) { return val.IsNumber(); }
+	inline bool IsNumberOf(const rapidjson::Value& val, double*) { return val.IsNumber(); }
+
+	inline void GetNumber(const rapidjson::Value& val, int& value) { value = val.GetInt(); }
+	inline void GetNumber(const rapidjson::Value& val, float& value) { value = (float)val.GetDouble(); }
+	inline void GetNumber(const rapidjson::Value& val, double& value) { value = val.GetDouble(); }
+}
+
+
 namespace gpvulc
 {
 	namespace json
 	{
 
+		//! Node of the streaming handlers tree, matching a member name (or any member/element for "*")
+		struct RapidJsonParser::HandlerNode
+		{
+			//! Expected value type
+			enum class ValueKind { NONE, INT, FLOAT, DOUBLE, BOOL, STRING, OBJECT, ARRAY };
+
+			std::string Name;
+			bool Required = false;
+			ValueKind Kind = ValueKind::NONE;
+
+			IntHandler OnInt;
+			FloatHandler OnFloat;
+			DoubleHandler OnDouble;
+			BoolHandler OnBool;
+			StringHandler OnString;
+			ContainerHandler OnStart;
+			ContainerHandler OnEnd;
+
+			//! Named children and wildcard ("*") child
+			std::vector<std::unique_ptr<HandlerNode>> Children;
+			HandlerNode* Wildcard = nullptr;
+
+			bool HasNamedChildren() const
+			{
+				return Children.size() > (Wildcard ? 1u : 0u);
+			}
+
+			//! Check if an object is expected (not a scalar, not only array elements).
+			bool ExpectsObject() const
+			{
+				return Kind == ValueKind::OBJECT || (Kind == ValueKind::NONE && HasNamedChildren());
+			}
+
+			//! Check if an array is expected (not a scalar, not named members).
+			bool ExpectsArray() const
+			{
+				return Kind == ValueKind::ARRAY || (Kind == ValueKind::NONE && !HasNamedChildren());
+			}
+
+			//! Get the index of the named child or -1 if not found.
+			int FindChild(const char* name, size_t length) const
+			{
+				for (size_t i = 0; i < Children.size(); i++)
+				{
+					const std::string& childName = Children[i]->Name;
+					if (Children[i].get() != Wildcard && childName.size() == length
+						&& std::memcmp(childName.data(), name, length) == 0)
+					{
+						return (int)i;
+					}
+				}
+				return -1;
+			}
+		};
+
+
+		/*!
+		SAX handler for rapidjson Reader, calling the streaming handlers of a RapidJsonParser.
+		The handlers tree is followed while reading the document,
+		subtrees without handlers are skipped only counting their depth.
+		*/
+		class RapidJsonParser::StreamHandler
+			: public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, RapidJsonParser::StreamHandler>
+		{
+		public:
+
+			typedef HandlerNode::ValueKind ValueKind;
+
+			StreamHandler(RapidJsonParser& parser)
+				: Parser(parser)
+			{
+			}
+
+			//! Prepare for a new document, keeping the allocated memory.
+			void Start()
+			{
+				Root = Parser.StreamHandlers.get();
+				Frames.clear();
+				Seen.clear();
+				SkipDepth = 0;
+				PendingNode = nullptr;
+			}
+
+			bool Null()
+			{
+				ValueNode value = NextValue();
+				if (value.Node)
+				{
+					TypeMismatch(value);
+				}
+				return true;
+			}
+
+			bool Bool(bool boolValue)
+			{
+				ValueNode value = NextValue();
+				if (value.Node)
+				{
+					if (value.Node->Kind == ValueKind::BOOL)
+					{
+						Call(value.Node->OnBool, boolValue);
+					}
+					else
+					{
+						TypeMismatch(value);
+					}
+				}
+				return true;
+			}
+
+			bool Int(int intValue)
+			{
+				return Integer(true, intValue, intValue);
+			}
+
+			// rapidjson reports non-negative integers as unsigned and large integers as 64 bit
+			bool Uint(unsigned uintValue)
+			{
+				return Integer(uintValue <= (unsigned)INT_MAX, (int)uintValue, (double)uintValue);
+			}
+
+			bool Int64(int64_t int64Value)
+			{
+				return Integer(int64Value >= INT_MIN && int64Value <= INT_MAX, (int)int64Value, (double)int64Value);
+			}
+
+			bool Uint64(uint64_t uint64Value)
+			{
+				return Integer(uint64Value <= (uint64_t)INT_MAX, (int)uint64Value, (double)uint64Value);
+			}
+
+			bool Double(double doubleValue)
+			{
+				return Number(doubleValue);
+			}
+
+			bool String(const char* str, rapidjson::SizeType length, bool)
+			{
+				ValueNode value = NextValue();
+				if (value.Node)
+				{
+					if (value.Node->Kind == ValueKind::STRING)
+					{
+						Call(value.Node->OnString, str, (size_t)length);
+					}
+					else
+					{
+						TypeMismatch(value);
+					}
+				}
+				return true;
+			}
+
+			bool Key(const char* str, rapidjson::SizeType length, bool)
+			{
+				if (SkipDepth > 0)
+				{
+					return true;
+				}
+				Frame& frame = Frames.back();
+				int childIndex = frame.Node->FindChild(str, length);
+				if (childIndex >= 0)
+				{
+					Seen[frame.SeenOffset + childIndex] = true;
+					PendingNode = frame.Node->Children[childIndex].get();
+				}
+				else
+				{
+					PendingNode = frame.Node->Wildcard;
+				}
+				if (PendingNode)
+				{
+					PendingKey.assign(str, length);
+				}
+				return true;
+			}
+
+			bool StartObject()
+			{
+				ValueNode value = NextValue();
+				if (!value.Node)
+				{
+					SkipDepth++;
+					return true;
+				}
+				if (!value.Node->ExpectsObject() && !(value.Node->Kind == ValueKind::NONE && value.Node->Wildcard))
+				{
+					TypeMismatch(value);
+					SkipDepth++;
+					return true;
+				}
+				PushFrame(value, false);
+				if (value.Node->Kind == ValueKind::OBJECT)
+				{
+					Call(value.Node->OnStart);
+				}
+				return true;
+			}
+
+			bool EndObject(rapidjson::SizeType)
+			{
+				if (SkipDepth > 0)
+				{
+					SkipDepth--;
+					return true;
+				}
+				const Frame& frame = Frames.back();
+				const HandlerNode& node = *frame.Node;
+				for (size_t i = 0; i < node.Children.size(); i++)
+				{
+					const HandlerNode& child = *node.Children[i];
+					if (child.Required && !Seen[frame.SeenOffset + i])
+					{
+						Parser.AddJsonError(Frames.size() == 1 ? ErrorType::MISSING_ROOT : ErrorType::MISSING_MEMBER, child.Name);
+					}
+				}
+				if (node.Kind == ValueKind::OBJECT)
+				{
+					Call(node.OnEnd);
+				}
+				PopFrame();
+				return true;
+			}
+
+			bool StartArray()
+			{
+				ValueNode value = NextValue();
+				if (!value.Node)
+				{
+					SkipDepth++;
+					return true;
+				}
+				if (!value.Node->ExpectsArray())
+				{
+					TypeMismatch(value);
+					SkipDepth++;
+					return true;
+				}
+				PushFrame(value, true);
+				if (value.Node->Kind == ValueKind::ARRAY)
+				{
+					Call(value.Node->OnStart);
+				}
+				return true;
+			}
+
+			bool EndArray(rapidjson::SizeType)
+			{
+				if (SkipDepth > 0)
+				{
+					SkipDepth--;
+					return true;
+				}
+				const HandlerNode& node = *Frames.back().Node;
+				if (node.Kind == ValueKind::ARRAY)
+				{
+					Call(node.OnEnd);
+				}
+				PopFrame();
+				return true;
+			}
+
+		private:
+
+			//! Node matching a value and its name or array index (used for error messages)
+			struct ValueNode
+			{
+				const HandlerNode* Node = nullptr;
+				const char* Name = "";
+				size_t Index = 0;
+				bool IsElement = false;
+			};
+
+			//! Object or array with handlers
+			struct Frame
+			{
+				const HandlerNode* Node;
+				bool IsArray;
+				size_t NextIndex;
+				size_t SeenOffset;
+				bool HasContext;
+			};
+
+			RapidJsonParser& Parser;
+			const HandlerNode* Root = nullptr;
+			std::vector<Frame> Frames;
+			//! Flags of the seen children for each object in Frames
+			std::vector<bool> Seen;
+			size_t SkipDepth = 0;
+			const HandlerNode* PendingNode = nullptr;
+			std::string PendingKey;
+
+			//! Get the handlers node for the next value (nullptr if the value must be skipped).
+			ValueNode NextValue()
+			{
+				ValueNode value;
+				if (SkipDepth > 0)
+				{
+					return value;
+				}
+				if (Frames.empty())
+				{
+					// skip the whole document if there are no handlers
+					value.Node = Root->Children.empty() && Root->Kind == ValueKind::NONE ? nullptr : Root;
+					return value;
+				}
+				Frame& frame = Frames.back();
+				if (frame.IsArray)
+				{
+					value.Node = frame.Node->Wildcard;
+					value.Index = frame.NextIndex++;
+					value.IsElement = true;
+				}
+				else
+				{
+					value.Node = PendingNode;
+					value.Name = PendingKey.c_str();
+					PendingNode = nullptr;
+				}
+				return value;
+			}
+
+			void PushFrame(const ValueNode& value, bool isArray)
+			{
+				bool hasContext = !Frames.empty();
+				if (hasContext)
+				{
+					if (value.IsElement)
+					{
+						Parser.StartContext(value.Index);
+					}
+					else
+					{
+						Parser.StartContext(value.Name, PendingKey.size());
+					}
+				}
+				size_t seenOffset = Seen.size();
+				if (!isArray)
+				{
+					Seen.resize(seenOffset + value.Node->Children.size(), false);
+				}
+				Frames.push_back({ value.Node, isArray, 0, seenOffset, hasContext });
+			}
+
+			void PopFrame()
+			{
+				const Frame& frame = Frames.back();
+				Seen.resize(frame.SeenOffset);
+				if (frame.HasContext)
+				{
+					Parser.EndContext();
+				}
+				Frames.pop_back();
+			}
+
+			//! Handle a number for a node expecting a floating point value.
+			void Number(const ValueNode& value, double number)
+			{
+				if (value.Node->Kind == ValueKind::DOUBLE)
+				{
+					Call(value.Node->OnDouble, number);
+				}
+				else if (value.Node->Kind == ValueKind::FLOAT)
+				{
+					Call(value.Node->OnFloat, (float)number);
+				}
+				else
+				{
+					TypeMismatch(value);
+				}
+			}
+
+			/*!
+			Handle an integer value: integer handlers are called if it fits in an int
+			(else an error is registered), floating point handlers accept any integer.
+			*/
+			bool Integer(bool fitsInt, int intValue, double number)
+			{
+				ValueNode value = NextValue();
+				if (value.Node)
+				{
+					if (value.Node->Kind != ValueKind::INT)
+					{
+						Number(value, number);
+					}
+					else if (fitsInt)
+					{
+						Call(value.Node->OnInt, intValue);
+					}
+					else
+					{
+						Parser.AddJsonError(ErrorType::INVALID_VALUE, value.IsElement ? std::to_string(value.Index) : value.Name);
+					}
+				}
+				return true;
+			}
+
+			bool Number(double number)
+			{
+				ValueNode value = NextValue();
+				if (value.Node)
+				{
+					Number(value, number);
+				}
+				return true;
+			}
+
+			//! Register an error for a value of unexpected type.
+			void TypeMismatch(const ValueNode& value)
+			{
+				const HandlerNode& node = *value.Node;
+				std::string name = value.IsElement ? std::to_string(value.Index) : value.Name;
+				if (node.Kind == ValueKind::NONE || node.Kind == ValueKind::OBJECT || node.Kind == ValueKind::ARRAY)
+				{
+					Parser.StartContext(name);
+					Parser.AddJsonError(node.ExpectsObject() ? ErrorType::NOT_OBJECT : ErrorType::NOT_ARRAY);
+					Parser.EndContext();
+				}
+				else
+				{
+					Parser.AddJsonError(ErrorType::WRONG_TYPE, name);
+				}
+			}
+
+			//! Call a handler, registering an error if an exception is thrown.
+			template <typename Handler, typename... Args>
+			void Call(const Handler& handler, Args... args)
+			{
+				if (!handler)
+				{
+					return;
+				}
+				try
+				{
+					handler(args...);
+				}
+				catch (const std::exception& e)
+				{
+					Parser.AddJsonError(ErrorType::UNHANDLED_EXCEPTION, e.what());
+				}
+			}
+		};
+
+
 		RapidJsonParser::RapidJsonParser()
+			: DocumentAllocator(new rapidjson::MemoryPoolAllocator<>)
+			, DocumentBuffer(DocumentAllocator.get(), PARSE_STACK_CAPACITY, &StackAllocator)
+			, StreamHandlers(new HandlerNode)
+		{
+		}
+
+
+		RapidJsonParser::~RapidJsonParser()
 		{
 		}
 
 
 		bool RapidJsonParser::HasRootElement(const char* name)
 		{
-			return DocumentBuffer.HasMember(name);
+			return FindMember(DocumentBuffer, name) != nullptr;
 		}
 
 
 		const rapidjson::Value& RapidJsonParser::GetRootElement(const char* name)
 		{
-			if (!DocumentBuffer.HasMember(name))
+			const rapidjson::Value* root = FindMember(DocumentBuffer, name);
+			if (!root)
 			{
 				AddJsonError(ErrorType::MISSING_ROOT, name);
 				throw ContentException(GetJsonErrorSummary(true));
 			}
 
-			return DocumentBuffer[name];
+			return *root;
 		}
 
 
@@ -50,45 +535,95 @@ namespace gpvulc
 
 		void RapidJsonParser::StartContext(const char* name)
 		{
-			PathToMember.push_back(name);
+			PathToMember.push_back({ name, 0, false });
 		}
 
 
 		void RapidJsonParser::StartContext(const std::string& name)
 		{
-			PathToMember.push_back(name);
+			StartContext(name.c_str(), name.size());
+		}
+
+
+		void RapidJsonParser::StartContext(const char* name, size_t length)
+		{
+			PathToMember.push_back({ nullptr, ContextNames.size(), false });
+			ContextNames.append(name, length);
+			ContextNames.push_back('\0');
+		}
+
+
+		void RapidJsonParser::StartContext(size_t index)
+		{
+			PathToMember.push_back({ nullptr, index, true });
 		}
 
 
 		void RapidJsonParser::EndContext()
 		{
+			const ContextEntry& entry = PathToMember.back();
+			if (!entry.Name && !entry.IsIndex)
+			{
+				ContextNames.resize(entry.Value);
+			}
 			PathToMember.pop_back();
 		}
 
 
+		void RapidJsonParser::RestoreContext(size_t depth)
+		{
+			while (PathToMember.size() > depth)
+			{
+				EndContext();
+			}
+		}
+
+
 		void RapidJsonParser::AddJsonError(ErrorType errorType, const std::string& elementName)
 		{
+			if (MaxErrors > 0 && ErrorList.size() >= MaxErrors)
+			{
+				DiscardedErrors++;
+				return;
+			}
 			ErrorList.push_back({ GetPathToMember(), errorType, elementName });
+			if (StopOnMaxErrors && ErrorList.size() == MaxErrors)
+			{
+				throw ContentException(GetJsonErrorSummary(true));
+			}
 		}
 
+
 		const char* RapidJsonParser::GetJsonErrorSummary(bool notNull)
 		{
-			static std::string errorSummary;
-			std::ostringstream oStr;
+			ErrorSummary.clear();
 			for (size_t i = 0; i < ErrorList.size(); i++)
 			{
 				if (!ErrorList[i].Context.empty())
 				{
-					oStr << ErrorList[i].Context << ": ";
+					ErrorSummary += ErrorList[i].Context;
+					ErrorSummary += ": ";
 				}
-				oStr << ErrorTypeToString(ErrorList[i].Type) << ErrorList[i].Element << "\n";
+				ErrorSummary += ErrorTypeToString(ErrorList[i].Type);
+				ErrorSummary += ErrorList[i].Element;
+				ErrorSummary += "\n";
 			}
-			errorSummary = oStr.str();
-			if (errorSummary.empty())
+			if (DiscardedErrors > 0)
+			{
+				ErrorSummary += "(" + std::to_string(DiscardedErrors) + " more errors)\n";
+			}
+			if (ErrorSummary.empty())
 			{
 				return notNull ? "" : nullptr;
 			}
-			return errorSummary.c_str();
+			return ErrorSummary.c_str();
+		}
+
+
+		void RapidJsonParser::SetMaxErrors(size_t maxErrors, bool stopOnLimit)
+		{
+			MaxErrors = maxErrors;
+			StopOnMaxErrors = stopOnLimit;
 		}
 
 
@@ -99,7 +634,7 @@ namespace gpvulc
 				AddJsonError(ErrorType::NOT_OBJECT);
 				return "";
 			}
-			if (!val.HasMember(name))
+			if (!FindMember(val, name))
 			{
 				if (!optional)
 				{
@@ -124,7 +659,7 @@ namespace gpvulc
 			bool missing = false;
 			for (const char* memberName : membersNames)
 			{
-				if (!val.HasMember(memberName))
+				if (!FindMember(val, memberName))
 				{
 					AddJsonError(ErrorType::MISSING_MEMBER, memberName);
 					missing = true;
@@ -156,6 +691,58 @@ namespace gpvulc
 		}
 
 
+		bool RapidJsonParser::CheckHasArray(const rapidjson::Value& val, const char* name, bool optional)
+		{
+			return CheckHasMember(val, name, optional) && CheckIsArray(*FindMember(val, name));
+		}
+
+
+		void RapidJsonParser::SetIndexing(bool enable, size_t minIndexedMembers)
+		{
+			if (!enable)
+			{
+				Index.reset();
+				return;
+			}
+			if (!Index)
+			{
+				Index.reset(new JsonPathIndex(minIndexedMembers));
+				Index->Reset(&DocumentBuffer);
+			}
+			Index->SetMinIndexedMembers(minIndexedMembers);
+		}
+
+
+		const rapidjson::Value* RapidJsonParser::FindMember(const rapidjson::Value& val, const char* name)
+		{
+			if (Index)
+			{
+				return Index->FindMember(val, name);
+			}
+			if (!val.IsObject())
+			{
+				return nullptr;
+			}
+			rapidjson::Value::ConstMemberIterator member = val.FindMember(name);
+			return member != val.MemberEnd() ? &member->value : nullptr;
+		}
+
+
+		const rapidjson::Value* RapidJsonParser::FindValue(const char* pointer)
+		{
+			if (Index)
+			{
+				return Index->Find(pointer);
+			}
+			rapidjson::Pointer jsonPointer(pointer);
+			if (!jsonPointer.IsValid())
+			{
+				return nullptr;
+			}
+			return jsonPointer.Get(static_cast<const rapidjson::Value&>(DocumentBuffer));
+		}
+
+
 		const char* RapidJsonParser::GetString(const rapidjson::Value& val, const char* context)
 		{
 			if (!val.IsString())
@@ -211,7 +798,8 @@ namespace gpvulc
 				AddJsonError(ErrorType::NOT_OBJECT);
 				return "";
 			}
-			if (!val.HasMember(name))
+			const rapidjson::Value* member = FindMember(val, name);
+			if (!member)
 			{
 				if (!optional)
 				{
@@ -219,12 +807,12 @@ namespace gpvulc
 				}
 				return "";
 			}
-			if (!val[name].IsString())
+			if (!member->IsString())
 			{
 				AddJsonError(ErrorType::WRONG_TYPE, name);
 				return "";
 			}
-			return val[name].GetString();
+			return member->GetString();
 		}
 
 
@@ -240,7 +828,8 @@ namespace gpvulc
 				AddJsonError(ErrorType::NOT_OBJECT);
 				return defaultValue;
 			}
-			if (!val.HasMember(name))
+			const rapidjson::Value* member = FindMember(val, name);
+			if (!member)
 			{
 				if (!optional)
 				{
@@ -248,12 +837,12 @@ namespace gpvulc
 				}
 				return defaultValue;
 			}
-			if (!val[name].IsInt())
+			if (!member->IsInt())
 			{
 				AddJsonError(ErrorType::WRONG_TYPE, name);
 				return defaultValue;
 			}
-			return val[name].GetInt();
+			return member->GetInt();
 		}
 
 
@@ -264,7 +853,8 @@ namespace gpvulc
 				AddJsonError(ErrorType::NOT_OBJECT);
 				return "";
 			}
-			if (!val.HasMember(name))
+			const rapidjson::Value* member = FindMember(val, name);
+			if (!member)
 			{
 				if (!optional)
 				{
@@ -272,12 +862,12 @@ namespace gpvulc
 				}
 				return defaultValue;
 			}
-			if (!val[name].IsBool())
+			if (!member->IsBool())
 			{
 				AddJsonError(ErrorType::WRONG_TYPE, name);
 				return defaultValue;
 			}
-			return val[name].GetBool();
+			return member->GetBool();
 		}
 
 
@@ -293,7 +883,8 @@ namespace gpvulc
 				AddJsonError(ErrorType::NOT_OBJECT);
 				return defaultValue;
 			}
-			if (!val.HasMember(name))
+			const rapidjson::Value* member = FindMember(val, name);
+			if (!member)
 			{
 				if (!optional)
 				{
@@ -301,12 +892,158 @@ namespace gpvulc
 				}
 				return defaultValue;
 			}
-			if (!val[name].IsFloat())
+			if (!member->IsFloat())
 			{
 				AddJsonError(ErrorType::WRONG_TYPE, name);
 				return defaultValue;
 			}
-			return val[name].GetFloat();
+			return member->GetFloat();
+		}
+
+
+		template <typename T>
+		size_t RapidJsonParser::ReadNumberArray(const rapidjson::Value& val, T* values, size_t maxCount, const char* context)
+		{
+			if (!val.IsArray())
+			{
+				// reported in the context of the value, as CheckIsArray() does
+				const size_t contextDepth = PathToMember.size();
+				if (*context != '\0')
+				{
+					StartContext(context);
+				}
+				try
+				{
+					AddJsonError(ErrorType::NOT_ARRAY);
+				}
+				catch (...)
+				{
+					RestoreContext(contextDepth);
+					throw;
+				}
+				RestoreContext(contextDepth);
+				return 0;
+			}
+			const size_t count = val.Size();
+			const size_t stored = std::min(count, maxCount);
+			const rapidjson::Value* elements = val.Begin();
+			size_t firstInvalid = stored;
+			for (size_t i = 0; i < stored; i++)
+			{
+				if (IsNumberOf(elements[i], values))
+				{
+					GetNumber(elements[i], values[i]);
+				}
+				else
+				{
+					values[i] = 0;
+					firstInvalid = std::min(firstInvalid, i);
+				}
+			}
+			if (firstInvalid < stored)
+			{
+				// one error for the whole array, reporting the first invalid element
+				std::string element(context);
+				if (!element.empty())
+				{
+					element += "/";
+				}
+				element += std::to_string(firstInvalid);
+				AddJsonError(ErrorType::WRONG_TYPE, element);
+			}
+			return count;
+		}
+
+
+		template <typename T>
+		bool RapidJsonParser::ReadNumberArray(const rapidjson::Value& val, std::vector<T>& values, const char* context)
+		{
+			const size_t errorCount = GetErrorCount();
+			values.resize(val.IsArray() ? val.Size() : 0);
+			ReadNumberArray(val, values.data(), values.size(), context);
+			return GetErrorCount() == errorCount;
+		}
+
+
+		template <typename T>
+		bool RapidJsonParser::ReadNumberArrayMember(
+			const rapidjson::Value& val,
+			const char* name,
+			std::vector<T>& values,
+			bool optional
+			)
+		{
+			values.clear();
+			if (!val.IsObject())
+			{
+				AddJsonError(ErrorType::NOT_OBJECT);
+				return false;
+			}
+			const rapidjson::Value* member = FindMember(val, name);
+			if (!member)
+			{
+				if (!optional)
+				{
+					AddJsonError(ErrorType::MISSING_MEMBER, name);
+					return false;
+				}
+				return true;
+			}
+			return ReadNumberArray(*member, values, name);
+		}
+
+
+		bool RapidJsonParser::GetArray(const rapidjson::Value& val, std::vector<int>& values, const char* context)
+		{
+			return ReadNumberArray(val, values, context);
+		}
+
+
+		bool RapidJsonParser::GetArray(const rapidjson::Value& val, std::vector<float>& values, const char* context)
+		{
+			return ReadNumberArray(val, values, context);
+		}
+
+
+		bool RapidJsonParser::GetArray(const rapidjson::Value& val, std::vector<double>& values, const char* context)
+		{
+			return ReadNumberArray(val, values, context);
+		}
+
+
+		size_t RapidJsonParser::GetArray(const rapidjson::Value& val, int* values, size_t maxCount, const char* context)
+		{
+			return ReadNumberArray(val, values, maxCount, context);
+		}
+
+
+		size_t RapidJsonParser::GetArray(const rapidjson::Value& val, float* values, size_t maxCount, const char* context)
+		{
+			return ReadNumberArray(val, values, maxCount, context);
+		}
+
+
+		size_t RapidJsonParser::GetArray(const rapidjson::Value& val, double* values, size_t maxCount, const char* context)
+		{
+			return ReadNumberArray(val, values, maxCount, context);
+		}
+
+
+		bool RapidJsonParser::GetAsArray(const rapidjson::Value& val, const char* name, std::vector<int>& values, bool optional)
+		{
+			return ReadNumberArrayMember(val, name, values, optional);
+		}
+
+
+		bool RapidJsonParser::GetAsArray(const rapidjson::Value& val, const char* name, std::vector<float>& values, bool optional)
+		{
+			return ReadNumberArrayMember(val, name, values, optional);
+		}
+
+
+		bool RapidJsonParser::GetAsArray(const rapidjson::Value& val, const char* name, std::vector<double>& values, bool optional)
+		{
+			return ReadNumberArrayMember(val, name, values, optional);
 		}
 
 
@@ -319,26 +1056,134 @@ namespace gpvulc
 				{
 					path += "/";
 				}
-				path += PathToMember[i];
+				const ContextEntry& entry = PathToMember[i];
+				if (entry.IsIndex)
+				{
+					path += std::to_string(entry.Value);
+				}
+				else
+				{
+					path += entry.Name ? entry.Name : ContextNames.c_str() + entry.Value;
+				}
 			}
 			return path;
 		}
 
 
+		void RapidJsonParser::ClearDocument()
+		{
+			// Value::Clear() is only valid for arrays
+			DocumentBuffer.SetNull();
+			DocumentFile.Close();
+			DocumentCache.Close();
+			if (Index)
+			{
+				Index->Reset(&DocumentBuffer);
+			}
+			StackAllocator.Clear();
+
+			// if the arena was not enough for the last document other chunks were allocated
+			size_t usedSize = DocumentAllocator->Size();
+			bool overflow = DocumentAllocator->Capacity() > DocumentArena.size();
+			if (overflow && DocumentArena.size() < MaxRetainedMemory)
+			{
+				ResizeDocumentArena(std::min(usedSize + usedSize / 4 + ARENA_CHUNK_HEADER_SIZE, MaxRetainedMemory));
+			}
+			else if (DocumentArena.size() > MaxRetainedMemory)
+			{
+				ResizeDocumentArena(MaxRetainedMemory);
+			}
+			else
+			{
+				DocumentAllocator->Clear();
+			}
+		}
+
+
+		void RapidJsonParser::ResizeDocumentArena(size_t size)
+		{
+			std::vector<char> arena(size > ARENA_CHUNK_HEADER_SIZE ? size : 0);
+			std::unique_ptr<rapidjson::MemoryPoolAllocator<>> allocator(arena.empty()
+				? new rapidjson::MemoryPoolAllocator<>
+				: new rapidjson::MemoryPoolAllocator<>(arena.data(), arena.size()));
+			{
+				// a document cannot change its allocator: swap with a new (empty) document
+				ArenaDocument document(allocator.get(), PARSE_STACK_CAPACITY, &StackAllocator);
+				DocumentBuffer.Swap(document);
+			}
+			// the old allocator must be destroyed before its arena
+			DocumentAllocator.swap(allocator);
+			allocator.reset();
+			DocumentArena.swap(arena);
+		}
+
+
+		void RapidJsonParser::SetMaxRetainedMemory(size_t maxBytes)
+		{
+			MaxRetainedMemory = maxBytes;
+			StackAllocator.SetMaxRetainedSize(maxBytes);
+		}
+
+
+		size_t RapidJsonParser::GetRetainedMemory() const
+		{
+			return DocumentArena.size() + StackAllocator.GetRetainedSize();
+		}
+
+
 		void RapidJsonParser::Reset()
 		{
-			DocumentBuffer.Clear();
+			ClearDocument();
 			PathToMember.clear();
+			ContextNames.clear();
 			ErrorList.clear();
+			DiscardedErrors = 0;
 		}
 
+
 		void RapidJsonParser::Parse(const std::string& jsonText)
 		{
-			//Reset();
+			ClearDocument();
 			DocumentBuffer.Parse(jsonText);
 		}
 
 
+		void RapidJsonParser::ParseInsitu(char* jsonText)
+		{
+			ClearDocument();
+			DocumentBuffer.ParseInsitu(jsonText);
+		}
+
+
+		bool RapidJsonParser::ParseFile(const std::string& fileName)
+		{
+			ClearDocument();
+			if (!DocumentFile.Open(fileName, true))
+			{
+				return false;
+			}
+			DocumentBuffer.ParseInsitu(DocumentFile.GetWritableData());
+			return true;
+		}
+
+
+		bool RapidJsonParser::ParseFileCached(const std::string& fileName, const std::string& cacheFileName)
+		{
+			const std::string cacheName = cacheFileName.empty() ? fileName + JsonBinaryCache::DEFAULT_EXTENSION : cacheFileName;
+			ClearDocument();
+			if (DocumentCache.Open(cacheName, fileName) && DocumentCache.Load(DocumentBuffer))
+			{
+				return true;
+			}
+			if (!ParseFile(fileName))
+			{
+				return false;
+			}
+			JsonBinaryCache::Write(DocumentBuffer, fileName, cacheName);
+			return true;
+		}
+
+
 		void RapidJsonParser::CheckJsonErrors()
 		{
 			if (ErrorsOccurred())
@@ -346,5 +1191,194 @@ namespace gpvulc
 				throw ContentException(GetJsonErrorSummary(true));
 			}
 		}
+
+
+		RapidJsonParser::HandlerNode& RapidJsonParser::GetHandlerNode(const std::string& path, bool optional)
+		{
+			HandlerNode* node = StreamHandlers.get();
+			size_t begin = 0;
+			while (begin <= path.size())
+			{
+				size_t end = path.find('/', begin);
+				if (end == std::string::npos)
+				{
+					end = path.size();
+				}
+				std::string name = path.substr(begin, end - begin);
+				begin = end + 1;
+				if (name.empty())
+				{
+					continue;
+				}
+
+				bool isWildcard = name == "*";
+				HandlerNode* child = isWildcard ? node->Wildcard : nullptr;
+				if (!isWildcard)
+				{
+					int childIndex = node->FindChild(name.data(), name.size());
+					child = childIndex >= 0 ? node->Children[childIndex].get() : nullptr;
+				}
+				if (!child)
+				{
+					node->Children.emplace_back(new HandlerNode);
+					child = node->Children.back().get();
+					child->Name = name;
+					if (isWildcard)
+					{
+						node->Wildcard = child;
+					}
+				}
+				// required members are checked in each object matched by the parent node
+				if (!isWildcard && !optional)
+				{
+					child->Required = true;
+				}
+				node = child;
+			}
+			return *node;
+		}
+
+
+		void RapidJsonParser::AddIntHandler(const std::string& path, IntHandler handler, bool optional)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::INT;
+			node.OnInt = handler;
+		}
+
+
+		void RapidJsonParser::AddFloatHandler(const std::string& path, FloatHandler handler, bool optional)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::FLOAT;
+			node.OnFloat = handler;
+		}
+
+
+		void RapidJsonParser::AddDoubleHandler(const std::string& path, DoubleHandler handler, bool optional)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::DOUBLE;
+			node.OnDouble = handler;
+		}
+
+
+		void RapidJsonParser::AddBoolHandler(const std::string& path, BoolHandler handler, bool optional)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::BOOL;
+			node.OnBool = handler;
+		}
+
+
+		void RapidJsonParser::AddStringHandler(const std::string& path, StringHandler handler, bool optional)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::STRING;
+			node.OnString = handler;
+		}
+
+
+		void RapidJsonParser::AddObjectHandler(
+			const std::string& path,
+			ContainerHandler startHandler,
+			ContainerHandler endHandler,
+			bool optional
+			)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::OBJECT;
+			node.OnStart = startHandler;
+			node.OnEnd = endHandler;
+		}
+
+
+		void RapidJsonParser::AddArrayHandler(
+			const std::string& path,
+			ContainerHandler startHandler,
+			ContainerHandler endHandler,
+			bool optional
+			)
+		{
+			HandlerNode& node = GetHandlerNode(path, optional);
+			node.Kind = HandlerNode::ValueKind::ARRAY;
+			node.OnStart = startHandler;
+			node.OnEnd = endHandler;
+		}
+
+
+		void RapidJsonParser::ClearHandlers()
+		{
+			StreamHandlers.reset(new HandlerNode);
+		}
+
+
+		template <typename InputStream>
+		void RapidJsonParser::ParseInputStream(InputStream& inputStream)
+		{
+			size_t contextDepth = PathToMember.size();
+			if (!Streamer)
+			{
+				Streamer.reset(new StreamHandler(*this));
+			}
+			Streamer->Start();
+			StackAllocator.Clear();
+			rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, ArenaAllocator> reader(&StackAllocator);
+			try
+			{
+				reader.Parse(inputStream, *Streamer);
+			}
+			catch (...)
+			{
+				// restore the context before propagating parsing errors
+				RestoreContext(contextDepth);
+				throw;
+			}
+		}
+
+
+		void RapidJsonParser::ParseStream(const char* jsonText, size_t length)
+		{
+			rapidjson::MemoryStream memoryStream(jsonText, length);
+			ParseInputStream(memoryStream);
+		}
+
+
+		void RapidJsonParser::ParseStream(std::istream& jsonStream)
+		{
+			rapidjson::IStreamWrapper streamWrapper(jsonStream);
+			ParseInputStream(streamWrapper);
+		}
+
+
+		bool RapidJsonParser::ParseFileStream(const std::string& fileName)
+		{
+#ifdef _MSC_VER
+			// disable the unsafe warning
+#pragma warning( push )
+#pragma warning( disable : 4996 )
+#endif
+			std::FILE* file = std::fopen(fileName.c_str(), "rb");
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+			if (!file)
+			{
+				return false;
+			}
+			StreamBuffer.resize(STREAM_BUFFER_SIZE);
+			rapidjson::FileReadStream fileStream(file, StreamBuffer.data(), StreamBuffer.size());
+			try
+			{
+				ParseInputStream(fileStream);
+			}
+			catch (...)
+			{
+				std::fclose(file);
+				throw;
+			}
+			std::fclose(file);
+			return true;
+		}
 	}
 }
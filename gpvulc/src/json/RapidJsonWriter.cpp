@@ -9,6 +9,35 @@
 
 #include <gpvulc/json/RapidJsonWriter.h>
 
+#ifdef _WIN32
+#include <io.h>
+#include <climits>
+#else
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+	// Number of array elements written between output checks (see RapidJsonWriter::CheckOutput())
+	const size_t ARRAY_OUTPUT_CHECK_PERIOD = 4096;
+
+
+	template <typename Writer>
+	inline void WriteNumber(Writer& writer, int value)
+	{
+		writer.Int(value);
+	}
+
+
+	template <typename Writer>
+	inline void WriteNumber(Writer& writer, double value)
+	{
+		writer.Double(value);
+	}
+}
+
+
 namespace gpvulc
 {
 	namespace json
@@ -18,9 +47,11 @@ namespace gpvulc
 
 		RapidJsonWriter::RapidJsonWriter()
 			: Writer(Buffer)
+			, CompactWriter(Buffer)
 		{
 			Buffer.Clear();
 			Writer.SetMaxDecimalPlaces(5);
+			CompactWriter.SetMaxDecimalPlaces(5);
 		}
 
 
@@ -28,17 +59,98 @@ namespace gpvulc
 		{
 			Buffer.Clear();
 			Writer.Reset(Buffer);
+			CompactWriter.Reset(Buffer);
 		}
 
 
 		void RapidJsonWriter::CopyDocument(std::string& jsonText)
 		{
-			jsonText = Buffer.GetString();
+			jsonText.assign(Buffer.GetString(), Buffer.GetSize());
+		}
+
+
+		void RapidJsonWriter::MoveDocument(std::string& jsonText)
+		{
+			jsonText.swap(Buffer.GetText());
+			Buffer.Clear();
+		}
+
+
+		void RapidJsonWriter::StreamTo(std::ostream& outStream, size_t chunkSize)
+		{
+			StopStreaming();
+			OutputStream = &outStream;
+			ChunkSize = chunkSize;
+		}
+
+
+		void RapidJsonWriter::StreamTo(int fileDescriptor, size_t chunkSize)
+		{
+			StopStreaming();
+			OutputFile = fileDescriptor;
+			ChunkSize = chunkSize;
+		}
+
+
+		void RapidJsonWriter::StopStreaming()
+		{
+			FlushOutput();
+			OutputStream = nullptr;
+			OutputFile = -1;
+			ChunkSize = (size_t)-1;
+		}
+
+
+		void RapidJsonWriter::FlushOutput()
+		{
+			if (Buffer.GetSize() == 0)
+			{
+				return;
+			}
+			const char* data = Buffer.GetString();
+			size_t size = Buffer.GetSize();
+			if (OutputStream)
+			{
+				OutputStream->write(data, (std::streamsize)size);
+				if (!*OutputStream)
+				{
+					throw OutputException("Failed to write JSON to the output stream");
+				}
+			}
+			else if (OutputFile >= 0)
+			{
+				while (size > 0)
+				{
+#ifdef _WIN32
+					int written = _write(OutputFile, data, (unsigned)std::min<size_t>(size, INT_MAX));
+#else
+					ssize_t written = write(OutputFile, data, size);
+					if (written < 0 && errno == EINTR)
+					{
+						continue;
+					}
+#endif
+					if (written <= 0)
+					{
+						throw OutputException("Failed to write JSON to the output file");
+					}
+					data += written;
+					size -= (size_t)written;
+				}
+			}
+			else
+			{
+				// not streaming, keep the document in memory
+				return;
+			}
+			Buffer.Clear();
 		}
 
+
 		void RapidJsonWriter::SetDecimalPrecision(int numDigits)
 		{
 			Writer.SetMaxDecimalPlaces(numDigits);
+			CompactWriter.SetMaxDecimalPlaces(numDigits);
 		}
 
 
@@ -55,80 +167,127 @@ namespace gpvulc
 		{
 			EndObject();
 
-			CopyDocument(jsonText);
+			if (IsStreaming())
+			{
+				FlushOutput();
+				jsonText.clear();
+			}
+			else
+			{
+				MoveDocument(jsonText);
+			}
 			ResetDocument();
 		}
 
 
-		void RapidJsonWriter::StartObject(const char* memberName)
+		void RapidJsonWriter::EndDocument()
 		{
-			if (memberName)
+			EndObject();
+
+			FlushOutput();
+			if (OutputStream)
 			{
-				Writer.Key(memberName);
+				OutputStream->flush();
 			}
-			Writer.StartObject();
+			ResetDocument();
+		}
+
+
+		void RapidJsonWriter::StartObject(const char* memberName)
+		{
+			WithWriter([=](auto& writer)
+			{
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.StartObject();
+			});
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::EndObject()
 		{
-			Writer.EndObject();
+			WithWriter([](auto& writer) { writer.EndObject(); });
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::StartArray(const char* memberName)
 		{
-			if (memberName)
+			WithWriter([=](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.StartArray();
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.StartArray();
+			});
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::EndArray()
 		{
-			Writer.EndArray();
+			WithWriter([](auto& writer) { writer.EndArray(); });
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::WriteBool(const char* memberName, bool boolValue)
 		{
-			if (memberName)
+			WithWriter([=](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.Bool(boolValue);
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.Bool(boolValue);
+			});
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::WriteInt(const char* memberName, int intValue)
 		{
-			if (memberName)
+			WithWriter([=](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.Int(intValue);
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.Int(intValue);
+			});
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::WriteFloat(const char* memberName, float floatValue)
 		{
-			if (memberName)
+			WithWriter([=](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.Double(floatValue);
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.Double(floatValue);
+			});
+			CheckOutput();
 		}
 
 
 		void RapidJsonWriter::WriteDouble(const char* memberName, double doubleValue)
 		{
-			if (memberName)
+			WithWriter([=](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.Double(doubleValue);
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.Double(doubleValue);
+			});
+			CheckOutput();
 		}
 
 
@@ -138,11 +297,58 @@ namespace gpvulc
 			{
 				return;
 			}
-			if (memberName)
+			WithWriter([&](auto& writer)
 			{
-				Writer.Key(memberName);
-			}
-			Writer.String(stringValue.c_str());
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.String(stringValue.c_str(), (rapidjson::SizeType)stringValue.size());
+			});
+			CheckOutput();
+		}
+
+
+		template <typename T>
+		void RapidJsonWriter::WriteNumberArray(const char* memberName, const T* values, size_t count)
+		{
+			WithWriter([&](auto& writer)
+			{
+				if (memberName)
+				{
+					writer.Key(memberName);
+				}
+				writer.StartArray();
+				for (size_t i = 0; i < count; i++)
+				{
+					WriteNumber(writer, values[i]);
+					if ((i + 1) % ARRAY_OUTPUT_CHECK_PERIOD == 0)
+					{
+						// keep the buffer bounded while streaming large arrays
+						CheckOutput();
+					}
+				}
+				writer.EndArray();
+			});
+			CheckOutput();
+		}
+
+
+		void RapidJsonWriter::WriteArray(const char* memberName, const int* values, size_t count)
+		{
+			WriteNumberArray(memberName, values, count);
+		}
+
+
+		void RapidJsonWriter::WriteArray(const char* memberName, const float* values, size_t count)
+		{
+			WriteNumberArray(memberName, values, count);
+		}
+
+
+		void RapidJsonWriter::WriteArray(const char* memberName, const double* values, size_t count)
+		{
+			WriteNumberArray(memberName, values, count);
 		}
 
 
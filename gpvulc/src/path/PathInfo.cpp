@@ -53,16 +53,16 @@ namespace gpvulc
 
 
 #ifdef _WIN32
-	char PathInfo::mDefaultDirSep = '\\';
+	std::atomic<char> PathInfo::mDefaultDirSep('\\');
 #else
-	char PathInfo::mDefaultDirSep = '/';
+	std::atomic<char> PathInfo::mDefaultDirSep('/');
 #endif
 
 
 	void PathInfo::SetDefaultBackSlash(bool back)
 	{
-		if (back) mDefaultDirSep = '\\';
-		else mDefaultDirSep = '/';
+		// no other data depends on the default separator, relaxed ordering is enough
+		mDefaultDirSep.store(back ? '\\' : '/', std::memory_order_relaxed);
 	}
 
 
@@ -479,16 +479,17 @@ namespace gpvulc
 		{
 			return false;
 		}
-#ifdef _WIN32
 		// check if the paths are on differnt disks
 		if (ref_path.GetDevice() != mDevice)
 		{
 			return false;
 		}
-#endif
 
 		DirtyPath();
 
+		std::string r_path = ref_path.GetPath();
+		FixDirSep(r_path);
+
 #ifdef _WIN32
 		if (_stricmp(ref_path.GetRootPath().c_str(), mPath.c_str()) == 0)
 #else
@@ -503,9 +504,6 @@ namespace gpvulc
 			return true;
 		}
 
-
-		std::string r_path = ref_path.GetPath();
-		FixDirSep(r_path);
 		std::string dotdotslash = std::string("..") + mDirSep; // "../"
 
 		size_t len1 = mPath.length();
@@ -703,7 +701,7 @@ namespace gpvulc
 		mFullPathReady = false;
 		mRootPathReady = false;
 
-		mDirSep[0] = mDefaultDirSep;
+		mDirSep[0] = mDefaultDirSep.load(std::memory_order_relaxed);
 		mDirSep[1] = 0;
 	}
 
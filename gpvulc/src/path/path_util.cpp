@@ -15,7 +15,9 @@
 
 #include <gpvulc/path/path_util.h>
 #include <stdio.h>
+#ifdef _WIN32
 #include <io.h>
+#endif
 #include <fcntl.h>
 #include <string.h>
 
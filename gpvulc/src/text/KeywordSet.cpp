@@ -0,0 +1,278 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Keyword set
+/// @file KeywordSet.cpp
+/// @author Giovanni Paolo Vigano'
+
+
+#include <gpvulc/text/KeywordSet.h>
+#include <gpvulc/text/text_util.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace gpvulc
+{
+
+	namespace
+	{
+		// maximum number of seeds tried for each bucket
+		const std::uint32_t MAX_BUCKET_SEED = 1 << 16;
+
+
+		size_t NextPowerOfTwo(size_t n)
+		{
+			size_t p = 1;
+			while (p < n)
+			{
+				p <<= 1;
+			}
+			return p;
+		}
+	}
+
+
+	//---------------------------------------------------------------------
+	// KeywordSet class implementation
+
+	// The table is built with the "hash and displace" method: keywords are grouped in buckets
+	// by their hash, then for each bucket (from the largest) a seed is chosen to move all its keywords
+	// to empty slots. A lookup computes the slot from the hash and the seed of the bucket.
+
+	void KeywordSet::Build(const std::vector<std::string>& keywords, bool caseInsensitive)
+	{
+		Clear();
+		mKeywords = keywords;
+		mCaseInsensitive = caseInsensitive;
+
+		std::vector<int> ids;
+		std::vector<std::uint64_t> hashes;
+		for (int id = 0; id < (int)mKeywords.size(); id++)
+		{
+			const std::string& keyword = mKeywords[id];
+			if (keyword.empty())
+			{
+				continue;
+			}
+			std::uint64_t hash = Hash(keyword.data(), keyword.length());
+			bool repeated = false;
+			for (size_t i = 0; i < ids.size() && !repeated; i++)
+			{
+				repeated = hashes[i] == hash && Equal(ids[i], keyword.data(), keyword.length());
+			}
+			if (repeated)
+			{
+				continue;
+			}
+			ids.push_back(id);
+			hashes.push_back(hash);
+			if (std::find(mLengths.begin(), mLengths.end(), keyword.length()) == mLengths.end())
+			{
+				mLengths.push_back(keyword.length());
+			}
+			mFirstChars[(unsigned char)keyword[0]] = true;
+			if (mCaseInsensitive)
+			{
+				mFirstChars[(unsigned char)AsciiToLower(keyword[0])] = true;
+				mFirstChars[(unsigned char)AsciiToUpper(keyword[0])] = true;
+			}
+		}
+		std::sort(mLengths.begin(), mLengths.end(), std::greater<size_t>());
+		if (ids.empty())
+		{
+			return;
+		}
+
+		// the table is enlarged until it can be filled (usually at the first attempt),
+		// if it fails anyway the keywords are searched one by one
+		const size_t maxSlotCount = NextPowerOfTwo(ids.size()) * 64;
+		for (size_t slotCount = NextPowerOfTwo(ids.size() + ids.size() / 4); slotCount <= maxSlotCount; slotCount *= 2)
+		{
+			if (FillSlots(ids, hashes, slotCount))
+			{
+				return;
+			}
+		}
+		mSlots.clear();
+		mBucketSeeds.clear();
+	}
+
+
+	void KeywordSet::Clear()
+	{
+		mKeywords.clear();
+		mSlots.clear();
+		mBucketSeeds.clear();
+		mLengths.clear();
+		std::fill(mFirstChars, mFirstChars + 256, false);
+		mCaseInsensitive = false;
+	}
+
+
+	int KeywordSet::Find(const char* str, size_t length) const
+	{
+		if (length == 0 || mLengths.empty())
+		{
+			return -1;
+		}
+		if (mSlots.empty())
+		{
+			for (int id = 0; id < (int)mKeywords.size(); id++)
+			{
+				if (Equal(id, str, length))
+				{
+					return id;
+				}
+			}
+			return -1;
+		}
+		std::uint64_t hash = Hash(str, length);
+		std::uint32_t seed = mBucketSeeds[(size_t)(hash >> 32) & (mBucketSeeds.size() - 1)];
+		int id = mSlots[GetSlot(hash, seed)];
+		return id >= 0 && Equal(id, str, length) ? id : -1;
+	}
+
+
+	int KeywordSet::FindPrefix(const char* text, size_t length) const
+	{
+		if (length == 0 || !IsFirstChar(text[0]))
+		{
+			return -1;
+		}
+		for (size_t keywordLength : mLengths)
+		{
+			if (keywordLength <= length)
+			{
+				int id = Find(text, keywordLength);
+				if (id >= 0)
+				{
+					return id;
+				}
+			}
+		}
+		return -1;
+	}
+
+
+	std::uint64_t KeywordSet::Hash(const char* str, size_t length) const
+	{
+		// FNV-1a
+		std::uint64_t hash = 0xcbf29ce484222325ULL;
+		if (mCaseInsensitive)
+		{
+			for (size_t i = 0; i < length; i++)
+			{
+				hash = (hash ^ (unsigned char)AsciiToLower(str[i])) * 0x100000001b3ULL;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < length; i++)
+			{
+				hash = (hash ^ (unsigned char)str[i]) * 0x100000001b3ULL;
+			}
+		}
+		return hash;
+	}
+
+
+	size_t KeywordSet::GetSlot(std::uint64_t hash, std::uint32_t seed) const
+	{
+		// the seed changes all the bits of the result (MurmurHash3 finalizer)
+		std::uint64_t x = hash + seed * 0x9e3779b97f4a7c15ULL;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return (size_t)x & (mSlots.size() - 1);
+	}
+
+
+	bool KeywordSet::Equal(int id, const char* str, size_t length) const
+	{
+		const std::string& keyword = mKeywords[id];
+		if (keyword.length() != length)
+		{
+			return false;
+		}
+		if (mCaseInsensitive)
+		{
+			return AsciiCaseEqual(keyword.data(), str, length);
+		}
+		return std::memcmp(keyword.data(), str, length) == 0;
+	}
+
+
+	bool KeywordSet::FillSlots(const std::vector<int>& ids, const std::vector<std::uint64_t>& hashes, size_t slotCount)
+	{
+		mSlots.assign(slotCount, -1);
+		mBucketSeeds.assign(NextPowerOfTwo(ids.size() / 2 + 1), 0);
+		const size_t bucketMask = mBucketSeeds.size() - 1;
+
+		// indices of keywords in each bucket, the largest buckets are placed first
+		std::vector<std::vector<size_t>> buckets(mBucketSeeds.size());
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			buckets[(size_t)(hashes[i] >> 32) & bucketMask].push_back(i);
+		}
+		std::vector<size_t> order(buckets.size());
+		for (size_t b = 0; b < order.size(); b++)
+		{
+			order[b] = b;
+		}
+		std::stable_sort(order.begin(), order.end(), [&buckets](size_t b1, size_t b2)
+		{
+			return buckets[b1].size() > buckets[b2].size();
+		});
+
+		std::vector<size_t> slots;
+		for (size_t b : order)
+		{
+			const std::vector<size_t>& bucket = buckets[b];
+			if (bucket.empty())
+			{
+				break;
+			}
+			std::uint32_t seed = 0;
+			for (; seed < MAX_BUCKET_SEED; seed++)
+			{
+				slots.clear();
+				for (size_t i : bucket)
+				{
+					size_t slot = GetSlot(hashes[i], seed);
+					if (mSlots[slot] >= 0 || std::find(slots.begin(), slots.end(), slot) != slots.end())
+					{
+						break;
+					}
+					slots.push_back(slot);
+				}
+				if (slots.size() == bucket.size())
+				{
+					break;
+				}
+			}
+			if (seed == MAX_BUCKET_SEED)
+			{
+				return false;
+			}
+			mBucketSeeds[b] = seed;
+			for (size_t k = 0; k < bucket.size(); k++)
+			{
+				mSlots[slots[k]] = ids[bucket[k]];
+			}
+		}
+		return true;
+	}
+
+}
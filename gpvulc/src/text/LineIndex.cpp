@@ -0,0 +1,143 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Line index
+/// @file LineIndex.cpp
+/// @author Giovanni Paolo Vigano'
+
+
+#include <gpvulc/text/LineIndex.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace gpvulc
+{
+
+	//---------------------------------------------------------------------
+	// LineIndex class implementation
+
+	void LineIndex::Build(const std::string& text)
+	{
+		mLineStarts.clear();
+		mLineStarts.push_back(0);
+		FindLineStarts(text, 0, (int)text.length(), mLineStarts);
+		mTextLength = (int)text.length();
+		mBuilt = true;
+	}
+
+
+	void LineIndex::Update(const std::string& text, int offset, int removedLength, int insertedLength)
+	{
+		if (!mBuilt || offset < 0 || removedLength < 0 || insertedLength < 0 || offset + removedLength > mTextLength)
+		{
+			Build(text);
+			return;
+		}
+
+		// lines starting inside the removed text (after a removed newline) are removed
+		auto first = std::upper_bound(mLineStarts.begin(), mLineStarts.end(), offset);
+		auto last = std::upper_bound(first, mLineStarts.end(), offset + removedLength);
+		const int shift = insertedLength - removedLength;
+		for (auto it = last; it != mLineStarts.end(); ++it)
+		{
+			*it += shift;
+		}
+		std::vector<int> insertedStarts;
+		FindLineStarts(text, offset, offset + insertedLength, insertedStarts);
+		// overwrite the removed starts, then remove or insert the difference
+		const size_t removedCount = last - first;
+		if (removedCount >= insertedStarts.size())
+		{
+			auto next = std::copy(insertedStarts.begin(), insertedStarts.end(), first);
+			mLineStarts.erase(next, last);
+		}
+		else
+		{
+			auto next = std::copy(insertedStarts.begin(), insertedStarts.begin() + removedCount, first);
+			mLineStarts.insert(next, insertedStarts.begin() + removedCount, insertedStarts.end());
+		}
+		mTextLength += shift;
+	}
+
+
+	void LineIndex::Clear()
+	{
+		mLineStarts.clear();
+		mTextLength = 0;
+		mBuilt = false;
+	}
+
+
+	int LineIndex::GetLineCount() const
+	{
+		if (mTextLength == 0)
+		{
+			return 0;
+		}
+		// a final newline does not start a new line
+		return mLineStarts.back() == mTextLength ? (int)mLineStarts.size() - 1 : (int)mLineStarts.size();
+	}
+
+
+	int LineIndex::GetLine(int offset) const
+	{
+		if (!mBuilt || offset < 0 || offset > mTextLength)
+		{
+			return -1;
+		}
+		int line = (int)(std::upper_bound(mLineStarts.begin(), mLineStarts.end(), offset) - mLineStarts.begin()) - 1;
+		int lineCount = GetLineCount();
+		return line < lineCount || lineCount == 0 ? line : lineCount - 1;
+	}
+
+
+	int LineIndex::GetLineStart(int line) const
+	{
+		if (line < 0 || line >= std::max(GetLineCount(), mBuilt ? 1 : 0))
+		{
+			return -1;
+		}
+		return mLineStarts[line];
+	}
+
+
+	bool LineIndex::GetLineAndColumn(int offset, int& line, int& column) const
+	{
+		int foundLine = GetLine(offset);
+		if (foundLine < 0)
+		{
+			return false;
+		}
+		line = foundLine;
+		column = offset - mLineStarts[foundLine];
+		return true;
+	}
+
+
+	void LineIndex::FindLineStarts(const std::string& text, int begin, int end, std::vector<int>& lineStarts)
+	{
+		const char* data = text.data();
+		const char* pos = data + begin;
+		const char* textEnd = data + end;
+		while (pos < textEnd)
+		{
+			const char* newline = (const char*)std::memchr(pos, '\n', textEnd - pos);
+			if (!newline)
+			{
+				break;
+			}
+			pos = newline + 1;
+			lineStarts.push_back((int)(pos - data));
+		}
+	}
+
+}
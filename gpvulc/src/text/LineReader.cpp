@@ -0,0 +1,210 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+
+/// @brief Buffered line reader
+/// @file LineReader.cpp
+/// @author Giovanni Paolo Vigano'
+
+
+#include <gpvulc/text/LineReader.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace gpvulc
+{
+
+	//---------------------------------------------------------------------
+	// LineReader class implementation
+
+	LineReader::LineReader(std::istream& inStream, size_t blockSize)
+		: mInStream(inStream)
+		, mBlockSize(blockSize)
+	{
+		if (mBlockSize == 0)
+		{
+			mBlockSize = DEFAULT_BLOCK_SIZE;
+		}
+	}
+
+
+	bool LineReader::ReadLine(const char*& line, size_t& length)
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		size_t joinEnd = 0;
+		mKeep = mPos;
+		if (!NextLine(begin, end, joinEnd))
+		{
+			return false;
+		}
+		line = mBuffer.get() + begin;
+		length = end - begin;
+		return true;
+	}
+
+
+	bool LineReader::ReadLine(std::string& line)
+	{
+		const char* text = nullptr;
+		size_t length = 0;
+		if (!ReadLine(text, length))
+		{
+			line.clear();
+			return false;
+		}
+		line.assign(text, length);
+		return true;
+	}
+
+
+	bool LineReader::ReadSplitLine(const char*& line, size_t& length, bool skipSpaces)
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		size_t joinEnd = 0;
+		mKeep = mPos;
+		if (!NextLine(begin, end, joinEnd))
+		{
+			return false;
+		}
+		if (skipSpaces)
+		{
+			SkipSpaces(begin, end);
+		}
+		// the joined line starts where the first line starts, mKeep preserves it when the buffer is refilled
+		mKeep = begin;
+		joinEnd = end;
+		while (joinEnd > mKeep && mBuffer[joinEnd - 1] == '\\')
+		{
+			joinEnd--;
+			if (!NextLine(begin, end, joinEnd))
+			{
+				break;
+			}
+			if (skipSpaces)
+			{
+				SkipSpaces(begin, end);
+			}
+			// continuation lines follow the joined line in the buffer: move them back in place
+			std::memmove(mBuffer.get() + joinEnd, mBuffer.get() + begin, end - begin);
+			joinEnd += end - begin;
+		}
+		line = mBuffer.get() + mKeep;
+		length = joinEnd - mKeep;
+		return true;
+	}
+
+
+	bool LineReader::ReadSplitLine(std::string& line, bool skipSpaces)
+	{
+		const char* text = nullptr;
+		size_t length = 0;
+		if (!ReadSplitLine(text, length, skipSpaces))
+		{
+			line.clear();
+			return false;
+		}
+		line.assign(text, length);
+		return true;
+	}
+
+
+	bool LineReader::NextLine(size_t& begin, size_t& end, size_t& joinEnd)
+	{
+		size_t scanPos = mPos;
+		for (;;)
+		{
+			const char* newline = nullptr;
+			if (scanPos < mEnd)
+			{
+				newline = (const char*)std::memchr(mBuffer.get() + scanPos, '\n', mEnd - scanPos);
+			}
+			if (newline)
+			{
+				begin = mPos;
+				end = newline - mBuffer.get();
+				mPos = end + 1;
+				mNewlineFound = true;
+				mLineNumber++;
+				return true;
+			}
+			if (mStreamEnded)
+			{
+				if (mPos == mEnd)
+				{
+					return false;
+				}
+				// last line without newline
+				begin = mPos;
+				end = mEnd;
+				mPos = mEnd;
+				mNewlineFound = false;
+				mLineNumber++;
+				return true;
+			}
+			// the data already scanned is not scanned again
+			scanPos = mEnd;
+			size_t offset = FillBuffer();
+			scanPos -= offset;
+			joinEnd -= offset;
+		}
+	}
+
+
+	size_t LineReader::FillBuffer()
+	{
+		size_t offset = mKeep;
+		size_t kept = mEnd - mKeep;
+		if (offset > 0 && kept > 0)
+		{
+			std::memmove(mBuffer.get(), mBuffer.get() + offset, kept);
+		}
+		mPos -= offset;
+		mEnd = kept;
+		mKeep = 0;
+
+		// the buffer grows only if a line does not fit in it
+		if (mBufferSize < mEnd + mBlockSize)
+		{
+			size_t newSize = std::max(mEnd + mBlockSize, mBufferSize * 2);
+			std::unique_ptr<char[]> newBuffer(new char[newSize]);
+			if (mEnd > 0)
+			{
+				std::memcpy(newBuffer.get(), mBuffer.get(), mEnd);
+			}
+			mBuffer = std::move(newBuffer);
+			mBufferSize = newSize;
+		}
+		mInStream.read(mBuffer.get() + mEnd, (std::streamsize)(mBufferSize - mEnd));
+		size_t count = (size_t)mInStream.gcount();
+		mEnd += count;
+		if (!mInStream.good() || count == 0)
+		{
+			mStreamEnded = true;
+		}
+		return offset;
+	}
+
+
+	void LineReader::SkipSpaces(size_t& begin, size_t& end) const
+	{
+		while (begin < end && (mBuffer[begin] == ' ' || mBuffer[begin] == '\t'))
+		{
+			begin++;
+		}
+		while (end > begin && (mBuffer[end - 1] == ' ' || mBuffer[end - 1] == '\t'))
+		{
+			end--;
+		}
+	}
+
+}
@@ -15,6 +15,7 @@
 
 
 #include <gpvulc/text/TextBuffer.h>
+#include <gpvulc/text/LineReader.h>
 #include <gpvulc/text/text_util.h>
 #include <gpvulc/text/string_conv.h>
 
@@ -23,36 +24,14 @@
 #include <cstring>
 
 
-#if defined(_MSC_VER)
-#define StrCaseCmp _stricmp
-#define StrNCaseCmp _strnicmp
-#elif defined( __GNUC__ )
-#define StrCaseCmp strcasecmp
-#define StrNCaseCmp strncasecmp
-#else
-inline int StrCaseCmp(const char *s1, const char *s2)
+namespace
 {
-    char c1, c2;
-    do  {
-        c1 = tolower(*s1++);
-        c2 = tolower(*s2++);
-    }
-    while ( c1 && (c1 == c2) );
-    return c1 - c2;
-}
-inline int StrNCaseCmp(const char *s1, const char *s2, size_t n)
-{
-	size_t count = 0;
-    char c1, c2;
-    do  {
-        c1 = tolower(*s1++);
-        c2 = tolower(*s2++);
-		count++;
-    }
-    while ( count<n && c1 && (c1 == c2) );
-    return c1 - c2;
+	// Characters of the given set in both lower and upper case, to search them ignoring case
+	std::string GetBothCasesStr(const std::string& str)
+	{
+		return str + gpvulc::GetLowerStr(str) + gpvulc::GetUpperStr(str);
+	}
 }
-#endif
 
 
 	//---------------------------------------------------------------------
@@ -327,9 +306,22 @@ namespace gpvulc
 			return -1;
 		}
 		// !mStdString.empty() && !str.empty()
-		retval = caseInsensitive ? StrCaseCmp(mStdString.c_str(), str.c_str()) : mStdString.compare(str);
+		if (caseInsensitive)
+		{
+			size_t len = std::min(mStdString.length(), str.length());
+			retval = AsciiCaseCompare(mStdString.data(), str.data(), len);
+			if (retval == 0)
+			{
+				retval = (mStdString.length() > len) - (str.length() > len);
+			}
+		}
+		else
+		{
+			retval = mStdString.compare(str);
+		}
 
-		return retval;
+		// the magnitude of std::string::compare() result depends on the library, only the sign is kept
+		return (retval > 0) - (retval < 0);
 	}
 
 
@@ -398,7 +390,7 @@ namespace gpvulc
 			return false;
 		}
 		tmp = &mStdString[ns - n];
-		return caseInsensitive ? !StrNCaseCmp(tmp, str.c_str(), n) : !strncmp(tmp, str.c_str(), n);
+		return caseInsensitive ? AsciiCaseEqual(tmp, str.data(), n) : !strncmp(tmp, str.c_str(), n);
 	}
 
 
@@ -418,12 +410,15 @@ namespace gpvulc
 		{
 			return false;
 		}
-		std::string subs = GetSubString(beg, (int)end_pos);
+		if (end_pos < beg_pos || end_pos - beg_pos + 1 != str.length())
+		{
+			return false;
+		}
 		if (caseInsensitive)
 		{
-			return GetLowerStr(subs) == GetLowerStr(str);
+			return AsciiCaseEqual(mStdString.data() + beg_pos, str.data(), str.length());
 		}
-		return subs == str;
+		return mStdString.compare(beg_pos, str.length(), str) == 0;
 	}
 
 
@@ -435,7 +430,7 @@ namespace gpvulc
 		}
 		if (caseInsensitive)
 		{
-			return GetLowerStr(mStdString).find(GetLowerStr(str)) != std::string::npos;
+			return AsciiCaseFind(mStdString, str) != std::string::npos;
 		}
 		return mStdString.find(str) != std::string::npos;
 	}
@@ -448,7 +443,7 @@ namespace gpvulc
 			return false;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().find_first_of(GetLowerStr(str));
+		if (caseInsensitive) pos = mStdString.find_first_of(GetBothCasesStr(str));
 		else pos = mStdString.find_first_of(str);
 		return pos != std::string::npos;
 	}
@@ -459,13 +454,12 @@ namespace gpvulc
 		std::vector<std::string> subStrings;
 		size_t offset = 0;
 		size_t idx = 0;
-		std::string entry;
 		while ((idx = mStdString.find_first_of(delimiter, offset)) != std::string::npos)
 		{
-			entry = mStdString.substr(offset, idx - offset);
-			if (!entry.empty() || !removeEmpty)
+			// substrings are built in place, without temporary copies
+			if (idx > offset || !removeEmpty)
 			{
-				subStrings.push_back(entry);
+				subStrings.emplace_back(mStdString, offset, idx - offset);
 			}
 			offset = idx + 1;
 		}
@@ -479,13 +473,11 @@ namespace gpvulc
 		std::vector<std::string> subStrings;
 		size_t offset = 0;
 		size_t idx = 0;
-		std::string entry;
 		while ((idx = mStdString.find_first_of(delimiters, offset)) != std::string::npos)
 		{
-			entry = mStdString.substr(offset, idx - offset);
-			if (!entry.empty() || !removeEmpty)
+			if (idx > offset || !removeEmpty)
 			{
-				subStrings.push_back(entry);
+				subStrings.emplace_back(mStdString, offset, idx - offset);
 			}
 			offset = idx + 1;
 		}
@@ -499,13 +491,11 @@ namespace gpvulc
 		std::vector<std::string> subStrings;
 		size_t offset = 0;
 		size_t idx = 0;
-		std::string entry;
 		while ((idx = mStdString.find(delimiterString, offset)) != std::string::npos)
 		{
-			entry = mStdString.substr(offset, idx - offset);
-			if (!entry.empty() || !removeEmpty)
+			if (idx > offset || !removeEmpty)
 			{
-				subStrings.push_back(entry);
+				subStrings.emplace_back(mStdString, offset, idx - offset);
 			}
 			offset = idx + delimiterString.size();
 		}
@@ -525,7 +515,7 @@ namespace gpvulc
 			return -1;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().find_first_of(GetLowerStr(str), search_pos);
+		if (caseInsensitive) pos = mStdString.find_first_of(GetBothCasesStr(str), search_pos);
 		else pos = mStdString.find_first_of(str, search_pos);
 		return PosToInt(pos);
 	}
@@ -539,7 +529,7 @@ namespace gpvulc
 			return -1;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().find_last_of(GetLowerStr(str), search_pos);
+		if (caseInsensitive) pos = mStdString.find_last_of(GetBothCasesStr(str), search_pos);
 		else pos = mStdString.find_last_of(str, search_pos);
 		return PosToInt(pos);
 	}
@@ -554,7 +544,11 @@ namespace gpvulc
 			return -1;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().find(tolower(chr), search_pos);
+		if (caseInsensitive && IsAsciiAlpha(chr))
+		{
+			const char both[] = { AsciiToLower(chr), AsciiToUpper(chr) };
+			pos = mStdString.find_first_of(both, search_pos, 2);
+		}
 		else pos = mStdString.find(chr, search_pos);
 		return PosToInt(pos);
 	}
@@ -568,7 +562,11 @@ namespace gpvulc
 			return -1;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().rfind(tolower(chr), search_pos);
+		if (caseInsensitive && IsAsciiAlpha(chr))
+		{
+			const char both[] = { AsciiToLower(chr), AsciiToUpper(chr) };
+			pos = mStdString.find_last_of(both, search_pos, 2);
+		}
 		else pos = mStdString.rfind(chr, search_pos);
 		return PosToInt(pos);
 	}
@@ -584,9 +582,7 @@ namespace gpvulc
 		size_t pos;
 		if (caseInsensitive)
 		{
-			std::string lwr = GetLowerCase();
-			std::string lwrstr = GetLowerStr(str);
-			pos = lwr.find_first_not_of(lwrstr, search_pos);
+			pos = mStdString.find_first_not_of(GetBothCasesStr(str), search_pos);
 		}
 		else
 		{
@@ -607,9 +603,7 @@ namespace gpvulc
 		size_t pos;
 		if (caseInsensitive)
 		{
-			std::string lwr = GetLowerCase();
-			std::string lwrstr = GetLowerStr(str);
-			pos = lwr.find_last_not_of(lwrstr, search_pos);
+			pos = mStdString.find_last_not_of(GetBothCasesStr(str), search_pos);
 		}
 		else
 		{
@@ -635,7 +629,7 @@ namespace gpvulc
 		size_t pos = std::string::npos;
 		if (caseInsensitive)
 		{
-			pos = GetLowerCase().find(GetLowerStr(str), search_pos);
+			pos = AsciiCaseFind(mStdString, str, search_pos);
 		}
 		else
 		{
@@ -677,7 +671,7 @@ namespace gpvulc
 		size_t pos = std::string::npos;
 		if (caseInsensitive)
 		{
-			pos = GetLowerCase().rfind(GetLowerStr(str), search_pos);
+			pos = AsciiCaseRFind(mStdString, str, search_pos);
 		}
 		else
 		{
@@ -764,10 +758,19 @@ namespace gpvulc
 
 
 	std::string TextBuffer::GetSubString(int beg, int end) const
+	{
+		std::string result;
+		GetSubString(beg, end, result);
+		return result;
+	}
+
+
+	void TextBuffer::GetSubString(int beg, int end, std::string& result) const
 	{
 		if (mStdString.empty())
 		{
-			return "";
+			result.clear();
+			return;
 		}
 		if (beg < 0) beg = 0;
 		if (end < 0 || end >= (int)mStdString.size())
@@ -776,12 +779,13 @@ namespace gpvulc
 		}
 		if (end < beg)
 		{
-			return "";
+			result.clear();
+			return;
 		}
 		size_t offset = beg;
 		size_t count = end - beg + 1;
 
-		return mStdString.substr(offset, count);
+		result.assign(mStdString, offset, count);
 	}
 
 
@@ -880,7 +884,7 @@ namespace gpvulc
 			return false;
 		}
 		size_t pos = std::string::npos;
-		if (caseInsensitive) pos = GetLowerCase().find_first_not_of(GetLowerStr(str));
+		if (caseInsensitive) pos = mStdString.find_first_not_of(GetBothCasesStr(str));
 		else pos = mStdString.find_first_not_of(str);
 		return pos == std::string::npos;
 	}
@@ -912,10 +916,10 @@ namespace gpvulc
 
 		if (caseInsensitive)
 		{
-			char lwr = tolower(oldchar);
+			char lwr = AsciiToLower(oldchar);
 			for (size_t i = beg; i <= end; ++i)
 			{
-				if (tolower(mStdString[i]) == lwr)
+				if (AsciiToLower(mStdString[i]) == lwr)
 				{
 					mStdString[i] = newchar;
 					++count;
@@ -951,62 +955,25 @@ namespace gpvulc
 
 	std::string TextBuffer::GetSentenceCase() const
 	{
-		if (mStdString.empty())
-		{
-			return "";
-		}
-		std::string cpt = mStdString;
-		size_t len = cpt.length();
-		size_t i = 0;
-		for (; i < len; ++i)
-		{
-			if (isalpha(cpt[i]))
-			{
-				cpt[i] = toupper(cpt[i]);
-				++i;
-				break;
-			}
-		}
-
-		for (; i < len; ++i) cpt[i] = tolower(cpt[i]);
-
-		return cpt;
+		return GetSentenceCaseStr(mStdString);
 	}
 
 	std::string TextBuffer::GetProperCase() const
 	{
-		if (mStdString.empty())
-		{
-			return "";
-		}
-		bool capital = true;
-		std::string cpt = mStdString;
-		size_t len = cpt.length();
-		for (size_t i = 0; i < len; ++i)
-		{
-			if (isalpha(cpt[i]))
-			{
-				if (capital) cpt[i] = toupper(cpt[i]);
-				else cpt[i] = tolower(cpt[i]);
-				capital = false;
-			}
-			else capital = true;
-		}
-
-		return cpt;
+		return GetProperCaseStr(mStdString);
 	}
 
 
 	TextBuffer& TextBuffer::SentenceCase()
 	{
-		mStdString = GetSentenceCase();
+		StrSentenceCase(mStdString);
 		return *this;
 	}
 
 
 	TextBuffer& TextBuffer::ProperCase()
 	{
-		mStdString = GetProperCase();
+		StrProperCase(mStdString);
 		return *this;
 	}
 
@@ -1091,10 +1058,14 @@ namespace gpvulc
 			RemoveLastChar();
 			if (skipSpaces)
 			{
-				TextBuffer lineBuf;
-				lineBuf.ReadLine(inStream);
-				lineBuf.Crop();
-				mStdString.append(lineBuf);
+				// the continuation line is cropped before appending it
+				std::string line;
+				std::getline(inStream, line);
+				size_t begIdx = line.find_first_not_of(" \t");
+				if (begIdx != std::string::npos)
+				{
+					mStdString.append(line, begIdx, line.find_last_not_of(" \t") + 1 - begIdx);
+				}
 			}
 			else
 			{
@@ -1110,6 +1081,48 @@ namespace gpvulc
 	}
 
 
+	bool TextBuffer::ReadLine(LineReader& reader, bool appendNewline, bool appendEofNewline)
+	{
+		mStdString.clear();
+		return AppendLine(reader, appendNewline, appendEofNewline);
+	}
+
+
+	bool TextBuffer::AppendLine(LineReader& reader, bool appendNewline, bool appendEofNewline)
+	{
+		const char* line = nullptr;
+		size_t length = 0;
+		if (!reader.ReadLine(line, length))
+		{
+			return false;
+		}
+		mStdString.append(line, length);
+		if (appendNewline && (reader.NewlineFound() || appendEofNewline))
+		{
+			mStdString.append(1, '\n');
+		}
+		return true;
+	}
+
+
+	bool TextBuffer::ReadSplitLine(LineReader& reader, bool skipSpaces, bool appendNewline, bool appendEofNewline)
+	{
+		const char* line = nullptr;
+		size_t length = 0;
+		if (!reader.ReadSplitLine(line, length, skipSpaces))
+		{
+			mStdString.clear();
+			return false;
+		}
+		mStdString.assign(line, length);
+		if (appendNewline && (reader.NewlineFound() || appendEofNewline))
+		{
+			mStdString.append(1, '\n');
+		}
+		return true;
+	}
+
+
 	bool TextBuffer::Write(std::ostream& ostrm) const
 	{
 		if (!ostrm.good())
@@ -1245,9 +1258,15 @@ namespace gpvulc
 		{
 			return false;
 		}
-		int len = (int)str.length();
-		std::string subs = GetSubString(0, len - 1);
-		return StrEqual(subs, str, caseInsensitive);
+		if (str.length() > mStdString.length())
+		{
+			return false;
+		}
+		if (caseInsensitive)
+		{
+			return AsciiCaseEqual(mStdString.data(), str.data(), str.length());
+		}
+		return mStdString.compare(0, str.length(), str) == 0;
 	}
 
 
@@ -1271,14 +1290,14 @@ namespace gpvulc
 
 	TextBuffer& TextBuffer::ToLower(int i)
 	{
-		if (i >= 0 && i < (int)mStdString.length()) mStdString[i] = tolower(mStdString[i]);
+		if (i >= 0 && i < (int)mStdString.length()) mStdString[i] = AsciiToLower(mStdString[i]);
 		return *this;
 	}
 
 
 	TextBuffer& TextBuffer::ToUpper(int i)
 	{
-		if (i >= 0 && i < (int)mStdString.length()) mStdString[i] = toupper(mStdString[i]);
+		if (i >= 0 && i < (int)mStdString.length()) mStdString[i] = AsciiToUpper(mStdString[i]);
 		return *this;
 	}
 
@@ -1414,11 +1433,10 @@ namespace gpvulc
 		int count = 0;
 		if (caseInsensitive)
 		{
-			std::string lwr = GetLowerStr(mStdString);
-			c = tolower(c);
+			c = AsciiToLower(c);
 			for (int i = start; i <= end && i < len; i++)
 			{
-				if (lwr[i] == c) ++count;
+				if (AsciiToLower(mStdString[i]) == c) ++count;
 			}
 		}
 		else
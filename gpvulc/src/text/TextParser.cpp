@@ -15,7 +15,9 @@
 
 
 #include <gpvulc/text/TextParser.h>
+#include <gpvulc/text/text_util.h>
 
+#include <climits>
 #include <utility>
 #include <algorithm>
 #include <sstream>
@@ -46,7 +48,7 @@ namespace gpvulc
 			return false;
 		}
 
-		mResult = mInputText.GetSubString(mCurrPos - steps, mCurrPos - 1);
+		mInputText.GetSubString(mCurrPos - steps, mCurrPos - 1, mResult);
 		SaveCurrPos();
 		mCurrPos -= steps;
 
@@ -69,10 +71,9 @@ namespace gpvulc
 
 	bool TextParser::CompareList(const std::vector<std::string>& referenceStrings) const
 	{
-		TextBuffer temp = mInputText.GetSubString(mCurrPos);
 		for (const std::string& s : referenceStrings)
 		{
-			if (temp.StartsWith(s, mCaseInsensitive))
+			if (mInputText.MiddleStr(s, mCurrPos, mCaseInsensitive))
 			{
 				return true;
 			}
@@ -81,6 +82,30 @@ namespace gpvulc
 	}
 
 
+	bool TextParser::CompareList(const KeywordSet& keywords) const
+	{
+		int keywordId = -1;
+		return CompareList(keywords, keywordId);
+	}
+
+
+	bool TextParser::CompareList(const KeywordSet& keywords, int& keywordId) const
+	{
+		if (mCurrPos >= mInputText.Length())
+		{
+			return false;
+		}
+		const std::string& text = mInputText.StdString();
+		int id = keywords.FindPrefix(text.data() + mCurrPos, text.length() - mCurrPos);
+		if (id < 0)
+		{
+			return false;
+		}
+		keywordId = id;
+		return true;
+	}
+
+
 	bool TextParser::CompareStrChr(const std::string& s, const std::string& choice) const
 	{
 		if (s.empty() || choice.empty())
@@ -112,7 +137,7 @@ namespace gpvulc
 		}
 		if (mCurrPos <= mInputText.GetSize() - steps)
 		{
-			mResult = mInputText.GetSubString(mCurrPos, mCurrPos + steps - 1);
+			mInputText.GetSubString(mCurrPos, mCurrPos + steps - 1, mResult);
 			SaveCurrPos();
 			mCurrPos += steps;
 			return true;
@@ -164,7 +189,7 @@ namespace gpvulc
 					{
 						SaveCurrPos();
 						mCurrPos = i - 1;
-						mResult = mInputText.GetSubString(blockbegin, blockend);
+						mInputText.GetSubString(blockbegin, blockend, mResult);
 
 						return true;
 					}
@@ -294,7 +319,7 @@ namespace gpvulc
 					// block at the given level found, return the block
 					SaveCurrPos();
 					mCurrPos = i;
-					mResult = mInputText.GetSubString(blockbegin, blockend);
+					mInputText.GetSubString(blockbegin, blockend, mResult);
 
 					return true;
 				}
@@ -359,7 +384,7 @@ namespace gpvulc
 		{
 			return false;
 		}
-		mResult = mInputText.GetSubString(mCurrPos, idx - 1);
+		mInputText.GetSubString(mCurrPos, idx - 1, mResult);
 
 		SaveCurrPos();
 		mCurrPos = idx + (int)separator.length();
@@ -374,6 +399,28 @@ namespace gpvulc
 	}
 
 
+	bool TextParser::GetLineAndColumn(int offset, int& line, int& column) const
+	{
+		if (!GetLineIndex().GetLineAndColumn(offset, line, column))
+		{
+			return false;
+		}
+		line++;
+		column++;
+		return true;
+	}
+
+
+	const LineIndex& TextParser::GetLineIndex() const
+	{
+		if (!mLineIndex.IsBuilt())
+		{
+			mLineIndex.Build(mInputText.StdString());
+		}
+		return mLineIndex;
+	}
+
+
 	bool TextParser::GetLine()
 	{
 		int idx = mInputText.FindChar('\n', mCurrPos);
@@ -382,7 +429,7 @@ namespace gpvulc
 			return GetRemainder();
 		}
 
-		mResult = mInputText.GetSubString(mCurrPos, idx - 1);
+		mInputText.GetSubString(mCurrPos, idx - 1, mResult);
 		SaveCurrPos();
 		mCurrPos = idx + 1;
 
@@ -396,7 +443,7 @@ namespace gpvulc
 		{
 			return false;
 		}
-		mResult = mInputText.GetSubString(mCurrPos);
+		mInputText.GetSubString(mCurrPos, -1, mResult);
 		SaveCurrPos();
 		mCurrPos = mInputText.Length();
 
@@ -411,8 +458,7 @@ namespace gpvulc
 			return false;
 		}
 
-		std::string separators = sep;
-		if (sep.empty()) separators = mSeparators;
+		const std::string& separators = sep.empty() ? mSeparators : sep;
 
 		// skip heading separators
 		int startPos = mInputText.FindFirstNotOf(separators, mCurrPos, mCaseInsensitive);
@@ -430,12 +476,12 @@ namespace gpvulc
 
 		if (endPos < 0)
 		{
-			mResult = mInputText.GetSubString(startPos);
+			mInputText.GetSubString(startPos, -1, mResult);
 			endPos = mInputText.Length();
 		}
 		else
 		{
-			mResult = mInputText.GetSubString(startPos, endPos - 1);
+			mInputText.GetSubString(startPos, endPos - 1, mResult);
 			// skip trailing separators
 			int sepend = mInputText.FindFirstNotOf(separators, endPos, mCaseInsensitive);
 			if (sepend >= 0)
@@ -464,7 +510,7 @@ namespace gpvulc
 			return false;
 		}
 
-		mResult = mInputText.GetSubString(mCurrPos, idx + (int)str.length() - 1);
+		mInputText.GetSubString(mCurrPos, idx + (int)str.length() - 1, mResult);
 		SaveCurrPos();
 		mCurrPos = idx + (int)str.length();
 
@@ -511,7 +557,7 @@ namespace gpvulc
 
 		SaveCurrPos();
 		mCurrPos += idx;
-		mResult = mBuffer.GetSubString(0, idx - 1);
+		mBuffer.GetSubString(0, idx - 1, mResult);
 
 		return true;
 	}
@@ -539,7 +585,7 @@ namespace gpvulc
 		int prevPos = mCurrPos - 1;
 		SaveCurrPos();
 		mCurrPos = idx + 1;
-		mResult = mInputText.GetSubString(idx + 1, prevPos);
+		mInputText.GetSubString(idx + 1, prevPos, mResult);
 
 		return true;
 	}
@@ -560,7 +606,7 @@ namespace gpvulc
 			return false;
 		}
 		if (idx == 0) mResult.clear();
-		else mResult = mInputText.GetSubString(mCurrPos, idx - 1);
+		else mInputText.GetSubString(mCurrPos, idx - 1, mResult);
 		SaveCurrPos();
 		mCurrPos = idx;
 
@@ -574,7 +620,6 @@ namespace gpvulc
 
 		int minpos = INT_MAX;
 
-		mBuffer = mInputText.GetSubString(mCurrPos);
 		for (size_t i = 0; i < search_str.size(); ++i)
 		{
 			idx = mInputText.FindSubString(search_str[i], mCaseInsensitive, false, mCurrPos);
@@ -592,6 +637,22 @@ namespace gpvulc
 	}
 
 
+	bool TextParser::ReachFirstAmong(const KeywordSet& keywords)
+	{
+		const std::string& text = mInputText.StdString();
+		const size_t length = text.length();
+		for (size_t pos = (size_t)std::max(mCurrPos, 0); pos < length; ++pos)
+		{
+			if (keywords.IsFirstChar(text[pos]) && keywords.FindPrefix(text.data() + pos, length - pos) >= 0)
+			{
+				Forward((int)pos - mCurrPos);
+				return true;
+			}
+		}
+		return false;
+	}
+
+
 	bool TextParser::ReadText(std::istream& strm)
 	{
 		if (!strm.good())
@@ -600,6 +661,7 @@ namespace gpvulc
 		}
 
 		Init();
+		mLineIndex.Clear();
 		strm >> mInputText;
 		return true;
 	}
@@ -608,11 +670,20 @@ namespace gpvulc
 	bool TextParser::ReadLine(std::istream& strm, bool appendNewline, bool appendEofNewline)
 	{
 		ResetParsing();
+		mLineIndex.Clear();
 		mInputText.Clear();
 		return mInputText.ReadLine(strm, appendNewline, appendEofNewline);
 	}
 
 
+	bool TextParser::ReadLine(LineReader& reader, bool appendNewline, bool appendEofNewline)
+	{
+		ResetParsing();
+		mLineIndex.Clear();
+		return mInputText.ReadLine(reader, appendNewline, appendEofNewline);
+	}
+
+
 	bool TextParser::LoadFile(const std::string& filename)
 	{
 		if (filename.empty())
@@ -621,6 +692,7 @@ namespace gpvulc
 		}
 
 		Init();
+		mLineIndex.Clear();
 		mInputText.Clear();
 		return mInputText.Load(filename);
 	}
@@ -640,6 +712,7 @@ namespace gpvulc
 	void TextParser::Clear()
 	{
 		ResetParsing();
+		mLineIndex.Clear();
 		mInputText.Clear();
 	}
 
@@ -685,7 +758,7 @@ namespace gpvulc
 		}
 		int posStart = std::min(mCurrPos, mBookmarks[name]);
 		int posEnd = std::max(mCurrPos, mBookmarks[name]);
-		mResult = mInputText.GetSubString(posStart, posEnd - 1);
+		mInputText.GetSubString(posStart, posEnd - 1, mResult);
 		mCurrPos = mBookmarks[name];
 		return true;
 	}
@@ -721,6 +794,7 @@ namespace gpvulc
 	void TextParser::SetText(const std::string& text)
 	{
 		ResetParsing();
+		mLineIndex.Clear();
 		mInputText = text;
 	}
 
@@ -742,7 +816,7 @@ namespace gpvulc
 			return false;
 		}
 
-		mResult = mInputText.GetSubString(mCurrPos, pos - 1);
+		mInputText.GetSubString(mCurrPos, pos - 1, mResult);
 
 		SaveCurrPos();
 		mCurrPos = pos;
@@ -753,12 +827,7 @@ namespace gpvulc
 
 	bool TextParser::ResultIs(const std::string& tag) const
 	{
-		if (mCaseInsensitive)
-		{
-			TextBuffer temp = tag;
-			return temp.EqualTo(mResult, true);
-		}
-		return mResult == tag;
+		return StrEqual(mResult, tag, mCaseInsensitive);
 	}
 
 
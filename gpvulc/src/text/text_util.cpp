@@ -15,11 +15,244 @@
 
 #include <gpvulc/text/text_util.h>
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <memory>
 
 namespace gpvulc
 {
 
+	//---------------------------------------------------------------------
+	// ASCII case folding
+	// Characters are processed 8 at a time in 64 bit words (SWAR, "SIMD within a register"),
+	// portable code that the compiler can further vectorize.
+
+	namespace
+	{
+		typedef std::uint64_t Word;
+
+		const Word ONES = 0x0101010101010101ULL;
+		const Word HIGH_BITS = 0x8080808080808080ULL;
+
+
+		inline Word LoadWord(const char* text)
+		{
+			Word word;
+			std::memcpy(&word, text, sizeof(Word));
+			return word;
+		}
+
+
+		inline void StoreWord(char* text, Word word)
+		{
+			std::memcpy(text, &word, sizeof(Word));
+		}
+
+
+		// 0x20 in each byte of the word in the range [first,last] (bytes >= 0x80 are excluded)
+		inline Word CaseBits(Word word, unsigned char first, unsigned char last)
+		{
+			Word heptets = word & (ONES * 0x7F);
+			Word aboveLast = heptets + ONES * (0x7F - last);
+			Word fromFirst = heptets + ONES * (0x80 - first);
+			return ((fromFirst ^ aboveLast) & ~word & HIGH_BITS) >> 2;
+		}
+
+
+		inline Word LowerWord(Word word)
+		{
+			return word | CaseBits(word, 'A', 'Z');
+		}
+
+
+		inline Word UpperWord(Word word)
+		{
+			return word ^ CaseBits(word, 'a', 'z');
+		}
+
+
+		// high bit set in each zero byte of the word (bytes above the first zero byte may be wrong)
+		inline Word ZeroBytes(Word word)
+		{
+			return (word - ONES) & ~word & HIGH_BITS;
+		}
+	}
+
+
+	void AsciiLower(char* text, size_t length)
+	{
+		size_t i = 0;
+		for (; i + sizeof(Word) <= length; i += sizeof(Word))
+		{
+			StoreWord(text + i, LowerWord(LoadWord(text + i)));
+		}
+		for (; i < length; ++i)
+		{
+			text[i] = AsciiToLower(text[i]);
+		}
+	}
+
+
+	void AsciiUpper(char* text, size_t length)
+	{
+		size_t i = 0;
+		for (; i + sizeof(Word) <= length; i += sizeof(Word))
+		{
+			StoreWord(text + i, UpperWord(LoadWord(text + i)));
+		}
+		for (; i < length; ++i)
+		{
+			text[i] = AsciiToUpper(text[i]);
+		}
+	}
+
+
+	void AsciiLowerCopy(const char* source, size_t length, char* dest)
+	{
+		size_t i = 0;
+		for (; i + sizeof(Word) <= length; i += sizeof(Word))
+		{
+			StoreWord(dest + i, LowerWord(LoadWord(source + i)));
+		}
+		for (; i < length; ++i)
+		{
+			dest[i] = AsciiToLower(source[i]);
+		}
+	}
+
+
+	void AsciiUpperCopy(const char* source, size_t length, char* dest)
+	{
+		size_t i = 0;
+		for (; i + sizeof(Word) <= length; i += sizeof(Word))
+		{
+			StoreWord(dest + i, UpperWord(LoadWord(source + i)));
+		}
+		for (; i < length; ++i)
+		{
+			dest[i] = AsciiToUpper(source[i]);
+		}
+	}
+
+
+	int AsciiCaseCompare(const char* text1, const char* text2, size_t length)
+	{
+		size_t i = 0;
+		for (; i + sizeof(Word) <= length; i += sizeof(Word))
+		{
+			if (LowerWord(LoadWord(text1 + i)) != LowerWord(LoadWord(text2 + i)))
+			{
+				// the difference is found below
+				break;
+			}
+		}
+		for (; i < length; ++i)
+		{
+			unsigned char c1 = (unsigned char)AsciiToLower(text1[i]);
+			unsigned char c2 = (unsigned char)AsciiToLower(text2[i]);
+			if (c1 != c2)
+			{
+				return c1 < c2 ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+
+	size_t AsciiCaseFind(const std::string& text, const std::string& str, size_t pos)
+	{
+		const size_t textLength = text.length();
+		const size_t strLength = str.length();
+		if (pos > textLength || strLength > textLength - pos)
+		{
+			return std::string::npos;
+		}
+		if (strLength == 0)
+		{
+			return pos;
+		}
+		const char* data = text.data();
+		const char* s = str.data();
+		// last position where the string can start
+		const size_t last = textLength - strLength;
+		const char first = AsciiToLower(s[0]);
+		if (!IsAsciiAlpha(first))
+		{
+			// no case to fold for the first character
+			while (pos <= last)
+			{
+				const char* found = (const char*)std::memchr(data + pos, first, last - pos + 1);
+				if (!found)
+				{
+					return std::string::npos;
+				}
+				pos = found - data;
+				if (AsciiCaseEqual(found + 1, s + 1, strLength - 1))
+				{
+					return pos;
+				}
+				++pos;
+			}
+			return std::string::npos;
+		}
+		const Word pattern = ONES * (unsigned char)first;
+		while (pos <= last)
+		{
+			if (pos + sizeof(Word) <= last + 1)
+			{
+				// skip words without the first character
+				if (!ZeroBytes(LowerWord(LoadWord(data + pos)) ^ pattern))
+				{
+					pos += sizeof(Word);
+					continue;
+				}
+				for (size_t end = pos + sizeof(Word); pos < end; ++pos)
+				{
+					if (AsciiToLower(data[pos]) == first && AsciiCaseEqual(data + pos + 1, s + 1, strLength - 1))
+					{
+						return pos;
+					}
+				}
+				continue;
+			}
+			if (AsciiToLower(data[pos]) == first && AsciiCaseEqual(data + pos + 1, s + 1, strLength - 1))
+			{
+				return pos;
+			}
+			++pos;
+		}
+		return std::string::npos;
+	}
+
+
+	size_t AsciiCaseRFind(const std::string& text, const std::string& str, size_t pos)
+	{
+		const size_t textLength = text.length();
+		const size_t strLength = str.length();
+		if (strLength > textLength)
+		{
+			return std::string::npos;
+		}
+		pos = std::min(pos, textLength - strLength);
+		if (strLength == 0)
+		{
+			return pos;
+		}
+		const char* data = text.data();
+		const char* s = str.data();
+		const char first = AsciiToLower(s[0]);
+		for (size_t i = pos + 1; i > 0; --i)
+		{
+			if (AsciiToLower(data[i - 1]) == first && AsciiCaseEqual(data + i, s + 1, strLength - 1))
+			{
+				return i - 1;
+			}
+		}
+		return std::string::npos;
+	}
+
+
 	//---------------------------------------------------------------------
 	// string functions definition
 
@@ -34,10 +267,10 @@ namespace gpvulc
 
 		for (size_t i = 0; i < len; ++i)
 		{
-			if (isalpha(str[i]))
+			if (IsAsciiAlpha(str[i]))
 			{
-				if (capital) str[i] = toupper(str[i]);
-				else str[i] = tolower(str[i]);
+				if (capital) str[i] = AsciiToUpper(str[i]);
+				else str[i] = AsciiToLower(str[i]);
 				capital = false;
 			}
 			else
@@ -59,18 +292,15 @@ namespace gpvulc
 		size_t i = 0;
 		for (; i < len; ++i)
 		{
-			if (isalpha(str[i]))
+			if (IsAsciiAlpha(str[i]))
 			{
-				str[i] = toupper(str[i]);
+				str[i] = AsciiToUpper(str[i]);
 				++i;
 				break;
 			}
 		}
 
-		for (; i < len; ++i)
-        {
-            str[i] = tolower(str[i]);
-        }
+		AsciiLower(&str[i], len - i);
 	}
 
 
@@ -224,37 +454,348 @@ namespace gpvulc
 
 
 
+	//---------------------------------------------------------------------
+	// Unicode transcoding
+
+	namespace
+	{
+		// size of the blocks read from or written to streams
+		const size_t TEXT_BLOCK_SIZE = 1 << 16;
+
+		const char UTF8_BOM[] = "\xef\xbb\xbf";
+		const char UTF16LE_BOM[] = "\xff\xfe";
+		const char UTF16BE_BOM[] = "\xfe\xff";
+
+		// bytes that must be zero in 4 UTF-16 code units for them to be ASCII characters
+		const unsigned char UTF16LE_NON_ASCII[] = { 0x80, 0xff, 0x80, 0xff, 0x80, 0xff, 0x80, 0xff };
+		const unsigned char UTF16BE_NON_ASCII[] = { 0xff, 0x80, 0xff, 0x80, 0xff, 0x80, 0xff, 0x80 };
+
+
+		// append the UTF-8 encoding of a code point, return the position after it
+		inline char* PutUtf8(char* out, unsigned cp)
+		{
+			if (cp < 0x80)
+			{
+				*out++ = (char)cp;
+			}
+			else if (cp < 0x800)
+			{
+				*out++ = (char)(0xC0 | (cp >> 6));
+				*out++ = (char)(0x80 | (cp & 0x3F));
+			}
+			else if (cp < 0x10000)
+			{
+				*out++ = (char)(0xE0 | (cp >> 12));
+				*out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+				*out++ = (char)(0x80 | (cp & 0x3F));
+			}
+			else
+			{
+				*out++ = (char)(0xF0 | (cp >> 18));
+				*out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+				*out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+				*out++ = (char)(0x80 | (cp & 0x3F));
+			}
+			return out;
+		}
+
+
+		// append a UTF-16 code unit, return the position after it
+		inline char* PutUtf16(char* out, unsigned unit, bool bigEndian)
+		{
+			out[bigEndian ? 0 : 1] = (char)(unit >> 8);
+			out[bigEndian ? 1 : 0] = (char)(unit & 0xFF);
+			return out + 2;
+		}
+
+
+		// decode a UTF-8 character at the given position, return its length or 0 if it is not valid
+		inline size_t GetUtf8(const unsigned char* in, size_t length, unsigned& cp)
+		{
+			const unsigned char c = in[0];
+			size_t count = 0;
+			unsigned minCp = 0;
+			if (c >= 0xC2 && c <= 0xDF)
+			{
+				count = 1;
+				cp = c & 0x1F;
+				minCp = 0x80;
+			}
+			else if (c >= 0xE0 && c <= 0xEF)
+			{
+				count = 2;
+				cp = c & 0x0F;
+				minCp = 0x800;
+			}
+			else if (c >= 0xF0 && c <= 0xF4)
+			{
+				count = 3;
+				cp = c & 0x07;
+				minCp = 0x10000;
+			}
+			else
+			{
+				return 0;
+			}
+			if (count >= length)
+			{
+				return 0;
+			}
+			for (size_t i = 1; i <= count; i++)
+			{
+				if ((in[i] & 0xC0) != 0x80)
+				{
+					return 0;
+				}
+				cp = (cp << 6) | (in[i] & 0x3F);
+			}
+			// overlong sequences, surrogates and values out of the Unicode range are not valid
+			if (cp < minCp || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF)
+			{
+				return 0;
+			}
+			return count + 1;
+		}
+	}
+
+
+	TextEncoding DetectTextEncoding(const char* data, size_t size, size_t& bomSize, TextEncoding defaultEncoding)
+	{
+		if (size >= 3 && std::memcmp(data, UTF8_BOM, 3) == 0)
+		{
+			bomSize = 3;
+			return TextEncoding::UTF8;
+		}
+		if (size >= 2 && std::memcmp(data, UTF16LE_BOM, 2) == 0)
+		{
+			bomSize = 2;
+			return TextEncoding::UTF16LE;
+		}
+		if (size >= 2 && std::memcmp(data, UTF16BE_BOM, 2) == 0)
+		{
+			bomSize = 2;
+			return TextEncoding::UTF16BE;
+		}
+		bomSize = 0;
+		return defaultEncoding;
+	}
+
+
+	size_t Utf16ToUtf8(const char* data, size_t size, bool bigEndian, std::string& text, bool endOfText)
+	{
+		const unsigned char* in = (const unsigned char*)data;
+		const size_t units = size / 2;
+		// each code unit takes up to 3 bytes (a surrogate pair takes 4 bytes), plus an incomplete final unit
+		const size_t length = text.size();
+		text.resize(length + units * 3 + 3);
+		char* outStart = &text[0];
+		char* out = outStart + length;
+
+		const size_t high = bigEndian ? 0 : 1;
+		const size_t low = bigEndian ? 1 : 0;
+		const Word nonAscii = LoadWord((const char*)(bigEndian ? UTF16BE_NON_ASCII : UTF16LE_NON_ASCII));
+		size_t i = 0;
+		while (i < units)
+		{
+			// ASCII characters, 4 code units at a time
+			while (i + 4 <= units && !(LoadWord(data + i * 2) & nonAscii))
+			{
+				const unsigned char* units4 = in + i * 2 + low;
+				out[0] = (char)units4[0];
+				out[1] = (char)units4[2];
+				out[2] = (char)units4[4];
+				out[3] = (char)units4[6];
+				out += 4;
+				i += 4;
+			}
+			if (i == units)
+			{
+				break;
+			}
+			unsigned unit = (in[i * 2 + high] << 8) | in[i * 2 + low];
+			if (unit >= 0xD800 && unit <= 0xDBFF)
+			{
+				if (i + 1 == units && !endOfText)
+				{
+					// the low surrogate is in the next block
+					break;
+				}
+				unsigned next = i + 1 < units ? (in[i * 2 + 2 + high] << 8) | in[i * 2 + 2 + low] : 0;
+				if (next >= 0xDC00 && next <= 0xDFFF)
+				{
+					out = PutUtf8(out, 0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+					i += 2;
+					continue;
+				}
+				unit = 0xFFFD;
+			}
+			else if (unit >= 0xDC00 && unit <= 0xDFFF)
+			{
+				unit = 0xFFFD;
+			}
+			out = PutUtf8(out, unit);
+			i++;
+		}
+		size_t converted = i * 2;
+		if (endOfText && i == units && size > converted)
+		{
+			out = PutUtf8(out, 0xFFFD);
+			converted = size;
+		}
+		text.resize(out - outStart);
+		return converted;
+	}
+
+
+	void Utf8ToUtf16(const char* text, size_t length, bool bigEndian, std::string& data)
+	{
+		const unsigned char* in = (const unsigned char*)text;
+		// each byte becomes at most a code unit (a 4 byte sequence becomes a surrogate pair)
+		const size_t size = data.size();
+		data.resize(size + length * 2);
+		char* outStart = &data[0];
+		char* out = outStart + size;
+
+		const size_t high = bigEndian ? 0 : 1;
+		const size_t low = bigEndian ? 1 : 0;
+		size_t i = 0;
+		while (i < length)
+		{
+			// ASCII characters, 8 bytes at a time
+			while (i + sizeof(Word) <= length && !(LoadWord(text + i) & HIGH_BITS))
+			{
+				for (size_t k = 0; k < sizeof(Word); k++)
+				{
+					out[k * 2 + low] = text[i + k];
+					out[k * 2 + high] = '\0';
+				}
+				out += sizeof(Word) * 2;
+				i += sizeof(Word);
+			}
+			if (i == length)
+			{
+				break;
+			}
+			if (in[i] < 0x80)
+			{
+				out = PutUtf16(out, in[i], bigEndian);
+				i++;
+				continue;
+			}
+			unsigned cp = 0;
+			size_t count = GetUtf8(in + i, length - i, cp);
+			if (count == 0)
+			{
+				out = PutUtf16(out, 0xFFFD, bigEndian);
+				i++;
+				continue;
+			}
+			if (cp >= 0x10000)
+			{
+				cp -= 0x10000;
+				out = PutUtf16(out, 0xD800 + (cp >> 10), bigEndian);
+				out = PutUtf16(out, 0xDC00 + (cp & 0x3FF), bigEndian);
+			}
+			else
+			{
+				out = PutUtf16(out, cp, bigEndian);
+			}
+			i += count;
+		}
+		data.resize(out - outStart);
+	}
+
+
+	//---------------------------------------------------------------------
+	// text files
+
 	bool LoadText(const std::string& path, std::string& text, bool append, bool asUtf16)
+	{
+		TextEncoding encoding = TextEncoding::UTF8;
+		bool hasBom = false;
+		return LoadText(path, text, encoding, hasBom, append, asUtf16);
+	}
+
+
+	bool LoadText(const std::string& path, std::string& text, TextEncoding& encoding, bool& hasBom, bool append, bool asUtf16)
 	{
 		if (path.empty())
 		{
 			return false;
 		}
 
-		std::ifstream textFileStream(path);
-		bool result = false;
-		if (asUtf16)
+		std::ifstream textFileStream(path, std::ios::in | std::ios::binary);
+		if (!textFileStream.good())
 		{
-			result = ReadText16(textFileStream, text, append);
+			return false;
 		}
-		else
+		char bom[3];
+		textFileStream.read(bom, 3);
+		const size_t size = (size_t)textFileStream.gcount();
+		size_t bomSize = 0;
+		encoding = DetectTextEncoding(bom, size, bomSize, asUtf16 ? TextEncoding::UTF16LE : TextEncoding::UTF8);
+		hasBom = bomSize > 0;
+		if (encoding != TextEncoding::UTF8)
 		{
-			result = ReadText(textFileStream, text, append);
+			// the same byte order ReadText16() detects without byte order mark
+			if (!hasBom && size >= 2 && bom[0] == '\0' && bom[1] != '\0')
+			{
+				encoding = TextEncoding::UTF16BE;
+			}
+			textFileStream.clear();
+			textFileStream.seekg(0, std::ios::beg);
+			return ReadText16(textFileStream, text, append);
 		}
 		textFileStream.close();
+
+		// UTF-8 text is read in text mode (newlines are converted as before)
+		std::ifstream utf8FileStream(path);
+		utf8FileStream.ignore((std::streamsize)bomSize);
+		bool result = ReadText(utf8FileStream, text, append);
+		utf8FileStream.close();
 		return result;
 	}
 
 
-	bool SaveText(const std::string& path, const std::string& text, bool append)
+	bool SaveText(const std::string& path, const std::string& text, bool append, bool asUtf16)
+	{
+		return SaveText(path, text, asUtf16 ? TextEncoding::UTF16LE : TextEncoding::UTF8, asUtf16, append);
+	}
+
+
+	bool SaveText(const std::string& path, const std::string& text, TextEncoding encoding, bool writeBom, bool append)
 	{
 		if (path.empty())
 		{
 			return false;
 		}
 
-		std::ofstream textFileStream(path, append ? (std::ios::out | std::ios::app) : std::ios::out);
-		bool result = WriteText(textFileStream, text);
+		const bool utf16 = encoding != TextEncoding::UTF8;
+		std::ios::openmode mode = append ? (std::ios::out | std::ios::app) : std::ios::out;
+		if (utf16)
+		{
+			mode |= std::ios::binary;
+		}
+		std::ofstream textFileStream(path, mode);
+		if (writeBom)
+		{
+			// the byte order mark is written only at the beginning of the file
+			textFileStream.seekp(0, std::ios::end);
+			writeBom = (std::streamoff)textFileStream.tellp() <= 0;
+		}
+		bool result = false;
+		if (utf16)
+		{
+			result = WriteText16(textFileStream, text, encoding == TextEncoding::UTF16BE, writeBom);
+		}
+		else
+		{
+			if (writeBom)
+			{
+				textFileStream.write("\xef\xbb\xbf", 3);
+			}
+			result = WriteText(textFileStream, text);
+		}
 		textFileStream.close();
 		return result;
 	}
@@ -297,22 +838,62 @@ namespace gpvulc
 		{
 			return false;
 		}
+		if (!append)
+		{
+			text.clear();
+		}
 
 		std::streampos streamStart = textStream.tellg();
-		textStream.seekg(0, std::ios::end);
-		size_t textSize = (size_t)(textStream.tellg() - streamStart);
-		textStream.seekg(streamStart, std::ios::beg);
-		std::string text16;
-		text16.reserve(textSize);
-
-		text16.assign((std::istreambuf_iterator<char>(textStream)),
-			std::istreambuf_iterator<char>());
+		if (streamStart != std::streampos(-1))
+		{
+			textStream.seekg(0, std::ios::end);
+			size_t textSize = (size_t)(textStream.tellg() - streamStart);
+			textStream.seekg(streamStart, std::ios::beg);
+			// enough for ASCII text, the block being converted included
+			text.reserve(text.size() + textSize / 2 + TEXT_BLOCK_SIZE * 3 / 2);
+		}
 
-		text.resize(append ? text.size() + text16.size() / 2 : text16.size() / 2);
-		size_t startIdx = append ? text.size() : 0;
-		for (size_t i = 2; i < text16.size(); i += 2)
+		std::unique_ptr<char[]> block(new char[TEXT_BLOCK_SIZE]);
+		size_t kept = 0;
+		bool firstBlock = true;
+		bool bigEndian = false;
+		bool utf8 = false;
+		for (;;)
 		{
-			text[startIdx + i / 2 -1] = text16[i];
+			textStream.read(block.get() + kept, (std::streamsize)(TEXT_BLOCK_SIZE - kept));
+			const size_t size = kept + (size_t)textStream.gcount();
+			const bool endOfText = !textStream.good();
+			size_t begin = 0;
+			if (firstBlock)
+			{
+				firstBlock = false;
+				TextEncoding encoding = DetectTextEncoding(block.get(), size, begin, TextEncoding::UTF16LE);
+				if (begin == 0 && size >= 2 && block[0] == '\0' && block[1] != '\0')
+				{
+					encoding = TextEncoding::UTF16BE;
+				}
+				bigEndian = encoding == TextEncoding::UTF16BE;
+				utf8 = encoding == TextEncoding::UTF8;
+			}
+			if (utf8)
+			{
+				text.append(block.get() + begin, size - begin);
+				kept = 0;
+			}
+			else
+			{
+				size_t converted = Utf16ToUtf8(block.get() + begin, size - begin, bigEndian, text, endOfText);
+				// an incomplete character is moved to the beginning of the next block
+				kept = size - begin - converted;
+				if (kept > 0)
+				{
+					std::memmove(block.get(), block.get() + begin + converted, kept);
+				}
+			}
+			if (endOfText)
+			{
+				break;
+			}
 		}
 
 		return true;
@@ -329,4 +910,40 @@ namespace gpvulc
 		return false;
 	}
 
+
+	bool WriteText16(std::ostream& textStream, const std::string& text, bool bigEndian, bool writeBom)
+	{
+		if (!textStream.good())
+		{
+			return false;
+		}
+		if (writeBom)
+		{
+			textStream.write(bigEndian ? UTF16BE_BOM : UTF16LE_BOM, 2);
+		}
+
+		// the text is converted in blocks, not splitting UTF-8 sequences
+		std::string data;
+		data.reserve(TEXT_BLOCK_SIZE * 2);
+		size_t begin = 0;
+		while (begin < text.size())
+		{
+			size_t end = std::min(begin + TEXT_BLOCK_SIZE, text.size());
+			size_t seqStart = end;
+			while (seqStart > begin && end < text.size() && (text[seqStart] & 0xC0) == 0x80)
+			{
+				seqStart--;
+			}
+			if (seqStart > begin)
+			{
+				end = seqStart;
+			}
+			data.clear();
+			Utf8ToUtf16(text.data() + begin, end - begin, bigEndian, data);
+			textStream.write(data.data(), (std::streamsize)data.size());
+			begin = end;
+		}
+		return textStream.good();
+	}
+
 }
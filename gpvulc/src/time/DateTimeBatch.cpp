@@ -0,0 +1,329 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Bulk date/time conversion
+
+
+#include <gpvulc/time/DateTimeBatch.h>
+#include "civil_date.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+	using namespace gpvulc;
+	using namespace gpvulc::civil_date;
+
+	// Minimum number of elements assigned to each thread
+	const size_t MIN_ITEMS_PER_THREAD = 4096;
+
+
+	// Split the range [0,count) among threads calling func(begin, end) for each part
+	template <typename Function>
+	void ParallelFor(size_t count, unsigned numThreads, Function func)
+	{
+		if (numThreads == 0)
+		{
+			numThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		size_t maxThreads = std::max<size_t>(1, count / MIN_ITEMS_PER_THREAD);
+		if (numThreads > maxThreads)
+		{
+			numThreads = (unsigned)maxThreads;
+		}
+		if (numThreads <= 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(numThreads - 1);
+		size_t chunk = (count + numThreads - 1) / numThreads;
+		for (unsigned t = 1; t < numThreads; t++)
+		{
+			size_t begin = std::min(count, t * chunk);
+			size_t end = std::min(count, begin + chunk);
+			threads.emplace_back(func, begin, end);
+		}
+		// the calling thread processes the first part
+		func(0, std::min(count, chunk));
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+
+	/*
+	Parse a canonical date/time (YYYY-MM-DDTHH:MM:SS[.mmm][Z]) in fixed positions.
+	Characters are all checked before building the result, without early exits,
+	so that the compiler can vectorize the validation.
+	Return false if the text does not match this format (it must be parsed with DateTimeParse()).
+	*/
+	inline bool ParseFixedWidth(const char* text, size_t length, TimeStamp& timeStamp)
+	{
+		const bool hasZone = length > 0 && text[length - 1] == 'Z';
+		const size_t baseLength = hasZone ? length - 1 : length;
+		if (baseLength != 19 && baseLength != 23)
+		{
+			return false;
+		}
+		const bool hasMs = baseLength == 23;
+
+		// expected separators, '0' marks digit positions
+		static const char layout[24] = "0000-00-00T00:00:00.000";
+		unsigned char digits[23];
+		unsigned invalid = 0;
+		for (size_t i = 0; i < 23; i++)
+		{
+			const char c = i < baseLength ? text[i] : layout[i];
+			digits[i] = (unsigned char)(c - '0');
+			invalid |= layout[i] == '0' ? (unsigned)(digits[i] > 9) : (unsigned)(c != layout[i]);
+		}
+		if (invalid)
+		{
+			return false;
+		}
+
+		DateTime dateTime;
+		dateTime.Year = digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+		dateTime.Month = digits[5] * 10 + digits[6];
+		dateTime.Day = digits[8] * 10 + digits[9];
+		dateTime.Hour = digits[11] * 10 + digits[12];
+		dateTime.Minute = digits[14] * 10 + digits[15];
+		dateTime.Second = digits[17] * 10 + digits[18];
+		dateTime.Millisecond = hasMs ? digits[20] * 100 + digits[21] * 10 + digits[22] : 0;
+
+		if (dateTime.Month < 1 || dateTime.Month > 12 || dateTime.Day < 1
+			|| dateTime.Day > DaysInMonth(dateTime.Year, dateTime.Month)
+			|| dateTime.Hour > 23 || dateTime.Minute > 59 || dateTime.Second > 60)
+		{
+			return false;
+		}
+		timeStamp = TimeStamp(DateTimeToEpochMs(dateTime));
+		return true;
+	}
+
+
+	inline DateTimeParseError ParseTimeStamp(const char* text, size_t length, TimeStamp& timeStamp)
+	{
+		if (ParseFixedWidth(text, length, timeStamp))
+		{
+			return DateTimeParseError::NONE;
+		}
+		DateTime dateTime;
+		DateTimeParseError parseError = DateTimeParse(text, length, dateTime);
+		if (parseError == DateTimeParseError::NONE && dateTime.Month == 0)
+		{
+			// time counters cannot be stored as time stamps
+			parseError = DateTimeParseError::OUT_OF_RANGE;
+		}
+		timeStamp = parseError == DateTimeParseError::NONE ? TimeStamp::FromDateTime(dateTime) : TimeStamp();
+		return parseError;
+	}
+
+
+	// Parse the elements in [begin,end), get the text of each element with getText(i, length)
+	template <typename TextGetter>
+	size_t ParseRange(
+		size_t begin, size_t end, TextGetter getText,
+		TimeStamp* timeStamps, DateTimeParseError* errors)
+	{
+		size_t parsed = 0;
+		for (size_t i = begin; i < end; i++)
+		{
+			size_t length = 0;
+			const char* text = getText(i, length);
+			DateTimeParseError parseError = ParseTimeStamp(text, length, timeStamps[i]);
+			if (errors)
+			{
+				errors[i] = parseError;
+			}
+			parsed += parseError == DateTimeParseError::NONE;
+		}
+		return parsed;
+	}
+
+
+	template <typename TextGetter>
+	size_t ParseAll(
+		size_t count, TextGetter getText,
+		TimeStamp* timeStamps, DateTimeParseError* errors, unsigned numThreads)
+	{
+		// updated once per thread
+		std::atomic<size_t> total(0);
+		ParallelFor(count, numThreads, [&](size_t begin, size_t end)
+		{
+			total += ParseRange(begin, end, getText, timeStamps, errors);
+		});
+		return total;
+	}
+}
+
+
+namespace gpvulc
+{
+
+	size_t ParseTimeStamps(
+		const std::string* texts,
+		size_t count,
+		TimeStamp* timeStamps,
+		DateTimeParseError* errors,
+		unsigned numThreads)
+	{
+		auto getText = [texts](size_t i, size_t& length)
+		{
+			length = texts[i].size();
+			return texts[i].data();
+		};
+		return ParseAll(count, getText, timeStamps, errors, numThreads);
+	}
+
+
+	size_t ParseTimeStamps(
+		const char* column,
+		size_t stride,
+		size_t count,
+		TimeStamp* timeStamps,
+		DateTimeParseError* errors,
+		unsigned numThreads)
+	{
+		auto getText = [column, stride](size_t i, size_t& length)
+		{
+			const char* text = column + i * stride;
+			const char* terminator = (const char*)std::memchr(text, '\0', stride);
+			length = terminator ? (size_t)(terminator - text) : stride;
+			return text;
+		};
+		return ParseAll(count, getText, timeStamps, errors, numThreads);
+	}
+
+
+	void FormatTimeStamps(
+		const TimeStamp* timeStamps,
+		size_t count,
+		std::string* texts,
+		unsigned numThreads)
+	{
+		ParallelFor(count, numThreads, [=](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				DateTimeFormat(timeStamps[i].ToDateTime(), texts[i]);
+			}
+		});
+	}
+
+
+	size_t FormatTimeStamps(
+		const TimeStamp* timeStamps,
+		size_t count,
+		char* column,
+		size_t stride,
+		unsigned numThreads)
+	{
+		if (stride == 0)
+		{
+			return 0;
+		}
+		std::atomic<size_t> failed(0);
+		ParallelFor(count, numThreads, [&](size_t begin, size_t end)
+		{
+			size_t failedInRange = 0;
+			for (size_t i = begin; i < end; i++)
+			{
+				failedInRange += DateTimeFormat(timeStamps[i].ToDateTime(), column + i * stride, stride) == 0;
+			}
+			failed += failedInRange;
+		});
+		return count - failed;
+	}
+
+
+	void DateTimesToTimeStamps(const DateTime* dateTimes, size_t count, TimeStamp* timeStamps, unsigned numThreads)
+	{
+		ParallelFor(count, numThreads, [=](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				timeStamps[i] = TimeStamp::FromDateTime(dateTimes[i]);
+			}
+		});
+	}
+
+
+	void TimeStampsToDateTimes(const TimeStamp* timeStamps, size_t count, DateTime* dateTimes, unsigned numThreads)
+	{
+		ParallelFor(count, numThreads, [=](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				dateTimes[i] = timeStamps[i].ToDateTime();
+			}
+		});
+	}
+
+
+	void TimeStampDistancesMs(
+		const TimeStamp* timeStamps1,
+		const TimeStamp* timeStamps2,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads)
+	{
+		ParallelFor(count, numThreads, [=](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				distancesMs[i] = timeStamps2[i] - timeStamps1[i];
+			}
+		});
+	}
+
+
+	void TimeStampAdjacentDistancesMs(
+		const TimeStamp* timeStamps,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads)
+	{
+		if (count < 2)
+		{
+			return;
+		}
+		TimeStampDistancesMs(timeStamps, timeStamps + 1, count - 1, distancesMs, numThreads);
+	}
+
+
+	void DateTimeAdjacentDistancesMs(
+		const DateTime* dateTimes,
+		size_t count,
+		long long* distancesMs,
+		unsigned numThreads)
+	{
+		if (count < 2)
+		{
+			return;
+		}
+		ParallelFor(count - 1, numThreads, [=](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				distancesMs[i] = DateTimeDistanceMs(dateTimes[i], dateTimes[i + 1]);
+			}
+		});
+	}
+
+} // namespace gpvulc
@@ -13,15 +13,12 @@
 
 
 #include <gpvulc/time/DateTimeUtil.h>
+#include "civil_date.h"
 
 
 #include "boost/date_time.hpp"
 
-#include <iomanip>
-#include <fstream>
-#include <streambuf>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 
 namespace
 {
@@ -29,14 +26,135 @@ namespace
 	using namespace boost::gregorian;
 
 	using namespace gpvulc;
+	using namespace gpvulc::civil_date;
+
+	// Two-digit representations of numbers from 0 to 99
+	const char DigitPairs[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
 
 	inline void DateTimeSetWeekDay(DateTime& dateTime)
 	{
 		if (dateTime.Month > 0)
 		{
-			date d(dateTime.Year, dateTime.Month, dateTime.Day);
-			dateTime.WeekDay = d.day_of_week().as_number();
+			dateTime.WeekDay = WeekDayFromDays(DaysFromCivil(dateTime.Year, dateTime.Month, dateTime.Day));
+		}
+	}
+
+
+	inline char* WriteTwoDigits(char* dest, int value)
+	{
+		std::memcpy(dest, &DigitPairs[2 * value], 2);
+		return dest + 2;
+	}
+
+
+	inline bool IsDigit(char c)
+	{
+		return (unsigned)(c - '0') <= 9u;
+	}
+
+
+	// Read exactly numDigits decimal digits, return false if not available
+	inline bool ReadDigits(const char* text, size_t length, size_t& pos, int numDigits, int& value)
+	{
+		if (pos + numDigits > length)
+		{
+			return false;
+		}
+		int result = 0;
+		for (int i = 0; i < numDigits; i++)
+		{
+			const char c = text[pos + i];
+			if (!IsDigit(c))
+			{
+				return false;
+			}
+			result = result * 10 + (c - '0');
+		}
+		value = result;
+		pos += numDigits;
+		return true;
+	}
+
+
+	inline bool ReadChar(const char* text, size_t length, size_t& pos, char c)
+	{
+		if (pos < length && text[pos] == c)
+		{
+			++pos;
+			return true;
 		}
+		return false;
+	}
+
+
+	// Parse a UTC offset ("Z", "+hh:mm", "+hhmm", "+hh", optionally prefixed by "UTC")
+	DateTimeParseError ParseUtcOffset(const char* text, size_t length, size_t& pos, int& offsetHour, int& offsetMinute)
+	{
+		if (length - pos >= 3 && std::memcmp(&text[pos], "UTC", 3) == 0)
+		{
+			pos += 3;
+			if (pos == length)
+			{
+				return DateTimeParseError::NONE;
+			}
+		}
+		if (ReadChar(text, length, pos, 'Z'))
+		{
+			return DateTimeParseError::NONE;
+		}
+		int sign = 1;
+		if (ReadChar(text, length, pos, '-'))
+		{
+			sign = -1;
+		}
+		else if (!ReadChar(text, length, pos, '+'))
+		{
+			return DateTimeParseError::BAD_OFFSET;
+		}
+		int hour = 0;
+		int minute = 0;
+		if (!ReadDigits(text, length, pos, 2, hour))
+		{
+			// single digit hour, as written by older versions
+			if (!ReadDigits(text, length, pos, 1, hour))
+			{
+				return DateTimeParseError::BAD_OFFSET;
+			}
+		}
+		if (ReadChar(text, length, pos, ':'))
+		{
+			// signed minutes, as written by older versions
+			if (!ReadChar(text, length, pos, '+'))
+			{
+				ReadChar(text, length, pos, '-');
+			}
+			if (!ReadDigits(text, length, pos, 2, minute) && !ReadDigits(text, length, pos, 1, minute))
+			{
+				return DateTimeParseError::BAD_OFFSET;
+			}
+		}
+		else
+		{
+			ReadDigits(text, length, pos, 2, minute);
+		}
+		if (hour > 14 || minute > 59)
+		{
+			return DateTimeParseError::OUT_OF_RANGE;
+		}
+		offsetHour = sign * hour;
+		offsetMinute = sign * minute;
+		return DateTimeParseError::NONE;
 	}
 
 	ptime DateTimeToTime(const DateTime& dateTime)
@@ -55,23 +173,41 @@ namespace
 	}
 
 
-	long DateTimeToMs(const DateTime& dateTime)
+	long long DateTimeToMs(const DateTime& dateTime)
 	{
 		// DateTime considered as a time counter
-		const long msInSec = 1000L;
-		const long msInMin = 60L*msInSec;
-		const long msInHour = 60L*msInMin;
-		const long msInDay = 24L * msInHour;
-
-		long sSum = dateTime.Second * msInSec;
-		long mSum = dateTime.Minute * msInMin;
-		long hSum = dateTime.Hour * msInHour;
-		long dSum = dateTime.Day * msInDay;
-		long ms = dSum + hSum + mSum + sSum + dateTime.Millisecond;
+		const long long msInSec = 1000LL;
+		const long long msInMin = 60LL*msInSec;
+		const long long msInHour = 60LL*msInMin;
+		const long long msInDay = 24LL * msInHour;
+
+		long long sSum = dateTime.Second * msInSec;
+		long long mSum = dateTime.Minute * msInMin;
+		long long hSum = dateTime.Hour * msInHour;
+		long long dSum = dateTime.Day * msInDay;
+		long long ms = dSum + hSum + mSum + sSum + dateTime.Millisecond;
 		return ms;
 	}
 
 
+	// Get comparable values for two date/time (time counters are compared as durations)
+	inline void DateTimeCompareValues(
+		const DateTime& dateTime1, const DateTime& dateTime2,
+		long long& value1, long long& value2)
+	{
+		if (dateTime1.Month == 0 || dateTime2.Month == 0)
+		{
+			value1 = DateTimeToMs(dateTime1);
+			value2 = DateTimeToMs(dateTime2);
+		}
+		else
+		{
+			value1 = DateTimeToEpochMs(dateTime1);
+			value2 = DateTimeToEpochMs(dateTime2);
+		}
+	}
+
+
 	time_duration DateTimeDist(const DateTime& dateTime1, const DateTime& dateTime2)
 	{
 		ptime time1 = DateTimeToTime(dateTime1);
@@ -106,87 +242,257 @@ namespace
 
 namespace gpvulc
 {
-	DateTime StringToDateTime(const std::string& timeString)
+	const char* DateTimeParseErrorToString(DateTimeParseError parseError)
 	{
-		DateTime dateTime;
-		std::istringstream sStream(timeString);
-		char c;
-		// YYYY-MM-DDTHH:MM:SS.ms
-		sStream
-			>> dateTime.Year >> c >> dateTime.Month >> c >> dateTime.Day
-			>> c // T
-			>> dateTime.Hour >> c >> dateTime.Minute >> c >> dateTime.Second;
-		if (!sStream.eof())
+		switch (parseError)
+		{
+		case DateTimeParseError::NONE:
+			return "No error";
+		case DateTimeParseError::EMPTY:
+			return "Empty date/time";
+		case DateTimeParseError::BAD_DATE:
+			return "Malformed date";
+		case DateTimeParseError::BAD_TIME:
+			return "Malformed time";
+		case DateTimeParseError::BAD_FRACTION:
+			return "Malformed fraction of second";
+		case DateTimeParseError::BAD_OFFSET:
+			return "Malformed UTC offset";
+		case DateTimeParseError::OUT_OF_RANGE:
+			return "Value out of range";
+		case DateTimeParseError::TRAILING_CHARS:
+			return "Unexpected characters";
+		}
+		return "";
+	}
+
+
+	size_t DateTimeFormat(const DateTime& dateTime, char* buffer, size_t bufferSize)
+	{
+		if (bufferSize == 0)
+		{
+			return 0;
+		}
+		buffer[0] = '\0';
+		const bool hasMs = dateTime.Millisecond > 0;
+		const bool hasOffset = dateTime.TimeOffsetHour != 0 || dateTime.TimeOffsetMinute != 0;
+		const int offsetHour = dateTime.TimeOffsetHour < 0 ? -dateTime.TimeOffsetHour : dateTime.TimeOffsetHour;
+		const int offsetMinute = dateTime.TimeOffsetMinute < 0 ? -dateTime.TimeOffsetMinute : dateTime.TimeOffsetMinute;
+
+		// YYYY-MM-DDTHH:MM:SS[.mmm][UTC+hh:mm]
+		const size_t length = 19 + (hasMs ? 4 : 0) + (hasOffset ? 9 : 0);
+		if (length >= bufferSize)
+		{
+			return 0;
+		}
+		if ((unsigned)dateTime.Year > 9999u
+			|| (unsigned)dateTime.Month > 99u || (unsigned)dateTime.Day > 99u
+			|| (unsigned)dateTime.Hour > 99u || (unsigned)dateTime.Minute > 99u
+			|| (unsigned)dateTime.Second > 99u || (unsigned)dateTime.Millisecond > 999u
+			|| offsetHour > 99 || offsetMinute > 99)
+		{
+			return 0;
+		}
+
+		char* p = buffer;
+		p = WriteTwoDigits(p, dateTime.Year / 100);
+		p = WriteTwoDigits(p, dateTime.Year % 100);
+		*p++ = '-';
+		p = WriteTwoDigits(p, dateTime.Month);
+		*p++ = '-';
+		p = WriteTwoDigits(p, dateTime.Day);
+		*p++ = 'T';
+		p = WriteTwoDigits(p, dateTime.Hour);
+		*p++ = ':';
+		p = WriteTwoDigits(p, dateTime.Minute);
+		*p++ = ':';
+		p = WriteTwoDigits(p, dateTime.Second);
+		if (hasMs)
+		{
+			*p++ = '.';
+			*p++ = (char)('0' + dateTime.Millisecond / 100);
+			p = WriteTwoDigits(p, dateTime.Millisecond % 100);
+		}
+		if (hasOffset)
 		{
-			sStream >> c;
-			if (c == '.')
+			std::memcpy(p, "UTC", 3);
+			p += 3;
+			*p++ = (dateTime.TimeOffsetHour < 0 || dateTime.TimeOffsetMinute < 0) ? '-' : '+';
+			p = WriteTwoDigits(p, offsetHour);
+			*p++ = ':';
+			p = WriteTwoDigits(p, offsetMinute);
+		}
+		*p = '\0';
+		return length;
+	}
+
+
+	void DateTimeFormat(const DateTime& dateTime, std::string& str)
+	{
+		char buffer[DATETIME_STRING_MAX];
+		size_t length = DateTimeFormat(dateTime, buffer, sizeof(buffer));
+		str.assign(buffer, length);
+	}
+
+
+	DateTimeParseError DateTimeParse(const char* text, size_t length, DateTime& dateTime, size_t* errorPos)
+	{
+		size_t pos = 0;
+		DateTimeParseError parseError = DateTimeParseError::NONE;
+		DateTime result;
+
+		if (text == nullptr || length == 0)
+		{
+			parseError = DateTimeParseError::EMPTY;
+		}
+		// YYYY-MM-DD
+		else if (!ReadDigits(text, length, pos, 4, result.Year)
+			|| !ReadChar(text, length, pos, '-')
+			|| !ReadDigits(text, length, pos, 2, result.Month)
+			|| !ReadChar(text, length, pos, '-')
+			|| !ReadDigits(text, length, pos, 2, result.Day))
+		{
+			parseError = DateTimeParseError::BAD_DATE;
+		}
+		// [(T| )HH:MM[:SS[.fff]]]
+		else if (ReadChar(text, length, pos, 'T') || ReadChar(text, length, pos, ' '))
+		{
+			if (!ReadDigits(text, length, pos, 2, result.Hour)
+				|| !ReadChar(text, length, pos, ':')
+				|| !ReadDigits(text, length, pos, 2, result.Minute))
 			{
-				sStream >> dateTime.Millisecond;
-				sStream >> c;
+				parseError = DateTimeParseError::BAD_TIME;
 			}
-			if (c == 'U')
+			else if (ReadChar(text, length, pos, ':'))
 			{
-				sStream >> c >> c; // UTC
-				sStream >> dateTime.TimeOffsetHour
-					>> c >> dateTime.TimeOffsetMinute;
+				if (!ReadDigits(text, length, pos, 2, result.Second))
+				{
+					parseError = DateTimeParseError::BAD_TIME;
+				}
+				else if (ReadChar(text, length, pos, '.') || ReadChar(text, length, pos, ','))
+				{
+					// only milliseconds are stored, further digits are ignored
+					int scale = 100;
+					size_t fracStart = pos;
+					while (pos < length && IsDigit(text[pos]))
+					{
+						result.Millisecond += (text[pos] - '0') * scale;
+						scale /= 10;
+						++pos;
+					}
+					if (pos == fracStart)
+					{
+						parseError = DateTimeParseError::BAD_FRACTION;
+					}
+				}
 			}
 		}
-		DateTimeSetWeekDay(dateTime);
-		return dateTime;
-	}
 
+		// [offset]
+		if (parseError == DateTimeParseError::NONE && pos < length)
+		{
+			char c = text[pos];
+			if (c == 'Z' || c == 'U' || c == '+' || c == '-')
+			{
+				parseError = ParseUtcOffset(text, length, pos, result.TimeOffsetHour, result.TimeOffsetMinute);
+			}
+			if (parseError == DateTimeParseError::NONE && pos < length)
+			{
+				parseError = DateTimeParseError::TRAILING_CHARS;
+			}
+		}
 
-	const std::string& DateTimeToString(const DateTime& dateTime)
-	{
-		std::ostringstream oStream;
-		oStream << std::setfill('0')
-			<< std::setw(4) << dateTime.Year
-			<< '-'
-			<< std::setw(2) << dateTime.Month
-			<< '-'
-			<< std::setw(2) << dateTime.Day
-			<< 'T'
-			<< std::setw(2) << dateTime.Hour
-			<< ':'
-			<< std::setw(2) << dateTime.Minute
-			<< ':'
-			<< std::setw(2) << dateTime.Second;
-		if (dateTime.Millisecond > 0)
+		if (parseError == DateTimeParseError::NONE)
 		{
-			oStream << '.' << std::setfill('0')
-				<< std::setw(3) << dateTime.Millisecond;
+			bool isCounter = result.Month == 0;
+			if (result.Hour > 23 || result.Minute > 59 || result.Second > 60
+				|| (!isCounter && (result.Month > 12 || result.Day < 1
+					|| result.Day > DaysInMonth(result.Year, result.Month))))
+			{
+				pos = 0;
+				parseError = DateTimeParseError::OUT_OF_RANGE;
+			}
 		}
-		if (dateTime.TimeOffsetHour != 0 || dateTime.TimeOffsetMinute != 0)
+
+		if (parseError != DateTimeParseError::NONE)
 		{
-			oStream << "UTC";
-			oStream << std::showpos << std::setfill('0')
-				<< std::setw(2) << dateTime.TimeOffsetHour
-				<< ':'
-				<< std::setw(2) << dateTime.TimeOffsetMinute;
+			if (errorPos)
+			{
+				*errorPos = pos;
+			}
+			return parseError;
 		}
-		static std::string str;
-		str = oStream.str();
+
+		DateTimeSetWeekDay(result);
+		dateTime = result;
+		return DateTimeParseError::NONE;
+	}
+
+
+	DateTime StringToDateTime(const std::string& timeString)
+	{
+		DateTime dateTime;
+		DateTimeParse(timeString.data(), timeString.size(), dateTime);
+		return dateTime;
+	}
+
+
+	const std::string& DateTimeToString(const DateTime& dateTime)
+	{
+		thread_local std::string str;
+		DateTimeFormat(dateTime, str);
 		return str;
 	}
 
+
 	const char* DateTimeToCString(const DateTime& dateTime)
 	{
-		static std::string str;
+		thread_local char str[DATETIME_STRING_MAX];
+		DateTimeFormat(dateTime, str, sizeof(str));
+		return str;
+	}
+
 
-		str = DateTimeToString(dateTime);
-		return str.c_str();
+	long long DateTimeToEpochMs(const DateTime& dateTime)
+	{
+		const long long msInDay = 86400000LL;
+		long long days = DaysFromCivil(dateTime.Year, dateTime.Month, dateTime.Day);
+		long long minutes = dateTime.Hour * 60LL + dateTime.Minute
+			- dateTime.TimeOffsetHour * 60LL - dateTime.TimeOffsetMinute;
+		return days * msInDay + minutes * 60000LL + dateTime.Second * 1000LL + dateTime.Millisecond;
 	}
 
-	long long DateTimeDistanceSec(const DateTime& dateTime1, const DateTime& dateTime2)
+
+	DateTime EpochMsToDateTime(long long epochMs, int offsetMinutes, bool isDST)
 	{
-		if (dateTime1.Month == 0 || dateTime2.Month == 0)
+		const long long msInDay = 86400000LL;
+		long long localMs = epochMs + offsetMinutes * 60000LL;
+		long long days = localMs / msInDay;
+		long long msOfDay = localMs - days * msInDay;
+		if (msOfDay < 0)
 		{
-			long long sec = (DateTimeToMs(dateTime2) - DateTimeToMs(dateTime1)) / 1000L;
-			return sec;
+			msOfDay += msInDay;
+			--days;
 		}
 
+		DateTime dateTime;
+		CivilFromDays(days, dateTime.Year, dateTime.Month, dateTime.Day);
+		dateTime.WeekDay = WeekDayFromDays(days);
+		int ms = (int)msOfDay;
+		dateTime.Hour = ms / 3600000;
+		dateTime.Minute = ms / 60000 % 60;
+		dateTime.Second = ms / 1000 % 60;
+		dateTime.Millisecond = ms % 1000;
+		dateTime.TimeOffsetHour = offsetMinutes / 60;
+		dateTime.TimeOffsetMinute = offsetMinutes % 60;
+		dateTime.IsDST = isDST;
+		return dateTime;
+	}
+
 
-		return DateTimeDist(dateTime1, dateTime2).seconds();
+	long long DateTimeDistanceSec(const DateTime& dateTime1, const DateTime& dateTime2)
+	{
+		return DateTimeDistanceMs(dateTime1, dateTime2) / 1000LL;
 	}
 
 
@@ -199,14 +505,10 @@ namespace gpvulc
 
 	long long DateTimeDistanceMs(const DateTime& dateTime1, const DateTime& dateTime2)
 	{
-		if (dateTime1.Month == 0 || dateTime2.Month == 0)
-		{
-			long long ms = DateTimeToMs(dateTime2) - DateTimeToMs(dateTime1);
-			return ms;
-		}
-		long long tdSec = DateTimeDistanceSec(dateTime1, dateTime2);
-		long long ms = tdSec * 1000 + dateTime2.Millisecond - dateTime1.Millisecond;
-		return ms;
+		long long ms1;
+		long long ms2;
+		DateTimeCompareValues(dateTime1, dateTime2, ms1, ms2);
+		return ms2 - ms1;
 	}
 
 
@@ -281,90 +583,42 @@ using namespace gpvulc;
 
 bool operator<(const DateTime& dateTime1, const DateTime& dateTime2)
 {
-	if (dateTime1.Month == 0 || dateTime2.Month == 0)
-	{
-		return DateTimeToMs(dateTime1) < DateTimeToMs(dateTime2);
-	}
-	ptime t1 = DateTimeToTime(dateTime1);
-	ptime t2 = DateTimeToTime(dateTime2);
+	long long t1, t2;
+	DateTimeCompareValues(dateTime1, dateTime2, t1, t2);
 	return t1 < t2;
 }
 
 
-//bool operator<(DateTime& dateTime1, DateTime& dateTime2)
-//{
-//	return const_cast<const DateTime&>(dateTime1) < const_cast<const DateTime&>(dateTime2);
-//}
-
-
 bool operator==(const DateTime& dateTime1, const DateTime& dateTime2)
 {
-	if (dateTime1.Month == 0 || dateTime2.Month == 0)
-	{
-		return DateTimeToMs(dateTime1) == DateTimeToMs(dateTime2);
-	}
-	ptime t1 = DateTimeToTime(dateTime1);
-	ptime t2 = DateTimeToTime(dateTime2);
+	long long t1, t2;
+	DateTimeCompareValues(dateTime1, dateTime2, t1, t2);
 	return t1 == t2;
 }
 
 
-//bool operator==(DateTime& dateTime1, DateTime& dateTime2)
-//{
-//	return const_cast<const DateTime&>(dateTime1) == const_cast<const DateTime&>(dateTime2);
-//}
-
-
 bool operator>(const DateTime& dateTime1, const DateTime& dateTime2)
 {
-	if (dateTime1.Month == 0 || dateTime2.Month == 0)
-	{
-		return DateTimeToMs(dateTime1) > DateTimeToMs(dateTime2);
-	}
-	ptime t1 = DateTimeToTime(dateTime1);
-	ptime t2 = DateTimeToTime(dateTime2);
-	bool isLess = t1 < t2;
-	bool isEqual = t1 == t2;
-	return !(isLess || isEqual);
+	long long t1, t2;
+	DateTimeCompareValues(dateTime1, dateTime2, t1, t2);
+	return t1 > t2;
 }
-//bool operator>(DateTime& dateTime1, DateTime& dateTime2)
-//{
-//	return const_cast<const DateTime&>(dateTime1) > const_cast<const DateTime&>(dateTime2);
-//}
 
 
 bool operator<=(const DateTime& dateTime1, const DateTime& dateTime2)
 {
-	if (dateTime1.Month == 0 || dateTime2.Month == 0)
-	{
-		return DateTimeToMs(dateTime1) <= DateTimeToMs(dateTime2);
-	}
-	ptime t1 = DateTimeToTime(dateTime1);
-	ptime t2 = DateTimeToTime(dateTime2);
-	bool isLess = t1 < t2;
-	bool isEqual = t1 == t2;
-	return isLess || isEqual;
+	long long t1, t2;
+	DateTimeCompareValues(dateTime1, dateTime2, t1, t2);
+	return t1 <= t2;
 }
-//bool operator<=(DateTime& dateTime1, DateTime& dateTime2)
-//{
-//	return const_cast<const DateTime&>(dateTime1) <= const_cast<const DateTime&>(dateTime2);
-//}
 
 
 bool operator>=(const DateTime& dateTime1, const DateTime& dateTime2)
 {
-	if (dateTime1.Month == 0 || dateTime2.Month == 0)
-	{
-		return DateTimeToMs(dateTime1) >= DateTimeToMs(dateTime2);
-	}
-	ptime t1 = DateTimeToTime(dateTime1);
-	ptime t2 = DateTimeToTime(dateTime2);
-	return !(t1 < t2);
+	long long t1, t2;
+	DateTimeCompareValues(dateTime1, dateTime2, t1, t2);
+	return t1 >= t2;
 }
-//bool operator>=(DateTime& dateTime1, DateTime& dateTime2)
-//{
-//	return const_cast<const DateTime&>(dateTime1) >= const_cast<const DateTime&>(dateTime2);
-//}
 
 
 /*
@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// TimeStamp class implementation
+
+
+#include <gpvulc/time/TimeStamp.h>
+#include <gpvulc/time/DateTimeUtil.h>
+
+
+namespace gpvulc
+{
+
+	//---------------------------------------------------------------------
+	// TimeStamp class implementation
+
+	TimeStamp TimeStamp::FromDateTime(const DateTime& dateTime)
+	{
+		int offsetMinutes = dateTime.TimeOffsetHour * 60 + dateTime.TimeOffsetMinute;
+		return TimeStamp(DateTimeToEpochMs(dateTime), offsetMinutes, dateTime.IsDST);
+	}
+
+
+	DateTime TimeStamp::ToDateTime() const
+	{
+		return EpochMsToDateTime(GetEpochMs(), GetOffsetMinutes(), IsDST());
+	}
+
+} // namespace gpvulc
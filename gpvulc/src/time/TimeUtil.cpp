@@ -12,7 +12,9 @@
 
 
 #include <gpvulc/time/TimeUtil.h>
+#include <gpvulc/time/DateTimeUtil.h>
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <thread>
@@ -20,20 +22,109 @@
 #include <iomanip>
 
 
-namespace gpvulc
+namespace
 {
+	using namespace gpvulc;
 
-	long long GetRunTimeMicroseconds()
+	// Period checked for time zone transitions when the UTC offset is cached (seconds)
+	const long long UTC_OFFSET_CHECK_PERIOD = 86400;
+
+	// UTC offset and daylight savings time flag, constant in the period [ValidFromSec, ValidUntilSec)
+	struct UtcOffsetCache
 	{
-		static std::chrono::time_point<std::chrono::system_clock> beginning;
+		long long ValidFromSec = 0;
+		long long ValidUntilSec = 0;
+		int OffsetMinutes = 0;
+		bool IsDST = false;
+		unsigned Generation = 0;
+	};
+
+	// Incremented to invalidate the cache of every thread
+	std::atomic<unsigned> utcOffsetGeneration(0);
+
+	thread_local UtcOffsetCache utcOffsetCache;
+
+
+	// Query the system for the UTC offset at the given time, return false on failure
+	bool QueryUtcOffset(long long epochSec, int& offsetMinutes, bool& isDST)
+	{
+		std::time_t t = (std::time_t)epochSec;
+		struct tm timeinfo;
+#ifdef _MSC_VER
+		if (localtime_s(&timeinfo, &t) != 0)
+		{
+			return false;
+		}
+#else
+		if (localtime_r(&t, &timeinfo) == nullptr)
+		{
+			return false;
+		}
+#endif
+		DateTime localTime(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+			timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+		long long localSec = DateTimeToEpochMs(localTime) / 1000;
+		offsetMinutes = (int)((localSec - epochSec) / 60);
+		isDST = timeinfo.tm_isdst > 0;
+		return true;
+	}
+
 
-		static bool done = false;
-		if (!done)
+	/*
+	Find the UTC offset at the given time and the period in which it does not change:
+	if it changes within UTC_OFFSET_CHECK_PERIOD the transition is located with a binary search
+	(only a few system calls once a day or around transitions).
+	*/
+	void RefreshUtcOffsetCache(UtcOffsetCache& cache, long long epochSec, unsigned generation)
+	{
+		cache.Generation = generation;
+		cache.ValidFromSec = epochSec;
+		cache.ValidUntilSec = epochSec + 1;
+		cache.OffsetMinutes = 0;
+		cache.IsDST = false;
+		if (!QueryUtcOffset(epochSec, cache.OffsetMinutes, cache.IsDST))
 		{
-			beginning = std::chrono::system_clock::now();
-			done = true;
+			return;
 		}
-		auto diff = std::chrono::system_clock::now() - beginning;
+
+		long long low = epochSec;
+		long long high = epochSec + UTC_OFFSET_CHECK_PERIOD;
+		int offsetMinutes = 0;
+		bool isDST = false;
+		if (QueryUtcOffset(high, offsetMinutes, isDST)
+			&& offsetMinutes == cache.OffsetMinutes && isDST == cache.IsDST)
+		{
+			cache.ValidUntilSec = high;
+			return;
+		}
+		// the state at low is the cached one, the state at high is different
+		while (high - low > 1)
+		{
+			long long middle = low + (high - low) / 2;
+			if (QueryUtcOffset(middle, offsetMinutes, isDST)
+				&& offsetMinutes == cache.OffsetMinutes && isDST == cache.IsDST)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		cache.ValidUntilSec = high;
+	}
+}
+
+
+namespace gpvulc
+{
+
+	long long GetRunTimeMicroseconds()
+	{
+		// initialized once (also by concurrent first calls), a monotonic clock is not affected by clock adjustments
+		static const std::chrono::steady_clock::time_point beginning = std::chrono::steady_clock::now();
+
+		auto diff = std::chrono::steady_clock::now() - beginning;
 		long long micros = std::chrono::duration_cast<std::chrono::microseconds>(diff).count();
 		return micros;
 	}
@@ -55,35 +146,79 @@ namespace gpvulc
 	}
 
 
-	DateTime GetDateTimeNow()
+	long long GetEpochMilliseconds()
 	{
-		DateTime dt;
-		auto nowTp = std::chrono::system_clock::now();
-		std::time_t t = std::chrono::system_clock::to_time_t(nowTp);
-#ifdef _MSC_VER
-		// disable the unsafe warning
-#pragma warning( push )
-#pragma warning( disable : 4996 )
-#endif
-		struct tm * timeinfo = std::localtime(&t);
-#ifdef _MSC_VER
-#pragma warning( pop )
+		auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+		return std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count();
+	}
+
+
+	long long GetEpochMillisecondsCoarse()
+	{
+#ifdef CLOCK_REALTIME_COARSE
+		struct timespec ts;
+		if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0)
+		{
+			return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+		}
 #endif
-		dt.Year = timeinfo->tm_year + 1900;
-		dt.Month = timeinfo->tm_mon + 1;
-		dt.Day = timeinfo->tm_mday + 1;
-		dt.WeekDay = timeinfo->tm_wday + 1;
-		dt.Hour = timeinfo->tm_hour;
-		dt.Minute = timeinfo->tm_min;
-		dt.Second = timeinfo->tm_sec;
-
-		std::time_t tt = std::mktime(timeinfo);
-		auto tp = std::chrono::system_clock::from_time_t(tt);
-		auto diff = nowTp - tp;
-		auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
-		dt.Millisecond = (int)millis;
-
-		return dt;
+		return GetEpochMilliseconds();
+	}
+
+
+	int GetUtcOffsetMinutes(long long epochMs, bool* isDST)
+	{
+		UtcOffsetCache& cache = utcOffsetCache;
+		long long epochSec = epochMs >= 0 ? epochMs / 1000 : -((999 - epochMs) / 1000);
+		unsigned generation = utcOffsetGeneration.load(std::memory_order_relaxed);
+		if (epochSec < cache.ValidFromSec || epochSec >= cache.ValidUntilSec || cache.Generation != generation)
+		{
+			RefreshUtcOffsetCache(cache, epochSec, generation);
+		}
+		if (isDST)
+		{
+			*isDST = cache.IsDST;
+		}
+		return cache.OffsetMinutes;
+	}
+
+
+	void ResetUtcOffsetCache()
+	{
+		utcOffsetGeneration++;
+	}
+
+
+	DateTime GetDateTimeNow()
+	{
+		DateTime dateTime = GetDateTimeNowWithOffset(false);
+		dateTime.TimeOffsetHour = 0;
+		dateTime.TimeOffsetMinute = 0;
+		return dateTime;
+	}
+
+
+	DateTime GetDateTimeNowCoarse()
+	{
+		DateTime dateTime = GetDateTimeNowWithOffset(true);
+		dateTime.TimeOffsetHour = 0;
+		dateTime.TimeOffsetMinute = 0;
+		return dateTime;
+	}
+
+
+	DateTime GetDateTimeNowWithOffset(bool coarse)
+	{
+		return GetTimeStampNow(coarse).ToDateTime();
+	}
+
+
+	TimeStamp GetTimeStampNow(bool coarse)
+	{
+		long long epochMs = coarse ? GetEpochMillisecondsCoarse() : GetEpochMilliseconds();
+		bool isDST = false;
+		int offsetMinutes = GetUtcOffsetMinutes(epochMs, &isDST);
+		return TimeStamp(epochMs, offsetMinutes, isDST);
 	}
 
 
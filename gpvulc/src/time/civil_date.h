@@ -0,0 +1,70 @@
+//--------------------------------------------------------------------//
+// gpvulc                                                             //
+// GPV's Utility Library Collection                                   //
+//  by Giovanni Paolo Vigano', 2015-2021                              //
+//--------------------------------------------------------------------//
+//
+// Distributed under the MIT Software License.
+// See http://opensource.org/licenses/MIT
+//
+
+// Civil (proleptic Gregorian) calendar computations shared by the time sources (not installed)
+
+#pragma once
+
+#include <gpvulc/time/DateTime.h>
+
+namespace gpvulc
+{
+	namespace civil_date
+	{
+
+		inline bool IsLeapYear(int year)
+		{
+			return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+		}
+
+
+		inline int DaysInMonth(int year, int month)
+		{
+			static const int daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+			return (month == 2 && IsLeapYear(year)) ? 29 : daysInMonth[month - 1];
+		}
+
+
+		// Days since 1970-01-01 of the given (proleptic Gregorian) date,
+		// see http://howardhinnant.github.io/date_algorithms.html
+		inline long long DaysFromCivil(int year, int month, int day)
+		{
+			year -= month <= 2;
+			const long long era = (year >= 0 ? year : year - 399) / 400;
+			const unsigned yearOfEra = (unsigned)(year - era * 400);
+			const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+			const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+			return era * 146097 + (long long)dayOfEra - 719468;
+		}
+
+
+		// Date of the given number of days since 1970-01-01 (inverse of DaysFromCivil())
+		inline void CivilFromDays(long long days, int& year, int& month, int& day)
+		{
+			days += 719468;
+			const long long era = (days >= 0 ? days : days - 146096) / 146097;
+			const unsigned dayOfEra = (unsigned)(days - era * 146097);
+			const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+			const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+			const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+			day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+			month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+			year = (int)(yearOfEra + era * 400) + (month <= 2);
+		}
+
+
+		// Week day (see WDay) of the given number of days since 1970-01-01 (a Thursday)
+		inline int WeekDayFromDays(long long days)
+		{
+			return (int)(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6) + SUNDAY;
+		}
+
+	}
+}//namespace gpvulc